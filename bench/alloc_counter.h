@@ -0,0 +1,35 @@
+/**
+ * @file alloc_counter.h
+ * @brief Heap Allocation Counting for Benchmarks
+ *
+ * This file declares a process-wide counter of heap allocations. The benchmark
+ * binary replaces the global operator new, so every allocation made by the code
+ * under test is counted and can be reported next to the timings.
+ *
+ * Key components:
+ * - allocationCount, the number of allocations since program start
+ * - AllocationScope, which measures the allocations made during its lifetime
+ */
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * allocationCount Function
+ * @return The number of heap allocations made by the process so far
+ */
+std::size_t allocationCount();
+
+/**
+ * AllocationScope struct
+ * Records the allocation count on construction and reports the difference.
+ */
+struct AllocationScope {
+    std::size_t start = allocationCount();
+
+    std::size_t allocations() const { return allocationCount() - start; }
+};
+
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,11 @@
+/**
+ * @file bench_main.cpp
+ * @brief Benchmark Entry Point
+ *
+ * Entry point of the diet_manager_bench binary. Individual benchmarks are
+ * registered by the other files in this directory.
+ */
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,22 @@
+/**
+ * @file bench_workspace.cpp
+ * @brief Scratch Directory for Benchmarks Implementation
+ */
+
+#include "bench_workspace.h"
+#include <filesystem>
+#include <mutex>
+#include <unistd.h>
+
+std::string enterBenchWorkspace() {
+    static std::once_flag once;
+    static std::string workspace;
+    std::call_once(once, [] {
+        auto path = std::filesystem::temp_directory_path() /
+                    ("diet_manager_bench." + std::to_string(::getpid()));
+        std::filesystem::create_directories(path / "data");
+        std::filesystem::current_path(path);
+        workspace = path.string();
+    });
+    return workspace;
+}
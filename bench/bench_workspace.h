@@ -0,0 +1,24 @@
+/**
+ * @file bench_workspace.h
+ * @brief Scratch Directory for Benchmarks Using the Singletons
+ *
+ * FoodDatabase and UserProfile save their data files to "data/" relative to the
+ * working directory when the process exits. Benchmarks that touch the singletons
+ * first switch to a private scratch directory so the repository's data files are
+ * never overwritten.
+ */
+
+#ifndef BENCH_WORKSPACE_H
+#define BENCH_WORKSPACE_H
+
+#include <string>
+
+/**
+ * enterBenchWorkspace Function
+ * @return The scratch directory, which is the working directory from now on
+ * Creates the directory (with a "data" subdirectory) on first use; later calls
+ * only return it.
+ */
+std::string enterBenchWorkspace();
+
+#endif // BENCH_WORKSPACE_H
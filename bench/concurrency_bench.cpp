@@ -0,0 +1,86 @@
+/**
+ * @file concurrency_bench.cpp
+ * @brief Multi-Threaded Stress Benchmarks for FoodDatabase
+ *
+ * This file measures read throughput of the FoodDatabase singleton with 1 to 8
+ * threads, with and without a concurrent writer. Timings use wall-clock time, so
+ * items_per_second is the aggregate throughput of all threads; on a machine with
+ * enough cores it should grow with the thread count while readers only share
+ * the database lock.
+ *
+ * Key benchmarks:
+ * - Concurrent getFood lookups
+ * - Concurrent keyword searches
+ * - Lookups while one thread keeps adding foods
+ */
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "synthetic_data.h"
+#include "manager/food_database.h"
+
+namespace {
+
+const CatalogSpec STRESS_CATALOG = {50000, 2, 1000, 4, 42};
+
+/**
+ * setUpCatalog Function
+ * @return The IDs of the basic foods of the stress catalog
+ * The first thread to arrive loads the catalog if needed; the others wait for it.
+ */
+const std::vector<std::string>& setUpCatalog() {
+    static std::mutex setupMutex;
+    std::lock_guard<std::mutex> lock(setupMutex);
+    return useCatalog(STRESS_CATALOG).basicIds;
+}
+
+void BM_ConcurrentGetFood(benchmark::State& state) {
+    const std::vector<std::string>& catalogIds = setUpCatalog();
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getFood(catalogIds[rng() % catalogIds.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentGetFood)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_ConcurrentSearch(benchmark::State& state) {
+    setUpCatalog();
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()));
+    for (auto _ : state) {
+        std::vector<std::string> keywords = {"tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT),
+                                             "tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT)};
+        benchmark::DoNotOptimize(db.searchFoods(keywords, false));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentSearch)->ThreadRange(1, 8)->UseRealTime();
+
+// Thread 0 adds a batch of foods per iteration; the other threads look foods up
+void BM_GetFoodWhileWriting(benchmark::State& state) {
+    const std::vector<std::string>& catalogIds = setUpCatalog();
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()));
+    bool writer = state.thread_index() == 0;
+    std::vector<std::pair<std::vector<std::string>, float>> batch(16, {{"written"}, 100.0f});
+    for (auto _ : state) {
+        if (writer) {
+            db.addBasicFoods(batch);
+        } else {
+            benchmark::DoNotOptimize(db.getFood(catalogIds[rng() % catalogIds.size()]));
+        }
+    }
+    state.counters[writer ? "writes" : "reads"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    if (writer) {
+        markCatalogModified();
+    }
+}
+BENCHMARK(BM_GetFoodWhileWriting)->ThreadRange(2, 8)->UseRealTime();
+
+} // namespace
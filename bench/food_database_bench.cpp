@@ -0,0 +1,257 @@
+/**
+ * @file food_database_bench.cpp
+ * @brief Benchmarks for FoodDatabase Hot Paths
+ *
+ * This file benchmarks the FoodDatabase operations the CLI relies on, using
+ * synthetic catalogs of increasing size. The benchmark argument is the number of
+ * basic foods; each catalog also has three levels of composites with a tenth as
+ * many composites per level and four components each.
+ *
+ * Key benchmarks:
+ * - searchFoods with AND and OR semantics, and repeated queries with and without
+ *   the search cache
+ * - rankFoods keeping the first page of OR matches
+ * - getFood for random IDs
+ * - createCompositeFood with a varying number of components
+ * - loadFromFiles and saveToFiles
+ * - Reloading the same catalog with the index in the arena versus on the heap,
+ *   with short and with long keywords
+ * - Time a save of the default files blocks the caller, written in place or
+ *   copied for the background saver
+ * - plan-meals searches over the whole catalog or the foods with one tag
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "synthetic_data.h"
+#include "alloc_counter.h"
+#include "manager/food_database.h"
+#include "manager/meal_planner.h"
+#include "manager/search_index.h"
+#include "utils/background_saver.h"
+
+namespace {
+
+CatalogSpec catalogSpec(benchmark::State& state) {
+    CatalogSpec spec;
+    spec.basicFoods = static_cast<size_t>(state.range(0));
+    spec.depth = 3;
+    spec.compositesPerLevel = spec.basicFoods / 10;
+    spec.fanOut = 4;
+    return spec;
+}
+
+void searchBenchmark(benchmark::State& state, bool matchAll) {
+    useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    // Measure the index itself; BM_SearchFoodsRepeated covers the cache
+    db.setSearchCacheCapacity(0);
+    std::mt19937 rng(7);
+    size_t results = 0;
+    for (auto _ : state) {
+        std::vector<std::string> keywords = {"tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT),
+                                             "tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT)};
+        auto foods = db.searchFoods(keywords, matchAll);
+        results += foods.size();
+        benchmark::DoNotOptimize(foods.data());
+    }
+    state.counters["results"] = benchmark::Counter(static_cast<double>(results),
+                                                   benchmark::Counter::kAvgIterations);
+}
+
+// OR queries ranked and cut to the first page of 25, as search-foods shows them
+void BM_RankFoodsOr(benchmark::State& state) {
+    // Ranking has to ignore the case of food keywords, like matching does
+    std::vector<std::string> query = {"soup"};
+    std::vector<std::string_view> mixedCase = {"Chicken", "Soup"}, lowerCase = {"chicken", "soup"};
+    std::vector<std::string_view> prefix = {"Soupy"}, substring = {"Chowsoup"};
+    auto score = [&](const std::vector<std::string_view>& keywords) {
+        return SearchIndex::score(query, ConstSpan<std::string_view>{keywords.data(), keywords.data() + keywords.size()});
+    };
+    if (score(mixedCase) != score(lowerCase) || !(score(mixedCase) > score(prefix) &&
+                                                  score(prefix) > score(substring) && score(substring) > 0.0f)) {
+        state.SkipWithError("ranking depends on the case of keywords");
+        return;
+    }
+
+    useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    db.setSearchCacheCapacity(0);
+    std::mt19937 rng(7);
+    for (auto _ : state) {
+        std::vector<std::string> keywords = {"tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT),
+                                             "tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT)};
+        FoodPage page = db.rankFoods(keywords, false, 25);
+        benchmark::DoNotOptimize(page.foods.data());
+    }
+}
+BENCHMARK(BM_RankFoodsOr)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// A client repeating a small set of OR queries; the argument is the cache capacity
+void BM_SearchFoodsRepeated(benchmark::State& state) {
+    CatalogSpec spec;
+    spec.basicFoods = 10000;
+    spec.depth = 3;
+    spec.compositesPerLevel = 1000;
+    useCatalog(spec);
+    FoodDatabase& db = FoodDatabase::getInstance();
+    db.setSearchCacheCapacity(static_cast<size_t>(state.range(0)));
+    std::vector<std::vector<std::string>> queries;
+    for (size_t i = 0; i < 32; i++) {
+        queries.push_back({"tag" + std::to_string(i), "tag" + std::to_string((i * 7 + 3) % SYNTHETIC_TAG_COUNT)});
+    }
+    std::mt19937 rng(7);
+    SearchCacheStats before = db.getSearchCacheStats();
+    for (auto _ : state) {
+        auto foods = db.searchFoods(queries[rng() % queries.size()], false);
+        benchmark::DoNotOptimize(foods.data());
+    }
+    SearchCacheStats after = db.getSearchCacheStats();
+    double lookups = static_cast<double>(after.hits + after.misses - before.hits - before.misses);
+    state.counters["hit_rate"] = lookups > 0 ? static_cast<double>(after.hits - before.hits) / lookups : 0.0;
+    db.setSearchCacheCapacity(SearchCache::DEFAULT_CAPACITY);
+}
+BENCHMARK(BM_SearchFoodsRepeated)->Arg(0)->Arg(SearchCache::DEFAULT_CAPACITY);
+
+void BM_SearchFoodsAnd(benchmark::State& state) {
+    searchBenchmark(state, true);
+}
+BENCHMARK(BM_SearchFoodsAnd)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_SearchFoodsOr(benchmark::State& state) {
+    searchBenchmark(state, false);
+}
+BENCHMARK(BM_SearchFoodsOr)->Arg(1000)->Arg(10000)->Arg(100000);
+
+void BM_GetFood(benchmark::State& state) {
+    const SyntheticCatalog& catalog = useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(7);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getFood(catalog.basicIds[rng() % catalog.basicIds.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFood)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Argument: number of components of each new composite (catalog of 10000 foods)
+void BM_CreateCompositeFood(benchmark::State& state) {
+    CatalogSpec spec;
+    spec.basicFoods = 10000;
+    spec.depth = 3;
+    spec.compositesPerLevel = 1000;
+    const SyntheticCatalog& catalog = useCatalog(spec);
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(7);
+    size_t fanOut = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        std::map<std::string, float> components;
+        for (size_t i = 0; i < fanOut; i++) {
+            components[catalog.basicIds[rng() % catalog.basicIds.size()]] += 1.0f;
+        }
+        benchmark::DoNotOptimize(db.createCompositeFood({"bench recipe", "tag1"}, components));
+    }
+    markCatalogModified();
+}
+BENCHMARK(BM_CreateCompositeFood)->Arg(2)->Arg(8)->Arg(32);
+
+void BM_LoadFromFiles(benchmark::State& state) {
+    const SyntheticCatalog& catalog = useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    AllocationScope scope;
+    for (auto _ : state) {
+        db.loadFromFiles(catalog.basicFoodPath, catalog.compositeFoodPath);
+    }
+    state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(scope.allocations()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * (catalog.basicIds.size() + catalog.compositeIds.size()));
+}
+BENCHMARK(BM_LoadFromFiles)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// Second argument: 1 to keep the index in the arena, 0 for the heap; third: 1 for
+// per-food keywords longer than the small-string buffer
+void BM_ReloadFromFiles(benchmark::State& state) {
+    CatalogSpec spec = catalogSpec(state);
+    spec.longKeywords = state.range(2) != 0;
+    const SyntheticCatalog& catalog = useCatalog(spec);
+    FoodDatabase& db = FoodDatabase::getInstance();
+    db.setArenaLoading(state.range(1) != 0);
+    // Applies the mode, and sizes the block the arena keeps for reloads
+    db.loadFromFiles(catalog.basicFoodPath, catalog.compositeFoodPath);
+    AllocationScope scope;
+    for (auto _ : state) {
+        db.loadFromFiles(catalog.basicFoodPath, catalog.compositeFoodPath);
+    }
+    state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(scope.allocations()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * (catalog.basicIds.size() + catalog.compositeIds.size()));
+    db.setArenaLoading(true);
+}
+BENCHMARK(BM_ReloadFromFiles)->ArgsProduct({{10000, 100000}, {0, 1}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_SaveToFiles(benchmark::State& state) {
+    const SyntheticCatalog& catalog = useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    for (auto _ : state) {
+        db.saveToFiles("bench_save_basic.json", "bench_save_composite.json");
+    }
+    state.SetItemsProcessed(state.iterations() * (catalog.basicIds.size() + catalog.compositeIds.size()));
+}
+BENCHMARK(BM_SaveToFiles)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// Second argument 0: saveToFiles; 1: prepareSave, with the job run on the
+// background saver outside the timed region
+void BM_SaveBlocking(benchmark::State& state) {
+    const SyntheticCatalog& catalog = useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    BackgroundSaver saver;
+    bool background = state.range(1) != 0;
+    float calories = 100.0f;
+    for (auto _ : state) {
+        state.PauseTiming();
+        db.updateBasicFood(catalog.basicIds.front(), calories++);
+        state.ResumeTiming();
+        if (background) {
+            saver.submit(db.prepareSave());
+            state.PauseTiming();
+            saver.flush();
+            state.ResumeTiming();
+        } else {
+            db.saveToFiles();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (catalog.basicIds.size() + catalog.compositeIds.size()));
+}
+BENCHMARK(BM_SaveBlocking)->Args({10000, 0})->Args({10000, 1})->Args({100000, 0})->Args({100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Plans for random targets as plan-meals runs them; the second argument selects
+// all foods (0) or the foods with one tag (1)
+void BM_PlanMeals(benchmark::State& state) {
+    useCatalog(catalogSpec(state));
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(7);
+    uint64_t combinations = 0;
+    size_t timeouts = 0;
+    for (auto _ : state) {
+        std::vector<std::string> keywords;
+        if (state.range(1) != 0) {
+            keywords.push_back("tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT));
+        }
+        MealPlanOptions options;
+        options.targetCalories = static_cast<float>(1200 + rng() % 1400);
+        MealPlanResult result = MealPlanner::plan(db.getFoodCalories(keywords), options);
+        combinations += result.combinations;
+        timeouts += result.timedOut ? 1 : 0;
+        benchmark::DoNotOptimize(result.plans.data());
+    }
+    state.counters["combinations"] = benchmark::Counter(static_cast<double>(combinations),
+                                                        benchmark::Counter::kAvgIterations);
+    state.counters["timeouts"] = benchmark::Counter(static_cast<double>(timeouts));
+}
+BENCHMARK(BM_PlanMeals)->Args({10000, 0})->Args({100000, 0})->Args({100000, 1})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
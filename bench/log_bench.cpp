@@ -0,0 +1,266 @@
+/**
+ * @file log_bench.cpp
+ * @brief Benchmarks for Log History Serialization and Calorie Summaries
+ *
+ * This file benchmarks LogHistory serialization on synthetic multi-year logs
+ * and the calorie summary computed by the "calories" command. The benchmark
+ * argument is the number of years of daily entries, eight foods per day.
+ *
+ * Key benchmarks:
+ * - LogHistory::fromJson and LogHistory::toJson
+ * - Reloading a history with the servings in the arena versus on the heap
+ * - LogHistory::saveToFiles after changing every date versus a single date
+ * - LogHistory::loadFromFiles reading every month versus only recent ones (lazy loading)
+ * - The per-day calorie summary of CLI::viewCalories
+ * - Range calorie totals of the "view-calories --from/--to" command
+ * - Backfilling entries one add-food command at a time versus one batch
+ * - The basic ingredients of a month of meals, walked recursively versus expanded
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "synthetic_data.h"
+#include "alloc_counter.h"
+#include "manager/food_database.h"
+#include "models/log_entry.h"
+
+namespace {
+
+const size_t FOODS_PER_DAY = 8;
+
+const SyntheticCatalog& logCatalog() {
+    CatalogSpec spec;
+    spec.basicFoods = 10000;
+    spec.depth = 3;
+    spec.compositesPerLevel = 1000;
+    return useCatalog(spec);
+}
+
+json yearsOfLogs(benchmark::State& state) {
+    const SyntheticCatalog& catalog = logCatalog();
+    return generateLogJson(static_cast<size_t>(state.range(0)) * 365, FOODS_PER_DAY, catalog.basicIds);
+}
+
+void BM_LogHistoryFromJson(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    AllocationScope scope;
+    for (auto _ : state) {
+        LogHistory history;
+        history.fromJson(logs);
+        benchmark::DoNotOptimize(&history);
+    }
+    state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(scope.allocations()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * logs.size());
+}
+BENCHMARK(BM_LogHistoryFromJson)->Arg(1)->Arg(5)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// Second argument: 1 to keep the servings in the arena, 0 for the heap
+void BM_LogHistoryReload(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history;
+    history.setArenaLoading(state.range(1) != 0);
+    history.fromJson(logs);
+    AllocationScope scope;
+    for (auto _ : state) {
+        history.fromJson(logs);
+    }
+    state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(scope.allocations()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * logs.size());
+}
+BENCHMARK(BM_LogHistoryReload)->ArgsProduct({{5, 20}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_LogHistoryToJson(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history;
+    history.fromJson(logs);
+    for (auto _ : state) {
+        json j = history.toJson();
+        benchmark::DoNotOptimize(j.size());
+    }
+    state.SetItemsProcessed(state.iterations() * logs.size());
+}
+BENCHMARK(BM_LogHistoryToJson)->Arg(1)->Arg(5)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// Writing every monthly log file, as after migrating a legacy logs.json
+void BM_LogHistorySaveAll(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history("bench_logs", "bench_logs_legacy.json");
+    for (auto _ : state) {
+        state.PauseTiming();
+        history.fromJson(logs);
+        state.ResumeTiming();
+        history.saveToFiles();
+    }
+    state.SetItemsProcessed(state.iterations() * logs.size());
+}
+BENCHMARK(BM_LogHistorySaveAll)->Arg(1)->Arg(5)->Unit(benchmark::kMillisecond);
+
+// Saving after logging one food on a random day only rewrites that day's month
+void BM_LogHistorySaveOneDay(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history("bench_logs", "bench_logs_legacy.json");
+    history.fromJson(logs);
+    history.saveToFiles();
+    std::vector<Date> dates = history.getAvailableDates();
+    const SyntheticCatalog& catalog = logCatalog();
+    std::mt19937 rng(11);
+
+    for (auto _ : state) {
+        history.setCurrentDate(dates[rng() % dates.size()]);
+        history.executeCommand("add-food", {{"food_id", catalog.basicIds[rng() % catalog.basicIds.size()]},
+                                            {"servings", "1"}});
+        history.saveToFiles();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogHistorySaveOneDay)->Arg(1)->Arg(5)->Unit(benchmark::kMicrosecond);
+
+// Loading the monthly log files at startup; lazily, months before the last week are only listed
+void BM_LogHistoryLoadFromFiles(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory saved("bench_logs_load", "bench_logs_legacy.json");
+    saved.fromJson(logs);
+    saved.saveToFiles();
+    for (auto _ : state) {
+        LogHistory history("bench_logs_load", "bench_logs_legacy.json");
+        history.setLazyLoading(state.range(1) != 0);
+        history.loadFromFiles();
+        benchmark::DoNotOptimize(&history);
+    }
+    state.SetItemsProcessed(state.iterations() * logs.size());
+}
+// Second argument: whether lazy loading is enabled
+BENCHMARK(BM_LogHistoryLoadFromFiles)->Args({1, 0})->Args({5, 0})->Args({5, 1})->Args({20, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// The calorie summary of the "calories" command for random days of the history
+void BM_ViewCaloriesSummary(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history;
+    history.fromJson(logs);
+    std::vector<Date> dates = history.getAvailableDates();
+    FoodDatabase& db = FoodDatabase::getInstance();
+    std::mt19937 rng(7);
+
+    for (auto _ : state) {
+        LogEntry* log = history.getLog(dates[rng() % dates.size()]);
+        benchmark::DoNotOptimize(db.calculateTotalCalories(log->getFoods()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ViewCaloriesSummary)->Arg(1)->Arg(5);
+
+// Calorie totals over random windows of up to 90 days, answered by the Fenwick tree
+void BM_RangeCalorieTotals(benchmark::State& state) {
+    json logs = yearsOfLogs(state);
+    LogHistory history;
+    history.fromJson(logs);
+    FoodDatabase& db = FoodDatabase::getInstance();
+    history.setCalorieSource(
+        [&db](ConstSpan<FoodServings> foods) { return db.calculateTotalCalories(foods); },
+        [&db]() { return db.getCalorieVersion(); });
+    std::vector<Date> dates = history.getAvailableDates();
+    history.getTotalCalories(dates.front(), dates.back());
+    std::mt19937 rng(5);
+
+    for (auto _ : state) {
+        Date from = dates[rng() % dates.size()];
+        benchmark::DoNotOptimize(history.getTotalCalories(from, from + static_cast<int32_t>(rng() % 90)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RangeCalorieTotals)->Arg(1)->Arg(5);
+
+// Backfilling days of entries through one add-food command each
+void BM_BackfillSingleCommands(benchmark::State& state) {
+    const SyntheticCatalog& catalog = logCatalog();
+    size_t entries = static_cast<size_t>(state.range(0));
+    std::mt19937 rng(3);
+    
+    for (auto _ : state) {
+        LogHistory history;
+        Date start = Date::fromCivil(2020, 1, 1);
+        for (size_t i = 0; i < entries; i++) {
+            history.setCurrentDate(start + static_cast<int32_t>(i / FOODS_PER_DAY));
+            history.executeCommand("add-food", {{"food_id", catalog.basicIds[rng() % catalog.basicIds.size()]},
+                                                {"servings", "1.5"}});
+        }
+        benchmark::DoNotOptimize(&history);
+    }
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK(BM_BackfillSingleCommands)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// The same backfill applied as a single batch command
+void BM_BackfillBatch(benchmark::State& state) {
+    const SyntheticCatalog& catalog = logCatalog();
+    size_t entries = static_cast<size_t>(state.range(0));
+    std::mt19937 rng(3);
+    std::vector<LogOperation> operations;
+    Date start = Date::fromCivil(2020, 1, 1);
+    for (size_t i = 0; i < entries; i++) {
+        operations.push_back({LogOperation::ADD, start + static_cast<int32_t>(i / FOODS_PER_DAY),
+                              catalog.basicIds[rng() % catalog.basicIds.size()], 1.5f});
+    }
+    
+    for (auto _ : state) {
+        LogHistory history;
+        history.executeBatch(operations);
+        benchmark::DoNotOptimize(&history);
+    }
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK(BM_BackfillBatch)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// Walks a food's components through getFood, as callers had to before the expansions
+void addIngredientsRecursively(FoodDatabase& db, const std::string& id, float servings,
+                               std::map<std::string, float>& ingredients) {
+    auto food = db.getFood(id);
+    if (!food) {
+        return;
+    }
+    if (const auto* composite = dynamic_cast<const CompositeFood*>(food.get())) {
+        for (const auto& [component, componentServings] : composite->getComponents()) {
+            addIngredientsRecursively(db, component, servings * componentServings, ingredients);
+        }
+    } else {
+        ingredients[id] += servings;
+    }
+}
+
+// The basic ingredients of a month of composite meals; argument 0 walks the
+// components recursively, 1 uses FoodDatabase::sumIngredients
+void BM_MonthIngredients(benchmark::State& state) {
+    const SyntheticCatalog& catalog = logCatalog();
+    FoodDatabase& db = FoodDatabase::getInstance();
+    LogHistory history;
+    history.fromJson(generateLogJson(30, FOODS_PER_DAY, catalog.compositeIds));
+    ConstSpan<LogEntry> month = history.getLogs(Date::fromCivil(2020, 1, 1), Date::fromCivil(2020, 1, 30));
+    const FoodIds& ids = FoodIds::getInstance();
+    
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            std::map<std::string, float> ingredients;
+            for (const LogEntry& entry : month) {
+                for (const auto& [food, servings] : entry.getFoods()) {
+                    addIngredientsRecursively(db, ids.name(food), servings, ingredients);
+                }
+            }
+            benchmark::DoNotOptimize(ingredients.size());
+        } else {
+            std::vector<FoodServings> eaten;
+            for (const LogEntry& entry : month) {
+                eaten.insert(eaten.end(), entry.getFoods().begin(), entry.getFoods().end());
+            }
+            std::vector<FoodServings> ingredients = db.sumIngredients({eaten.data(), eaten.data() + eaten.size()});
+            benchmark::DoNotOptimize(ingredients.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 30 * FOODS_PER_DAY);
+}
+BENCHMARK(BM_MonthIngredients)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+} // namespace
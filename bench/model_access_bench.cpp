@@ -0,0 +1,176 @@
+/**
+ * @file model_access_bench.cpp
+ * @brief Benchmarks for Food and LogEntry Accessors
+ *
+ * This file measures the cost of reading foods and log entries through their
+ * accessors. Each "ByValue" benchmark copies the container the way the accessors
+ * used to return it; the matching "ByReference" benchmark reads it through the
+ * current const-reference accessor. The allocs/iter counter shows the heap
+ * allocations each variant performs.
+ *
+ * Key benchmarks:
+ * - Keyword, component and log food access, by food ID or interned handle
+ * - Constructing foods from copied versus moved strings
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "alloc_counter.h"
+#include "models/food.h"
+#include "models/log_entry.h"
+
+namespace {
+
+// Longer than the small-string buffer, so every copy allocates
+std::string longName(const char* prefix, int i) {
+    return std::string(prefix) + "_with_a_reasonably_long_name_" + std::to_string(i);
+}
+
+std::vector<std::string> makeKeywords(int count) {
+    std::vector<std::string> keywords;
+    for (int i = 0; i < count; i++) {
+        keywords.push_back(longName("keyword", i));
+    }
+    return keywords;
+}
+
+CompositeFood makeComposite(int components) {
+    CompositeFood food("composite_food_benchmark_recipe", makeKeywords(4));
+    for (int i = 0; i < components; i++) {
+        food.addComponent(longName("component", i), 1.5f);
+    }
+    return food;
+}
+
+LogEntry makeLog(int foods) {
+    LogEntry log(Date::fromString("2024-01-01"));
+    for (int i = 0; i < foods; i++) {
+        log.addFood(longName("food", i), 1.0f);
+    }
+    return log;
+}
+
+void reportAllocations(benchmark::State& state, const AllocationScope& scope) {
+    state.counters["allocs/iter"] = benchmark::Counter(
+        static_cast<double>(scope.allocations()), benchmark::Counter::kAvgIterations);
+}
+
+void BM_KeywordsByValue(benchmark::State& state) {
+    BasicFood food("basic_food_benchmark_item", makeKeywords(static_cast<int>(state.range(0))), 100.0f);
+    AllocationScope scope;
+    for (auto _ : state) {
+        std::vector<std::string> keywords = food.getKeywords();
+        benchmark::DoNotOptimize(keywords.data());
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_KeywordsByValue)->Arg(4)->Arg(16);
+
+void BM_KeywordsByReference(benchmark::State& state) {
+    BasicFood food("basic_food_benchmark_item", makeKeywords(static_cast<int>(state.range(0))), 100.0f);
+    AllocationScope scope;
+    for (auto _ : state) {
+        const std::vector<std::string>& keywords = food.getKeywords();
+        benchmark::DoNotOptimize(keywords.data());
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_KeywordsByReference)->Arg(4)->Arg(16);
+
+void BM_ComponentsByValue(benchmark::State& state) {
+    CompositeFood food = makeComposite(static_cast<int>(state.range(0)));
+    AllocationScope scope;
+    for (auto _ : state) {
+        std::map<std::string, float> components = food.getComponents();
+        float servings = 0.0f;
+        for (const auto& component : components) {
+            servings += component.second;
+        }
+        benchmark::DoNotOptimize(servings);
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_ComponentsByValue)->Arg(4)->Arg(32);
+
+void BM_ComponentsByReference(benchmark::State& state) {
+    CompositeFood food = makeComposite(static_cast<int>(state.range(0)));
+    AllocationScope scope;
+    for (auto _ : state) {
+        float servings = 0.0f;
+        for (const auto& component : food.getComponents()) {
+            servings += component.second;
+        }
+        benchmark::DoNotOptimize(servings);
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_ComponentsByReference)->Arg(4)->Arg(32);
+
+void BM_LogServingLookupByValue(benchmark::State& state) {
+    LogEntry log = makeLog(static_cast<int>(state.range(0)));
+    std::string target = longName("food", 0);
+    AllocationScope scope;
+    const FoodIds& ids = FoodIds::getInstance();
+    for (auto _ : state) {
+        // The string-keyed map log entries used to hold and return
+        std::map<std::string, float> foods;
+        for (const auto& [food, servings] : log.getFoods()) {
+            foods.emplace(ids.name(food), servings);
+        }
+        benchmark::DoNotOptimize(foods.at(target));
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_LogServingLookupByValue)->Arg(8)->Arg(64);
+
+void BM_LogServingLookupByReference(benchmark::State& state) {
+    LogEntry log = makeLog(static_cast<int>(state.range(0)));
+    std::string target = longName("food", 0);
+    AllocationScope scope;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(log.getServings(target));
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_LogServingLookupByReference)->Arg(8)->Arg(64);
+
+// Looking up an interned handle skips hashing the food ID
+void BM_LogServingLookupByHandle(benchmark::State& state) {
+    LogEntry log = makeLog(static_cast<int>(state.range(0)));
+    FoodHandle target = FoodIds::getInstance().find(longName("food", 0));
+    AllocationScope scope;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(log.getServings(target));
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_LogServingLookupByHandle)->Arg(8)->Arg(64);
+
+void BM_ConstructBasicFoodCopy(benchmark::State& state) {
+    AllocationScope scope;
+    for (auto _ : state) {
+        std::string id = longName("id", 1);
+        std::vector<std::string> keywords = makeKeywords(4);
+        BasicFood food(static_cast<const std::string&>(id),
+                       static_cast<const std::vector<std::string>&>(keywords), 100.0f);
+        benchmark::DoNotOptimize(&food);
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_ConstructBasicFoodCopy);
+
+void BM_ConstructBasicFoodMove(benchmark::State& state) {
+    AllocationScope scope;
+    for (auto _ : state) {
+        std::string id = longName("id", 1);
+        std::vector<std::string> keywords = makeKeywords(4);
+        BasicFood food(std::move(id), std::move(keywords), 100.0f);
+        benchmark::DoNotOptimize(&food);
+    }
+    reportAllocations(state, scope);
+}
+BENCHMARK(BM_ConstructBasicFoodMove);
+
+} // namespace
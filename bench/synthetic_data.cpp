@@ -0,0 +1,166 @@
+/**
+ * @file synthetic_data.cpp
+ * @brief Synthetic Catalogs and Logs for Benchmarks Implementation
+ *
+ * Catalog files are written with the same layout FoodDatabase saves, so they
+ * exercise the regular loading code. Composite calories are computed from their
+ * components, keeping the generated data consistent.
+ */
+
+#include "synthetic_data.h"
+#include "bench_workspace.h"
+#include "manager/food_database.h"
+#include "utils/date.h"
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string tag(std::mt19937& rng) {
+    return "tag" + std::to_string(rng() % SYNTHETIC_TAG_COUNT);
+}
+
+void writeJson(const std::string& path, const json& j) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    file << j;
+}
+
+std::string specName(const CatalogSpec& spec) {
+    return "catalog_" + std::to_string(spec.basicFoods) + "_" + std::to_string(spec.depth) + "_" +
+           std::to_string(spec.compositesPerLevel) + "_" + std::to_string(spec.fanOut) + "_" +
+           std::to_string(spec.seed) + (spec.longKeywords ? "_long" : "");
+}
+
+} // namespace
+
+/**
+ * generateCatalog Function
+ * @param spec The shape of the catalog
+ * @return The paths of the written files and the generated IDs
+ */
+SyntheticCatalog generateCatalog(const CatalogSpec& spec) {
+    enterBenchWorkspace();
+    std::mt19937 rng(spec.seed);
+    SyntheticCatalog catalog;
+    std::string name = specName(spec);
+    catalog.basicFoodPath = name + "_basic.json";
+    catalog.compositeFoodPath = name + "_composite.json";
+
+    std::map<std::string, float> calories;
+    json basics = json::array();
+    for (std::size_t i = 0; i < spec.basicFoods; i++) {
+        std::string id = "basic_" + std::to_string(i);
+        float foodCalories = static_cast<float>(20 + rng() % 600);
+        std::string keyword = (spec.longKeywords ? "syntheticingredient" : "food") + std::to_string(i);
+        basics.push_back({{"id", id}, {"keywords", {keyword, tag(rng), tag(rng)}},
+                          {"calories", foodCalories}});
+        calories[id] = foodCalories;
+        catalog.basicIds.push_back(id);
+    }
+
+    json composites = json::array();
+    std::vector<std::string> below = catalog.basicIds;
+    for (std::size_t level = 1; level <= spec.depth && !below.empty(); level++) {
+        std::vector<std::string> current;
+        for (std::size_t i = 0; i < spec.compositesPerLevel; i++) {
+            std::string id = "composite_" + std::to_string(level) + "_" + std::to_string(i);
+            std::map<std::string, float> components;
+            for (std::size_t c = 0; c < spec.fanOut; c++) {
+                components[below[rng() % below.size()]] += 0.5f * static_cast<float>(1 + rng() % 4);
+            }
+            float total = 0.0f;
+            for (const auto& [component, servings] : components) {
+                total += calories[component] * servings;
+            }
+            std::string keyword = (spec.longKeywords ? "syntheticrecipelevel" : "recipe") + std::to_string(level);
+            composites.push_back({{"id", id}, {"keywords", {keyword, tag(rng), tag(rng)}},
+                                  {"components", components}, {"calories", total}});
+            calories[id] = total;
+            current.push_back(id);
+        }
+        catalog.compositeIds.insert(catalog.compositeIds.end(), current.begin(), current.end());
+        below = std::move(current);
+    }
+
+    writeJson(catalog.basicFoodPath, basics);
+    writeJson(catalog.compositeFoodPath, composites);
+    return catalog;
+}
+
+/**
+ * useCatalog Function
+ * @param spec The shape of the catalog
+ * @return The catalog now loaded into the FoodDatabase singleton
+ */
+namespace {
+std::string loadedCatalog;
+}
+
+const SyntheticCatalog& useCatalog(const CatalogSpec& spec) {
+    static std::map<std::string, SyntheticCatalog> generated;
+    std::string& loaded = loadedCatalog;
+
+    std::string name = specName(spec);
+    auto it = generated.find(name);
+    if (it == generated.end()) {
+        it = generated.emplace(name, generateCatalog(spec)).first;
+    }
+    if (loaded != name) {
+        FoodDatabase::getInstance().loadFromFiles(it->second.basicFoodPath, it->second.compositeFoodPath);
+        loaded = name;
+    }
+    return it->second;
+}
+
+/**
+ * markCatalogModified Function
+ * Makes the next useCatalog call reload its catalog; called by benchmarks that
+ * add foods to the database.
+ */
+void markCatalogModified() {
+    loadedCatalog.clear();
+}
+
+/**
+ * generateLogJson Function
+ * @param days The number of consecutive days to log
+ * @param foodsPerDay The number of foods logged per day
+ * @param foodIds The foods to draw from
+ * @param seed The random seed
+ * @return The log history in the format read by LogHistory::fromJson
+ */
+json generateLogJson(std::size_t days, std::size_t foodsPerDay,
+                     const std::vector<std::string>& foodIds, unsigned seed) {
+    static const int DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    std::mt19937 rng(seed);
+    json logs = json::array();
+    int year = 2020, month = 1, day = 1;
+
+    for (std::size_t d = 0; d < days; d++) {
+        std::string date = Date::fromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)).toString();
+
+        json foods = json::object();
+        for (std::size_t f = 0; f < foodsPerDay && !foodIds.empty(); f++) {
+            foods[foodIds[rng() % foodIds.size()]] = 0.5 * (1 + rng() % 4);
+        }
+        logs.push_back({{"date", date}, {"foods", foods}});
+
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        int monthDays = DAYS_IN_MONTH[month - 1] + (month == 2 && leap ? 1 : 0);
+        if (++day > monthDays) {
+            day = 1;
+            if (++month > 12) {
+                month = 1;
+                year++;
+            }
+        }
+    }
+    return logs;
+}
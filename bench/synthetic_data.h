@@ -0,0 +1,62 @@
+/**
+ * @file synthetic_data.h
+ * @brief Synthetic Catalogs and Logs for Benchmarks
+ *
+ * This file declares generators for reproducible benchmark inputs: a food
+ * catalog with a configurable number of basic foods and a layered hierarchy of
+ * composite foods, and a multi-year food log drawing from such a catalog. All
+ * generators are seeded, so the same parameters always produce the same data.
+ *
+ * Key components:
+ * - CatalogSpec, the shape of a synthetic catalog (size, depth, fan-out)
+ * - Catalog generation as JSON files in the FoodDatabase file format
+ * - Log generation as JSON in the LogHistory format
+ */
+
+#ifndef SYNTHETIC_DATA_H
+#define SYNTHETIC_DATA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * CatalogSpec struct
+ * Parameters of a synthetic food catalog
+ */
+struct CatalogSpec {
+    std::size_t basicFoods = 1000;
+    std::size_t depth = 2;                // Levels of composite foods above the basic foods
+    std::size_t compositesPerLevel = 100;
+    std::size_t fanOut = 4;               // Components per composite, drawn from the level below
+    unsigned seed = 1;
+    bool longKeywords = false;            // Per-food keywords too long for the small-string buffer
+};
+
+/**
+ * SyntheticCatalog struct
+ * Paths of a generated catalog and the IDs it contains
+ */
+struct SyntheticCatalog {
+    std::string basicFoodPath;
+    std::string compositeFoodPath;
+    std::vector<std::string> basicIds;
+    std::vector<std::string> compositeIds;
+};
+
+// Number of distinct tag keywords; every food carries two of them
+const std::size_t SYNTHETIC_TAG_COUNT = 64;
+
+// Catalog generation (files are written once per spec into the working directory)
+SyntheticCatalog generateCatalog(const CatalogSpec& spec);
+
+// Loads the catalog into the FoodDatabase singleton unless it is already loaded
+const SyntheticCatalog& useCatalog(const CatalogSpec& spec);
+void markCatalogModified();
+
+// Log generation: one entry per day starting 2020-01-01
+nlohmann::json generateLogJson(std::size_t days, std::size_t foodsPerDay,
+                               const std::vector<std::string>& foodIds, unsigned seed = 1);
+
+#endif // SYNTHETIC_DATA_H
@@ -0,0 +1,156 @@
+/**
+ * @file user_metrics_bench.cpp
+ * @brief Benchmarks for the Daily Metrics History
+ *
+ * This file measures the columnar daily metrics history of a user and the batch
+ * calorie evaluation behind it. The benchmark argument is the number of rows in
+ * the history, or of people in the population.
+ *
+ * Key benchmarks:
+ * - Serializing the history to the JSON array user.json used to embed on every save
+ * - Saving the history after one new row, which appends a single row to its file
+ * - BMR and target calorie series over the whole history
+ * - BMR and target calories of a mixed population, one User at a time against
+ *   CalorieBatch::evaluate over the same columns
+ */
+
+#include <benchmark/benchmark.h>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "bench_workspace.h"
+#include "models/calorie_batch.h"
+#include "models/metric_series.h"
+#include "models/user.h"
+
+namespace {
+
+const time_t FIRST_DAY = 1700000000;
+
+DailyMetric metricFor(size_t row) {
+    return {FIRST_DAY + static_cast<time_t>(row) * 86400, 70.0f + static_cast<float>(row % 50) * 0.1f,
+            20 + static_cast<int>(row / 365 % 60), static_cast<int>(row % 5)};
+}
+
+MetricSeries makeSeries(size_t rows) {
+    MetricSeries series;
+    for (size_t row = 0; row < rows; row++) {
+        series.append(metricFor(row));
+    }
+    return series;
+}
+
+void BM_DailyMetricsToJson(benchmark::State& state) {
+    MetricSeries series = makeSeries(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        json metrics = series.toJson();
+        benchmark::DoNotOptimize(metrics);
+    }
+}
+BENCHMARK(BM_DailyMetricsToJson)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+void BM_DailyMetricsAppendSave(benchmark::State& state) {
+    std::string path = enterBenchWorkspace() + "/data/bench_user.metrics";
+    size_t rows = static_cast<size_t>(state.range(0));
+    MetricSeries series = makeSeries(rows);
+    series.save(path);
+    for (auto _ : state) {
+        series.append(metricFor(rows++));
+        series.save(path);
+    }
+}
+BENCHMARK(BM_DailyMetricsAppendSave)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+void BM_CalorieSeries(benchmark::State& state) {
+    size_t rows = static_cast<size_t>(state.range(0));
+    json metrics = makeSeries(rows).toJson();
+    User user = User::fromJson({{"name", "bench"}, {"age", 30}, {"gender", 0}, {"height", 175.0f},
+                                {"weight", 70.0f}, {"calorieCalcMethod", static_cast<int>(state.range(1))},
+                                {"dailyMetrics", metrics}});
+    for (auto _ : state) {
+        CalorieSeries series = user.getCalorieSeries(0, rows);
+        benchmark::DoNotOptimize(series.targetCalories.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows));
+}
+// Second argument: the calculation method (0 Mifflin-St Jeor, 2 WHO)
+BENCHMARK(BM_CalorieSeries)->Args({1000000, 0})->Args({1000000, 2})->Unit(benchmark::kMillisecond);
+
+/**
+ * Population struct
+ * The same people as User objects and as batch columns
+ */
+struct Population {
+    std::vector<User> users;
+    std::vector<float> weights;
+    std::vector<float> heights;
+    std::vector<uint16_t> ages;
+    std::vector<uint8_t> genders;
+    std::vector<uint8_t> activityLevels;
+    std::vector<uint8_t> goals;
+
+    CalorieBatchInput input() const {
+        return {{weights.data(), weights.data() + weights.size()},
+                {heights.data(), heights.data() + heights.size()},
+                {ages.data(), ages.data() + ages.size()},
+                {genders.data(), genders.data() + genders.size()},
+                {activityLevels.data(), activityLevels.data() + activityLevels.size()},
+                {goals.data(), goals.data() + goals.size()}};
+    }
+};
+
+Population makePopulation(size_t people, User::CalorieCalculationMethod method) {
+    Population population;
+    for (size_t i = 0; i < people; i++) {
+        float weight = 45.0f + static_cast<float>(i * 7 % 600) * 0.1f;
+        float height = 150.0f + static_cast<float>(i * 13 % 450) * 0.1f;
+        int age = 1 + static_cast<int>(i * 31 % 90);
+        int gender = static_cast<int>(i * 5 % 3);
+        int activity = static_cast<int>(i * 3 % 5);
+        int goal = static_cast<int>(i % 3);
+        population.users.emplace_back("bench", age, static_cast<User::Gender>(gender), height, weight,
+                                      static_cast<User::ActivityLevel>(activity), static_cast<User::Goal>(goal), method);
+        population.weights.push_back(weight);
+        population.heights.push_back(height);
+        population.ages.push_back(static_cast<uint16_t>(age));
+        population.genders.push_back(static_cast<uint8_t>(gender));
+        population.activityLevels.push_back(static_cast<uint8_t>(activity));
+        population.goals.push_back(static_cast<uint8_t>(goal));
+    }
+    return population;
+}
+
+void BM_PopulationCaloriesScalar(benchmark::State& state) {
+    size_t people = static_cast<size_t>(state.range(0));
+    Population population = makePopulation(people, static_cast<User::CalorieCalculationMethod>(state.range(1)));
+    std::vector<float> bmr(people);
+    std::vector<float> target(people);
+    for (auto _ : state) {
+        for (size_t i = 0; i < people; i++) {
+            bmr[i] = population.users[i].calculateBMR();
+            target[i] = population.users[i].calculateTargetCalories();
+        }
+        benchmark::DoNotOptimize(target.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(people));
+}
+// Second argument: the calculation method (0 Mifflin-St Jeor, 1 Harris-Benedict, 2 WHO)
+BENCHMARK(BM_PopulationCaloriesScalar)->Args({100000, 0})->Args({100000, 1})->Args({100000, 2})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PopulationCaloriesBatch(benchmark::State& state) {
+    size_t people = static_cast<size_t>(state.range(0));
+    auto method = static_cast<User::CalorieCalculationMethod>(state.range(1));
+    Population population = makePopulation(people, method);
+    std::vector<float> bmr(people);
+    std::vector<float> target(people);
+    for (auto _ : state) {
+        CalorieBatch::evaluate(method, population.input(), bmr.data(), target.data());
+        benchmark::DoNotOptimize(target.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(people));
+}
+BENCHMARK(BM_PopulationCaloriesBatch)->Args({100000, 0})->Args({100000, 1})->Args({100000, 2})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
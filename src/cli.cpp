@@ -14,36 +14,60 @@
  * - Error handling and validation of user input
  * - Managing the application state and flow
  * - Handling data persistence operations (save/load)
+ * - Running command scripts non-interactively with JSON-lines results
  */
 
 #include "cli.h"
+#include "manager/meal_planner.h"
+#include "utils/metrics.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <chrono>
 #include <ctime>
-#include <regex>
 #include <fstream>
 
 using namespace std;
 
 /**
  * CLI Constructor
+ * @param interactive False for scripted use: formatting and prompts are turned
+ *        off, and loading messages go to standard error instead of the results
  * Initializes the command-line interface.
  */
-CLI::CLI()
-    : foodDb(FoodDatabase::getInstance()),
-      userProfile(UserProfile::getInstance()) {
+CLI::CLI(bool interactive)
+    : interactive(interactive),
+      input(&cin),
+      inputLine(0),
+      quitRequested(false),
+      foodDb(FoodDatabase::getInstance()),
+      userProfile(&UserProfile::getInstance()),
+      logHistory(&defaultLogs),
+      tenants(foodDb),
+      journal("data/journal.log") {
     registerCommands();
     
+    streambuf* output = cout.rdbuf();
+    if (!interactive) {
+        TerminalColors::setEnabled(false);
+        userProfile->setInteractive(false);
+        cout.rdbuf(cerr.rdbuf());
+    }
+    
     // Set current date
-    auto now = chrono::system_clock::now();
-    auto in_time_t = chrono::system_clock::to_time_t(now);
-    stringstream ss;
-    ss << put_time(localtime(&in_time_t), "%Y-%m-%d");
-    currentDate = ss.str();
-    logHistory.setCurrentDate(currentDate);
+    currentDate = Date::today();
+    defaultLogs.setCurrentDate(currentDate);
+    
+    // Only recent logs are read at startup; older months are read when first used
+    defaultLogs.setLazyLoading(true);
+    
+    // Daily calorie totals are computed from the food database
+    defaultLogs.setCalorieSource(
+        [this](ConstSpan<FoodServings> servings) { return foodDb.calculateTotalCalories(servings); },
+        [this]() { return foodDb.getCalorieVersion(); });
     
     // Load data - this will also trigger user profile initialization if needed
     try {
@@ -51,9 +75,14 @@ CLI::CLI()
     } catch (const exception& e) {
         cerr << TerminalColors::error("Error loading data: ") << e.what() << endl;
     }
+    cout.rdbuf(output);
+    
+    // Journal changes reach the disk within a few seconds even between saves
+    saver.setPeriodicTask([this]() { journal.sync(); },
+                          chrono::seconds(static_cast<chrono::seconds::rep>(DEFAULT_AUTOSAVE_SECONDS)));
     
     // Make sure user is initialized
-    userProfile.getUser();
+    userProfile->getUser();
 }
 
 /**
@@ -74,19 +103,28 @@ void CLI::registerCommands() {
     commands["exit"] = [this](const auto& args) { quitProgram(args); };
     helpText["exit"] = "Exit the program";
     
+    commands["stats"] = [this](const auto& args) { viewStats(args); };
+    helpText["stats"] = "stats [--json|--prometheus] - Show call counts, latency percentiles and allocations of commands and core operations";
+    
     // Food database commands
     commands["add-basic-food"] = [this](const auto& args) { addBasicFood(args); };
     helpText["add-basic-food"] = "add-basic-food <calories> <keyword1> [keyword2] ... - Add a new basic food";
     
     commands["list-foods"] = [this](const auto& args) { listFoods(args); };
-    helpText["list-foods"] = "list-foods - List all available foods";
+    helpText["list-foods"] = "list-foods [--limit N] [--offset N] - List all available foods, or one page of them";
     
     commands["search-foods"] = [this](const auto& args) { searchFoods(args); };
-    helpText["search-foods"] = "search-foods <keyword1> [keyword2] ... [--all] - Search for foods by keywords";
+    helpText["search-foods"] = "search-foods <keyword1> [keyword2] ... [--all|--any] [--limit N] [--offset N] - Search for foods by keywords, best matches first (" + to_string(SEARCH_PAGE_SIZE) + " per page by default, --limit 0 for all)";
+    
+    commands["search-cache"] = [this](const auto& args) { setSearchCache(args); };
+    helpText["search-cache"] = "search-cache [queries|off] - Show or set how many search results stay cached; the least recently used are dropped, and any food change invalidates them";
     
     commands["create-composite"] = [this](const auto& args) { createCompositeFood(args); };
     helpText["create-composite"] = "create-composite <keyword1> [keyword2] ... --components <food1> <servings1> [<food2> <servings2> ...] - Create a composite food";
     
+    commands["update-food"] = [this](const auto& args) { updateBasicFood(args); };
+    helpText["update-food"] = "update-food <food_id> <calories> - Change the calories of a basic food and update composites using it";
+    
     // Log commands
     commands["add-food"] = [this](const auto& args) { addFoodToLog(args); };
     helpText["add-food"] = "add-food <food_id> <servings> - Add food to the current day's log";
@@ -94,6 +132,9 @@ void CLI::registerCommands() {
     commands["remove-food"] = [this](const auto& args) { removeFoodFromLog(args); };
     helpText["remove-food"] = "remove-food <food_id> - Remove food from the log";
     
+    commands["log-batch"] = [this](const auto& args) { logBatch(args); };
+    helpText["log-batch"] = "log-batch <file|-> - Log many entries at once, one per line: [YYYY-MM-DD] <food_id> <servings> or remove [YYYY-MM-DD] <food_id>; '-' reads lines up to 'end' from standard input";
+    
     commands["view-log"] = [this](const auto& args) { viewLog(args); };
     helpText["view-log"] = "view-log [date] - View the log for a specific date or current date";
     
@@ -106,6 +147,12 @@ void CLI::registerCommands() {
     commands["redo"] = [this](const auto& args) { redoCommand(args); };
     helpText["redo"] = "redo - Redo the last undone operation";
     
+    commands["undo-limit"] = [this](const auto& args) { setUndoLimit(args); };
+    helpText["undo-limit"] = "undo-limit [changes] [--spill|--no-spill] - Show or set how many log changes undo keeps in memory and whether older ones spill to disk";
+    
+    commands["log-cache"] = [this](const auto& args) { setLogCache(args); };
+    helpText["log-cache"] = "log-cache [days|off] - Show or set how many days of logs stay loaded; older months are read when first used, or all of them with 'off'";
+    
     // User profile commands
     commands["profile"] = [this](const auto& args) { 
         if (args.size() <= 1) viewProfile(args); 
@@ -116,14 +163,53 @@ void CLI::registerCommands() {
     commands["calories"] = [this](const auto& args) { viewCalories(args); };
     helpText["calories"] = "calories [date] - Show calorie intake and target";
     
+    commands["view-ingredients"] = [this](const auto& args) { viewIngredients(args); };
+    helpText["view-ingredients"] = "view-ingredients [date] | --from <YYYY-MM-DD> [--to <YYYY-MM-DD>] | --food <food_id> - Show the basic foods eaten over a date range, or contained in one serving of a food";
+    
+    commands["view-calories"] = [this](const auto& args) { viewCaloriesRange(args); };
+    helpText["view-calories"] = "view-calories [date] | --from <YYYY-MM-DD> [--to <YYYY-MM-DD>] - Show calorie intake and target over a date range";
+    
+    commands["view-trend"] = [this](const auto& args) { viewTrend(args); };
+    helpText["view-trend"] = "view-trend [week|month|year] [count] - Show calorie totals and rolling averages per period";
+    
+    commands["plan-meals"] = [this](const auto& args) { planMeals(args); };
+    helpText["plan-meals"] = "plan-meals [keyword1] ... [--all|--any] [--target <calories>] [--tolerance <calories>] [--foods N] [--servings N] [--plans N] - Suggest foods adding up to the calories still left today, or to --target (default tolerance 50, up to 4 foods of up to 3 servings, 3 plans)";
+    
     commands["history"] = [this](const auto& args) { viewDailyHistory(args); };
-    helpText["history"] = "history [all|last N] - View history of your metrics (weight, age, activity level)";
+    helpText["history"] = "history [all|last N|page N] - View history of your metrics (weight, age, activity level) with BMR and target calories, 20 days per page";
+
+    // User management commands
+    commands["create-user"] = [this](const auto& args) { createUser(args); };
+    helpText["create-user"] = "create-user <user_id> <name> <age> <gender> <height_cm> <weight_kg> - Create an additional user with their own profile and logs";
+    
+    commands["switch-user"] = [this](const auto& args) { switchUser(args); };
+    helpText["switch-user"] = "switch-user [user_id] - Manage another user's profile and logs; without an ID, return to the default user";
+    
+    commands["list-users"] = [this](const auto& args) { listUsers(args); };
+    helpText["list-users"] = "list-users - List all users and which of them are loaded";
+    
+    commands["user-cache"] = [this](const auto& args) { setUserCache(args); };
+    helpText["user-cache"] = "user-cache [users] - Show or set how many additional users stay loaded; the least recently used are saved and unloaded";
 
     commands["save"] = [this](const auto& args) { saveData(args); };
-    helpText["save"] = "save - Save the current state to disk";
+    helpText["save"] = "save [--wait] - Save the current state to disk; large rewrites finish in the background unless --wait is given";
+    
+    commands["autosave"] = [this](const auto& args) { setAutosave(args); };
+    helpText["autosave"] = "autosave [seconds|off] - Show or set how often unsaved changes are synced to the journal in the background";
 
     commands["load"] = [this](const auto& args) { loadData(args); };
     helpText["load"] = "load - Load the state from disk";
+    
+#if DIET_MANAGER_METRICS
+    // Every command is timed as "command <name>", however it is run
+    for (auto& [name, handler] : commands) {
+        OperationMetrics& operation = Metrics::getInstance().get("command " + name);
+        handler = [&operation, timed = move(handler)](const vector<string>& args) {
+            METRICS_TIMER_FOR(operation);
+            timed(args);
+        };
+    }
+#endif
 }
 
 /**
@@ -132,7 +218,7 @@ void CLI::registerCommands() {
  */
 void CLI::run() {
     cout << TerminalColors::bold("\nDiet Manager - Type 'help' for available commands\n");
-    cout << "Current date: " << TerminalColors::info(currentDate) << endl << endl;
+    cout << "Current date: " << TerminalColors::info(currentDate.toString()) << endl << endl;
     
     while (true) {
         cout << TerminalColors::bold("> ");
@@ -159,6 +245,122 @@ void CLI::run() {
     }
 }
 
+/**
+ * runCommand Method
+ * @param args A command and its arguments
+ * @param userId The user to run the command for, or empty for the selected user
+ * @return {"ok", "output"} plus "error" if the command failed
+ * Runs one command through the dispatch table, capturing what it prints.
+ * Not thread-safe: commands share the CLI state and standard output.
+ */
+json CLI::runCommand(const vector<string>& args, const string& userId) {
+    json result;
+    ostringstream output;
+    streambuf* previous = cout.rdbuf(output.rdbuf());
+    string selected = getCurrentUserId();
+    try {
+        if (!userId.empty()) {
+            selectUser(userId);
+        }
+        auto it = args.empty() ? commands.end() : commands.find(args[0]);
+        if (it == commands.end()) {
+            throw invalid_argument("Unknown command: " + (args.empty() ? string() : args[0]));
+        }
+        it->second(args);
+        result["ok"] = true;
+    } catch (const exception& e) {
+        result["ok"] = false;
+        result["error"] = e.what();
+    }
+    if (!userId.empty()) {
+        selectUser(selected);
+    }
+    cout.rdbuf(previous);
+    
+    string text = output.str();
+    size_t first = text.find_first_not_of('\n');
+    size_t last = text.find_last_not_of('\n');
+    result["output"] = first == string::npos ? "" : text.substr(first, last - first + 1);
+    return result;
+}
+
+/**
+ * getCommandNames Method
+ * @return The names of all registered commands, in order
+ */
+vector<string> CLI::getCommandNames() const {
+    vector<string> names;
+    for (const auto& [name, handler] : commands) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+/**
+ * runBatch Method
+ * @param script The commands to run, one per line ('#' starts a comment line)
+ * @param save Whether to save the data at the end; otherwise the changes are discarded
+ * @return 0 if every command succeeded, 1 otherwise
+ * Runs the commands without prompting. For every command one JSON object is
+ * written to standard output: {"line", "command", "ok", "output"} plus "error"
+ * if it failed. A final {"summary": {"commands", "failed", "saved"}} object
+ * follows. "quit" and "exit" stop the script.
+ */
+int CLI::runBatch(istream& script, bool save) {
+    input = &script;
+    size_t commandCount = 0;
+    size_t failed = 0;
+    
+    string line;
+    inputLine = 0;
+    while (!quitRequested && getline(script, line)) {
+        inputLine++;
+        vector<string> args = parseCommandLine(line);
+        if (args.empty() || args[0][0] == '#') {
+            continue;
+        }
+        
+        json result = {{"line", inputLine}, {"command", line}};
+        result.update(runCommand(args));
+        if (!result["ok"].get<bool>()) {
+            failed++;
+        }
+        cout << result.dump() << '\n';
+        commandCount++;
+    }
+    
+    // Like answering the quit prompt; the save message is not part of the results
+    bool saved = false;
+    string error;
+    ostringstream ignored;
+    streambuf* previous = cout.rdbuf(ignored.rdbuf());
+    try {
+        if (save) {
+            saveData({"save", "--wait"});
+            saved = true;
+        } else {
+            UserProfile::getInstance().discardChanges();
+            journal.discardUncommitted();
+            tenants.discardUncommitted();
+            flushSaves();
+        }
+    } catch (const exception& e) {
+        error = e.what();
+        failed++;
+    }
+    cout.rdbuf(previous);
+    defaultLogs.setUndoSpillPath("");
+    tenants.closeUndoSpills();
+    
+    json summary = {{"commands", commandCount}, {"failed", failed}, {"saved", saved}};
+    if (!error.empty()) {
+        summary["error"] = error;
+    }
+    cout << json{{"summary", summary}}.dump() << endl;
+    input = &cin;
+    return failed == 0 ? 0 : 1;
+}
+
 /**
  * parseCommandLine Method
  * @param line The command line to parse
@@ -209,11 +411,12 @@ void CLI::displayHelp(const vector<string>& args) {
         
         // Group commands by category
         map<string, vector<string>> categories = {
-            {"General", {"help", "clear", "quit", "exit"}},
-            {"Food Database", {"add-basic-food", "list-foods", "search-foods", "create-composite"}},
-            {"Log Management", {"add-food", "remove-food", "view-log", "set-date", "undo", "redo"}},
-            {"User Profile", {"profile", "calories", "history"}},
-            {"Data Management", {"save", "load"}}
+            {"General", {"help", "clear", "stats", "quit", "exit"}},
+            {"Food Database", {"add-basic-food", "list-foods", "search-foods", "search-cache", "create-composite", "update-food"}},
+            {"Log Management", {"add-food", "remove-food", "log-batch", "view-log", "view-ingredients", "set-date", "undo", "redo", "undo-limit", "log-cache"}},
+            {"User Profile", {"profile", "calories", "view-calories", "plan-meals", "view-trend", "history"}},
+            {"Data Management", {"save", "load", "autosave"}},
+            {"User Management", {"create-user", "switch-user", "list-users", "user-cache"}}
         };
         
         for (const auto& [category, categoryCommands] : categories) {
@@ -231,6 +434,9 @@ void CLI::displayHelp(const vector<string>& args) {
  * @return Whether the user confirmed the action
  */
 bool CLI::confirmAction(const string& message) {
+    if (!interactive) {
+        return false;
+    }
     cout << TerminalColors::warning(message + " (y/n): ");
     string response;
     getline(cin, response);
@@ -243,27 +449,31 @@ bool CLI::confirmAction(const string& message) {
  * Shows the log for a specific date.
  */
 void CLI::viewLog(const vector<string>& args) {
-    string date = currentDate;
+    Date date = currentDate;
     if (args.size() > 1) {
-        date = args[1];
-        // Validate date format
-        regex dateRegex("\\d{4}-\\d{2}-\\d{2}");
-        if (!regex_match(date, dateRegex)) {
-            throw invalid_argument("Date must be in format YYYY-MM-DD");
-        }
+        date = Date::fromString(args[1]);
     }
     
-    auto log = logHistory.getLog(date);
-    auto foods = log->getFoods();
+    auto log = logHistory->getLog(date);
+    
+    // Entries are ordered by handle; list them by food ID
+    const FoodIds& ids = FoodIds::getInstance();
+    vector<pair<const string*, FoodServings>> foods;
+    for (const FoodServings& entry : log->getFoods()) {
+        foods.emplace_back(&ids.name(entry.first), entry);
+    }
+    sort(foods.begin(), foods.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
     
-    cout << TerminalColors::bold("\nFood Log for " + date + ":\n");
+    cout << TerminalColors::bold("\nFood Log for " + date.toString() + ":\n");
     cout << left << setw(20) << "Food" << setw(10) << "Servings" << "Calories" << endl;
     cout << string(50, '-') << endl;
     
     float totalCalories = 0;
     
-    for (const auto& [foodId, servings] : foods) {
-        auto food = foodDb.getFood(foodId);
+    for (const auto& [name, entry] : foods) {
+        const string& foodId = *name;
+        float servings = entry.second;
+        auto food = foodDb.getFood(entry.first);
         if (!food) {
             cout << TerminalColors::warning("Warning: Food not found in database: " + foodId) << endl;
             continue;
@@ -284,6 +494,82 @@ void CLI::viewLog(const vector<string>& args) {
     cout << endl;
 }
 
+/**
+ * viewIngredients Method
+ * @param args Command arguments
+ * Shows the basic foods eaten over a date range, or those in one serving of a food.
+ */
+void CLI::viewIngredients(const vector<string>& args) {
+    Date from = currentDate;
+    Date to = currentDate;
+    bool hasFrom = false;
+    string foodId;
+    
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--food" && i + 1 < args.size() && args.size() == 3) {
+            foodId = args[++i];
+        } else if (args[i] == "--from" && i + 1 < args.size()) {
+            from = Date::fromString(args[++i]);
+            hasFrom = true;
+        } else if (args[i] == "--to" && i + 1 < args.size()) {
+            to = Date::fromString(args[++i]);
+        } else if (args.size() == 2) {
+            from = to = Date::fromString(args[i]);
+            hasFrom = true;
+        } else {
+            throw invalid_argument("Usage: " + helpText["view-ingredients"]);
+        }
+    }
+    if (!hasFrom) {
+        from = to;
+    }
+    if (to < from) {
+        throw invalid_argument("The --from date must not be after the --to date");
+    }
+    
+    vector<FoodServings> basics;
+    string heading;
+    if (!foodId.empty()) {
+        if (!foodDb.getFood(foodId)) {
+            throw invalid_argument("Food not found: " + foodId);
+        }
+        basics = foodDb.getIngredients(foodId);
+        heading = "Basic Ingredients of One Serving of " + foodId + ":";
+    } else {
+        vector<FoodServings> eaten;
+        for (const LogEntry& entry : logHistory->getLogs(from, to)) {
+            ConstSpan<FoodServings> foods = entry.getFoods();
+            eaten.insert(eaten.end(), foods.begin(), foods.end());
+        }
+        basics = foodDb.sumIngredients(ConstSpan<FoodServings>{eaten.data(), eaten.data() + eaten.size()});
+        string range = from == to ? from.toString() : from.toString() + " to " + to.toString();
+        heading = string("Basic Ingredients Eaten ") + (from == to ? "on " : "from ") + range + ":";
+    }
+    
+    // Ordered by ID for display
+    const FoodIds& ids = FoodIds::getInstance();
+    vector<pair<const string*, FoodServings>> rows;
+    for (const FoodServings& basic : basics) {
+        rows.emplace_back(&ids.name(basic.first), basic);
+    }
+    sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+    
+    ostringstream out;
+    out << TerminalColors::bold("\n" + heading + "\n");
+    out << left << setw(20) << "Food" << setw(10) << "Servings" << "Calories" << '\n';
+    out << string(50, '-') << '\n';
+    float totalCalories = 0;
+    for (const auto& [name, basic] : rows) {
+        auto food = foodDb.getFood(basic.first);
+        float calories = food ? food->getCaloriesPerServing() * basic.second : 0.0f;
+        totalCalories += calories;
+        out << left << setw(20) << *name << setw(10) << basic.second << static_cast<int>(calories) << '\n';
+    }
+    out << string(50, '-') << '\n';
+    out << left << setw(20) << "TOTAL" << setw(10) << "" << static_cast<int>(totalCalories) << "\n\n";
+    cout << out.str() << flush;
+}
+
 /**
  * setDate Method
  * @param args Command arguments
@@ -294,16 +580,9 @@ void CLI::setDate(const vector<string>& args) {
         throw invalid_argument("Usage: set-date <YYYY-MM-DD>");
     }
     
-    string date = args[1];
-    // Validate date format
-    regex dateRegex("\\d{4}-\\d{2}-\\d{2}");
-    if (!regex_match(date, dateRegex)) {
-        throw invalid_argument("Date must be in format YYYY-MM-DD");
-    }
-    
-    currentDate = date;
-    logHistory.setCurrentDate(currentDate);
-    cout << TerminalColors::success("Current date set to " + currentDate) << endl;
+    currentDate = Date::fromString(args[1]);
+    logHistory->setCurrentDate(currentDate);
+    cout << TerminalColors::success("Current date set to " + currentDate.toString()) << endl;
 }
 
 /**
@@ -314,11 +593,11 @@ void CLI::setDate(const vector<string>& args) {
 void CLI::undoCommand(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
-    if (!logHistory.canUndo()) {
+    if (!logHistory->canUndo()) {
         cout << TerminalColors::warning("Nothing to undo.") << endl;
         return;
     }
-    logHistory.undo();
+    logHistory->undo();
     cout << TerminalColors::success("Last operation undone.") << endl;
 }
 
@@ -330,14 +609,83 @@ void CLI::undoCommand(const vector<string>& args) {
 void CLI::redoCommand(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
-    if (!logHistory.canRedo()) {
+    if (!logHistory->canRedo()) {
         cout << TerminalColors::warning("Nothing to redo.") << endl;
         return;
     }
-    logHistory.redo();
+    logHistory->redo();
     cout << TerminalColors::success("Operation redone.") << endl;
 }
 
+/**
+ * setUndoLimit Method
+ * @param args Command arguments
+ * Shows or changes the undo history limit and spilling of evicted changes.
+ */
+void CLI::setUndoLimit(const vector<string>& args) {
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--spill") {
+            logHistory->setUndoSpillPath(tenant ? tenant->directory + "/undo.spill" : "data/undo.spill");
+        } else if (args[i] == "--no-spill") {
+            logHistory->setUndoSpillPath("");
+        } else {
+            size_t changes;
+            try {
+                size_t parsed = 0;
+                changes = stoul(args[i], &parsed);
+                if (parsed != args[i].size()) {
+                    throw invalid_argument(args[i]);
+                }
+            } catch (const exception&) {
+                throw invalid_argument("Usage: undo-limit [changes] [--spill|--no-spill] - changes must be a number");
+            }
+            logHistory->setUndoLimit(changes);
+        }
+    }
+    
+    string spill = logHistory->getUndoSpillPath();
+    cout << "Undo keeps the last " << TerminalColors::info(to_string(logHistory->getUndoLimit()))
+         << " log change(s) in memory; older changes are "
+         << (spill.empty() ? "discarded." : "spilled to " + spill + ".") << endl;
+}
+
+/**
+ * setLogCache Method
+ * @param args Command arguments
+ * Shows or changes how many days of logs stay loaded, or turns lazy loading off.
+ */
+void CLI::setLogCache(const vector<string>& args) {
+    if (args.size() > 2) {
+        throw invalid_argument("Usage: " + helpText["log-cache"]);
+    }
+    if (args.size() == 2 && args[1] == "off") {
+        logHistory->setLazyLoading(false);
+    } else if (args.size() == 2) {
+        size_t days;
+        try {
+            size_t parsed = 0;
+            days = stoul(args[1], &parsed);
+            if (parsed != args[1].size() || days == 0) {
+                throw invalid_argument(args[1]);
+            }
+        } catch (const exception&) {
+            throw invalid_argument("Usage: log-cache [days|off] - days must be a positive number");
+        }
+        logHistory->setLazyLoading(true, days);
+    }
+    
+    LogCacheStats stats = logHistory->getCacheStats();
+    if (!logHistory->isLazyLoading()) {
+        cout << "All " << TerminalColors::info(to_string(stats.months)) << " month(s) of logs are loaded ("
+             << stats.loadedDays << " days)." << endl;
+        return;
+    }
+    cout << "Logs of " << TerminalColors::info(to_string(stats.loadedMonths)) << " of " << stats.months
+         << " month(s) are loaded (" << stats.loadedDays << " days); the least recently used months are unloaded beyond "
+         << TerminalColors::info(to_string(stats.budgetDays)) << " days." << endl;
+    cout << stats.faults << " month(s) read on first use, " << stats.evictions << " unloaded." << endl;
+}
+
 /**
  * viewProfile Method
  * @param args Command arguments (unused)
@@ -346,7 +694,7 @@ void CLI::redoCommand(const vector<string>& args) {
 void CLI::viewProfile(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
-    User& user = userProfile.getUser();
+    User& user = userProfile->getUser();
     
     // Get user activity level, goal, and calorie method as integers
     int activityLevel = static_cast<int>(user.getActivityLevel());
@@ -407,7 +755,7 @@ void CLI::updateProfile(const vector<string>& args) {
         }
         // Convert to enum value (0-based) by subtracting 1
         User::ActivityLevel activityLevel = static_cast<User::ActivityLevel>(level - 1);
-        userProfile.getUser().setActivityLevel(activityLevel);
+        userProfile->getUser().setActivityLevel(activityLevel);
         cout << TerminalColors::success("Updated activity level to " + to_string(level) 
                   + " (" + User::activityLevelToString(activityLevel) + ")") << endl;
         return;
@@ -419,7 +767,7 @@ void CLI::updateProfile(const vector<string>& args) {
         }
         // Convert to enum value (0-based) by subtracting 1
         User::Goal goal = static_cast<User::Goal>(goalNum - 1);
-        userProfile.getUser().setGoal(goal);
+        userProfile->getUser().setGoal(goal);
         cout << TerminalColors::success("Updated goal to " + to_string(goalNum) 
                   + " (" + User::goalToString(goal) + ")") << endl;
         return;
@@ -431,7 +779,7 @@ void CLI::updateProfile(const vector<string>& args) {
         }
         // Convert to enum value (0-based) by subtracting 1
         User::CalorieCalculationMethod method = static_cast<User::CalorieCalculationMethod>(methodNum - 1);
-        userProfile.getUser().setCalorieCalculationMethod(method);
+        userProfile->getUser().setCalorieCalculationMethod(method);
         cout << TerminalColors::success("Updated calorie method to " + to_string(methodNum) 
                   + " (" + User::calorieMethodToString(method) + ")") << endl;
         return;
@@ -443,7 +791,7 @@ void CLI::updateProfile(const vector<string>& args) {
     }
     
     // Handle other attributes with original method
-    userProfile.setUserAttribute(attribute, value);
+    userProfile->setUserAttribute(attribute, value);
     cout << TerminalColors::success("Updated " + attribute + " to '" + value + "'") << endl;
 }
 
@@ -453,32 +801,72 @@ void CLI::updateProfile(const vector<string>& args) {
  * Shows calorie intake and target for a specific date.
  */
 void CLI::viewCalories(const vector<string>& args) {
-    string date = currentDate;
+    Date date = currentDate;
     if (args.size() > 1) {
-        date = args[1];
-        // Validate date format
-        regex dateRegex("\\d{4}-\\d{2}-\\d{2}");
-        if (!regex_match(date, dateRegex)) {
-            throw invalid_argument("Date must be in format YYYY-MM-DD");
-        }
+        date = Date::fromString(args[1]);
     }
     
-    auto log = logHistory.getLog(date);
-    auto foods = log->getFoods();
+    float totalCalories = static_cast<float>(logHistory->getDayCalories(date));
     
-    float totalCalories = 0;
-    for (const auto& [foodId, servings] : foods) {
-        auto food = foodDb.getFood(foodId);
-        if (food) {
-            totalCalories += food->getCaloriesPerServing() * servings;
+    float targetCalories = userProfile->calculateTargetCalories();
+    float difference = totalCalories - targetCalories;
+    
+    cout << TerminalColors::bold("\nCalorie Summary for " + date.toString() + ":\n");
+    cout << "Consumed Calories: " << static_cast<int>(totalCalories) << endl;
+    cout << "Target Calories: " << static_cast<int>(targetCalories) << endl;
+    
+    string status;
+    if (difference > 0) {
+        status = TerminalColors::warning("Over target");
+    } else if (difference < 0) {
+        status = TerminalColors::success("Under target");
+    } else {
+        status = "On target";
+    }
+    
+    cout << "Difference: " << static_cast<int>(difference) << " (" << status << ")" << endl;
+    cout << endl;
+}
+
+/**
+ * viewCaloriesRange Method
+ * @param args Command arguments
+ * Shows calorie intake and target over a date range (inclusive).
+ */
+void CLI::viewCaloriesRange(const vector<string>& args) {
+    Date from = currentDate;
+    Date to = currentDate;
+    bool hasFrom = false;
+    
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--from" && i + 1 < args.size()) {
+            from = Date::fromString(args[++i]);
+            hasFrom = true;
+        } else if (args[i] == "--to" && i + 1 < args.size()) {
+            to = Date::fromString(args[++i]);
+        } else if (args.size() == 2) {
+            from = to = Date::fromString(args[i]);
+            hasFrom = true;
+        } else {
+            throw invalid_argument("Usage: " + helpText["view-calories"]);
         }
     }
+    if (!hasFrom) {
+        from = to;
+    }
+    if (to < from) {
+        throw invalid_argument("The --from date must not be after the --to date");
+    }
     
-    float targetCalories = userProfile.calculateTargetCalories();
+    int days = (to - from) + 1;
+    float totalCalories = static_cast<float>(logHistory->getTotalCalories(from, to));
+    float targetCalories = userProfile->calculateTargetCalories() * days;
     float difference = totalCalories - targetCalories;
     
-    cout << TerminalColors::bold("\nCalorie Summary for " + date + ":\n");
+    string range = from == to ? from.toString() : from.toString() + " to " + to.toString();
+    cout << TerminalColors::bold("\nCalorie Summary for " + range + " (" + to_string(days) + " day(s)):\n");
     cout << "Consumed Calories: " << static_cast<int>(totalCalories) << endl;
+    cout << "Average per Day: " << static_cast<int>(totalCalories / days) << endl;
     cout << "Target Calories: " << static_cast<int>(targetCalories) << endl;
     
     string status;
@@ -494,30 +882,116 @@ void CLI::viewCalories(const vector<string>& args) {
     cout << endl;
 }
 
+/**
+ * viewTrend Method
+ * @param args Command arguments
+ * Shows calorie totals, daily averages and a rolling average for the last
+ * periods (weeks, calendar months or calendar years) up to the current date.
+ */
+void CLI::viewTrend(const vector<string>& args) {
+    // Number of periods averaged by the rolling average
+    const size_t rollingWindow = 4;
+    
+    string period = args.size() > 1 ? args[1] : "week";
+    if (period != "week" && period != "month" && period != "year") {
+        throw invalid_argument("Usage: " + helpText["view-trend"]);
+    }
+    
+    int count = 8;
+    if (args.size() > 2) {
+        try {
+            count = stoi(args[2]);
+        } catch (const exception&) {
+            count = 0;
+        }
+        if (count <= 0) {
+            throw invalid_argument("Usage: view-trend [week|month|year] [count] - count must be a positive number");
+        }
+    }
+    
+    // Periods ending with the one that contains the current date, oldest first
+    vector<pair<Date, Date>> periods;
+    Date end = currentDate;
+    for (int i = 0; i < count; i++) {
+        Date start = period == "week" ? end - 6 : period == "month" ? end.firstOfMonth() : end.firstOfYear();
+        periods.emplace_back(start, end);
+        end = start - 1;
+    }
+    reverse(periods.begin(), periods.end());
+    
+    cout << TerminalColors::bold("\nCalorie Trend (" + period + "ly, rolling average over " 
+                                 + to_string(rollingWindow) + " periods):\n");
+    cout << left << setw(26) << "Period" << setw(8) << "Days" << setw(12) << "Total" 
+         << setw(12) << "Avg/Day" << "Rolling Avg" << endl;
+    cout << string(70, '-') << endl;
+    
+    vector<double> totals;
+    vector<int> dayCounts;
+    for (const auto& [start, last] : periods) {
+        double total = logHistory->getTotalCalories(start, last);
+        int days = (last - start) + 1;
+        totals.push_back(total);
+        dayCounts.push_back(days);
+        
+        double windowTotal = 0;
+        int windowDays = 0;
+        for (size_t i = totals.size() > rollingWindow ? totals.size() - rollingWindow : 0; i < totals.size(); i++) {
+            windowTotal += totals[i];
+            windowDays += dayCounts[i];
+        }
+        
+        cout << left << setw(26) << (start.toString() + " - " + last.toString())
+             << setw(8) << days
+             << setw(12) << static_cast<int>(total)
+             << setw(12) << static_cast<int>(total / days)
+             << static_cast<int>(windowTotal / windowDays) << endl;
+    }
+    
+    cout << string(70, '-') << endl;
+    cout << "Target per Day: " << static_cast<int>(userProfile->calculateTargetCalories()) << endl;
+    cout << endl;
+}
+
 /**
  * saveData Method
- * @param args Command arguments (unused)
- * Saves all data to files.
+ * @param args Command arguments: "--wait" waits for the background rewrite
+ * Saves all data. Food and log changes are already in the journal, so saving
+ * normally only syncs it; once it has grown large the changed files are rewritten
+ * in the background and the journal records they hold are dropped. Unchanged
+ * files are never rewritten.
  */
 void CLI::saveData(const vector<string>& args) {
-    (void)args; // Suppress unused parameter warning
+    bool wait = false;
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] != "--wait") {
+            throw invalid_argument("Usage: " + helpText["save"]);
+        }
+        wait = true;
+    }
     
     try {
-        // Save food database
-        foodDb.saveToFiles();
-        
         // Save user profile
-        userProfile.saveUser();
+        UserProfile& defaultProfile = UserProfile::getInstance();
+        if (defaultProfile.isDirty()) {
+            defaultProfile.saveUser();
+        }
         
-        // Save logs
-        ofstream file("data/logs.json");
-        if (!file.is_open()) {
-            throw runtime_error("Failed to open logs.json for writing");
+        // While a rewrite is still running, its records stay in the journal
+        if (journal.needsCompaction() && saver.isIdle()) {
+            writeBaseFiles();
+        } else {
+            journal.commit();
         }
         
-        json logsJson = logHistory.toJson();
-        file << setw(4) << logsJson << endl;
-        file.close();
+        // Additional users keep their log changes in journals of their own
+        tenants.flushAll();
+        
+        // A failed rewrite leaves its changes in the journal and is retried by this save
+        if (wait) {
+            saver.flush();
+        } else {
+            saver.checkErrors();
+        }
         
         cout << TerminalColors::success("All data saved successfully.") << endl;
     } catch (const exception& e) {
@@ -525,6 +999,144 @@ void CLI::saveData(const vector<string>& args) {
     }
 }
 
+/**
+ * writeBaseFiles Method
+ * Commits the journal and rewrites the food database and the log files that
+ * changed in the background, from copies of the data taken now. The journal
+ * records up to the commit are dropped once the files are written; later changes
+ * keep being journaled meanwhile.
+ */
+void CLI::writeBaseFiles() {
+    Journal::Position position = journal.commitPosition();
+    function<void()> saveFoods = foodDb.prepareSave();
+    
+    // Save logs (only the months with changed dates)
+    function<void()> saveLogs = defaultLogs.prepareSave();
+    
+    saver.submit([this, position, saveFoods, saveLogs]() {
+        if (saveFoods) {
+            saveFoods();
+        }
+        if (saveLogs) {
+            saveLogs();
+        }
+        journal.dropBefore(position);
+    });
+}
+
+/**
+ * flushSaves Method
+ * Waits for the background saves, as before exiting or rereading the files.
+ * @throws runtime_error if one of them failed
+ */
+void CLI::flushSaves() {
+    try {
+        saver.flush();
+    } catch (const exception& e) {
+        throw runtime_error("Error saving data in the background: " + string(e.what()));
+    }
+}
+
+/**
+ * setAutosave Method
+ * @param args Command arguments: the interval in seconds, or "off"
+ * Shows or sets how often the background thread syncs the journal, which bounds
+ * the changes a system crash can lose. Syncing does not save: changes made since
+ * the last save are still dropped when quitting without saving.
+ */
+void CLI::setAutosave(const vector<string>& args) {
+    if (args.size() > 2) {
+        throw invalid_argument("Usage: " + helpText["autosave"]);
+    }
+    if (args.size() == 2 && args[1] == "off") {
+        saver.setPeriodicTask(nullptr, chrono::milliseconds(0));
+    } else if (args.size() == 2) {
+        size_t seconds;
+        try {
+            size_t parsed = 0;
+            seconds = stoul(args[1], &parsed);
+            if (parsed != args[1].size() || seconds == 0) {
+                throw invalid_argument(args[1]);
+            }
+        } catch (const exception&) {
+            throw invalid_argument("Usage: autosave [seconds|off] - seconds must be a positive number");
+        }
+        saver.setPeriodicTask([this]() { journal.sync(); }, chrono::seconds(seconds));
+    }
+    
+    BackgroundSaverStats stats = saver.getStats();
+    long long seconds = chrono::duration_cast<chrono::seconds>(saver.getInterval()).count();
+    if (seconds == 0) {
+        cout << "The journal is synced on save and every " << Journal::DEFAULT_SYNC_INTERVAL << " changes." << endl;
+    } else {
+        cout << "The journal is synced every " << TerminalColors::info(to_string(seconds)) << " second(s) in the background ("
+             << stats.periodicRuns << " sync(s) so far)." << endl;
+    }
+    stringstream ss;
+    ss << stats.completed << " background save(s), " << stats.failed << " failed";
+    if (stats.completed > 0) {
+        ss << ", the last one took " << fixed << setprecision(2) << stats.lastMilliseconds << " ms";
+    }
+    ss << "; " << stats.pending << " pending.";
+    cout << ss.str() << endl;
+}
+
+/**
+ * viewStats Method
+ * @param args Command arguments: "--json" or "--prometheus" for a machine-readable dump
+ * Shows the measurements of every command and core operation called so far.
+ */
+void CLI::viewStats(const vector<string>& args) {
+    if (args.size() > 2 || (args.size() == 2 && args[1] != "--json" && args[1] != "--prometheus")) {
+        throw invalid_argument("Usage: " + helpText["stats"]);
+    }
+    if (!DIET_MANAGER_METRICS) {
+        cout << "This build does not record metrics (DIET_MANAGER_METRICS is off)." << endl;
+        return;
+    }
+    Metrics& metrics = Metrics::getInstance();
+    if (args.size() == 2) {
+        cout << (args[1] == "--json" ? metrics.toJson().dump(4) + "\n" : metrics.toPrometheus()) << flush;
+        return;
+    }
+    
+    auto duration = [](uint64_t nanoseconds) {
+        stringstream ss;
+        ss << fixed << setprecision(nanoseconds < 10000000 ? 1 : 0);
+        if (nanoseconds < 1000000) {
+            ss << nanoseconds / 1e3 << " us";
+        } else {
+            ss << nanoseconds / 1e6 << " ms";
+        }
+        return ss.str();
+    };
+    bool allocations = Metrics::countsAllocations();
+    
+    // One buffered write, like the search results
+    ostringstream out;
+    out << left << setw(34) << "Operation" << right << setw(8) << "Calls" << setw(12) << "p50"
+        << setw(12) << "p99" << setw(12) << "Max";
+    if (allocations) {
+        out << setw(14) << "Allocs/call";
+    }
+    out << '\n' << string(allocations ? 92 : 78, '-') << '\n';
+    for (const auto& [name, operation] : metrics.getOperations()) {
+        const LatencyHistogram& latency = operation->latency;
+        out << left << setw(34) << name << right << setw(8) << latency.count() << setw(12)
+            << duration(latency.percentile(0.50)) << setw(12) << duration(latency.percentile(0.99))
+            << setw(12) << duration(latency.max());
+        if (allocations) {
+            out << setw(14) << fixed << setprecision(1)
+                << static_cast<double>(operation->allocations.load()) / latency.count();
+        }
+        out << '\n';
+    }
+    if (!allocations) {
+        out << "Allocations are not counted (build with DIET_MANAGER_COUNT_ALLOCATIONS).\n";
+    }
+    cout << out.str() << flush;
+}
+
 /**
  * loadData Method
  * @param args Command arguments (unused)
@@ -533,22 +1145,43 @@ void CLI::saveData(const vector<string>& args) {
 void CLI::loadData(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
+    // Files being rewritten in the background are read after they are complete.
+    // A failed rewrite left its changes in the journal, so loading goes on.
+    try {
+        flushSaves();
+    } catch (const exception& e) {
+        cerr << TerminalColors::warning(e.what()) << endl;
+    }
+    
     try {
+        // Stop journaling while the files and the journal are read back
+        foodDb.setJournal(nullptr);
+        defaultLogs.setJournal(nullptr);
+        journal.close();
+        
         // Load food database
         foodDb.loadFromFiles();
+        for (const auto& stats : foodDb.getLastLoadStats()) {
+            stringstream ss;
+            ss << "Loaded " << stats.foods << " foods from " << stats.path
+               << " in " << fixed << setprecision(2) << stats.milliseconds << " ms";
+            cout << TerminalColors::info(ss.str()) << endl;
+        }
         
         // Load user profile
-        userProfile.loadUser();
+        UserProfile::getInstance().loadUser();
         
         // Load logs
-        ifstream file("data/logs.json");
-        if (file.is_open()) {
-            json logsJson;
-            file >> logsJson;
-            file.close();
-            
-            logHistory.fromJson(logsJson);
+        defaultLogs.loadFromFiles();
+        
+        // Apply the changes recorded since the files were last written
+        replayJournal();
+        
+        // Reload the selected additional user; the others are reloaded when next used
+        if (tenant) {
+            tenant->load(foodDb);
         }
+        logHistory->setCurrentDate(currentDate);
         
         cout << TerminalColors::success("All data loaded successfully.") << endl;
     } catch (const exception& e) {
@@ -556,6 +1189,27 @@ void CLI::loadData(const vector<string>& args) {
     }
 }
 
+/**
+ * replayJournal Method
+ * Applies the journal to the loaded data and reopens it for appending.
+ */
+void CLI::replayJournal() {
+    size_t replayed = journal.replay([this](const json& record) {
+        if (record.value("op", "").rfind("log-", 0) == 0) {
+            defaultLogs.applyJournalRecord(record);
+        } else {
+            foodDb.applyJournalRecord(record);
+        }
+    });
+    if (replayed > 0) {
+        cout << TerminalColors::info("Replayed " + to_string(replayed) + " changes from " + journal.getPath()) << endl;
+    }
+    
+    journal.open();
+    foodDb.setJournal(&journal);
+    defaultLogs.setJournal(&journal);
+}
+
 /**
  * quitProgram Method
  * @param args Command arguments (unused)
@@ -564,14 +1218,36 @@ void CLI::loadData(const vector<string>& args) {
 void CLI::quitProgram(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
-    if (confirmAction("Save before exiting?")) {
-        try {
+    // Scripts stop here; runBatch saves or discards the changes
+    if (!interactive) {
+        quitRequested = true;
+        return;
+    }
+    
+    try {
+        if (confirmAction("Save before exiting?")) {
             saveData({});
-        } catch (const exception& e) {
-            cerr << TerminalColors::error("Error saving data: ") << e.what() << endl;
+        } else {
+            // Drop the changes made since the last save
+            UserProfile::getInstance().discardChanges();
+            journal.discardUncommitted();
+            tenants.discardUncommitted();
         }
+    } catch (const exception& e) {
+        cerr << TerminalColors::error("Error saving data: ") << e.what() << endl;
+    }
+    
+    // exit() skips destructors, so wait for the background saves here
+    try {
+        flushSaves();
+    } catch (const exception& e) {
+        cerr << TerminalColors::error(e.what()) << endl;
     }
     
+    // exit() skips destructors, so remove the undo spill files here
+    defaultLogs.setUndoSpillPath("");
+    tenants.closeUndoSpills();
+    
     cout << TerminalColors::bold("Goodbye!") << endl;
     exit(0);
 }
@@ -580,7 +1256,7 @@ void CLI::quitProgram(const vector<string>& args) {
  * getCurrentDate Method
  * @return The current date
  */
-string CLI::getCurrentDate() const {
+Date CLI::getCurrentDate() const {
     return currentDate;
 }
 
@@ -611,46 +1287,33 @@ void CLI::addBasicFood(const vector<string>& args) {
 /**
  * listFoods Method
  * @param args Command arguments
- * Lists all foods in the database.
+ * Lists the foods in ID order, optionally one page at a time.
  */
 void CLI::listFoods(const vector<string>& args) {
-    (void)args; // Suppress unused parameter warning
-    
-    auto foods = foodDb.getAllFoods();
-    
-    cout << TerminalColors::bold("\nAvailable Foods (" + to_string(foods.size()) + "):\n");
-    cout << left << setw(20) << "ID" << setw(10) << "Calories" << setw(10) << "Type" << "Keywords" << endl;
-    cout << string(70, '-') << endl;
-    
-    for (const auto& food : foods) {
-        string type = food->isComposite() ? "Composite" : "Basic";
-        string keywords;
-        for (const auto& keyword : food->getKeywords()) {
-            keywords += keyword + ", ";
-        }
-        if (!keywords.empty()) {
-            keywords = keywords.substr(0, keywords.length() - 2);
+    size_t limit = 0;
+    size_t offset = 0;
+    for (size_t i = 1; i < args.size(); i++) {
+        if ((args[i] == "--limit" || args[i] == "--offset") && i + 1 < args.size()) {
+            (args[i] == "--limit" ? limit : offset) = parseCount(args[i], args[i + 1]);
+            i++;
+        } else {
+            throw invalid_argument("Usage: " + helpText["list-foods"]);
         }
-        
-        cout << left << setw(20) << food->getId() 
-                 << setw(10) << food->getCaloriesPerServing()
-                 << setw(10) << type
-                 << keywords << endl;
     }
-    cout << endl;
+    
+    FoodPage page = foodDb.getFoodPage(limit, offset);
+    printFoodPage("Available Foods (" + to_string(page.total) + "):", page, offset, false);
 }
 
 /**
  * searchFoods Method
  * @param args Command arguments
- * Searches for foods by keywords.
+ * Searches for foods by keywords and shows one page of the best matches.
  */
 void CLI::searchFoods(const vector<string>& args) {
-    if (args.size() < 2) {
-        throw invalid_argument("Usage: search-foods <keyword1> [keyword2] ... [--all]");
-    }
-    
     bool matchAll = true;
+    size_t limit = SEARCH_PAGE_SIZE;
+    size_t offset = 0;
     vector<string> keywords;
     
     for (size_t i = 1; i < args.size(); i++) {
@@ -658,34 +1321,134 @@ void CLI::searchFoods(const vector<string>& args) {
             matchAll = true;
         } else if (args[i] == "--any") {
             matchAll = false;
+        } else if ((args[i] == "--limit" || args[i] == "--offset") && i + 1 < args.size()) {
+            (args[i] == "--limit" ? limit : offset) = parseCount(args[i], args[i + 1]);
+            i++;
         } else {
             keywords.push_back(args[i]);
         }
     }
+    if (keywords.empty()) {
+        throw invalid_argument("Usage: " + helpText["search-foods"]);
+    }
     
-    auto foods = foodDb.searchFoods(keywords, matchAll);
+    FoodPage page = foodDb.rankFoods(keywords, matchAll, limit, offset);
     
     string matchType = matchAll ? "all" : "any";
-    cout << TerminalColors::bold("\nSearch Results - Foods matching " + matchType + " keywords (" + to_string(foods.size()) + "):\n");
-    cout << left << setw(20) << "ID" << setw(10) << "Calories" << setw(10) << "Type" << "Keywords" << endl;
-    cout << string(70, '-') << endl;
+    printFoodPage("Search Results - Foods matching " + matchType + " keywords (" + to_string(page.total) + "):",
+                  page, offset, true);
+}
+
+/**
+ * printFoodPage Method
+ * @param title The heading of the table
+ * @param page The foods to show
+ * @param offset The position of the page's first food among all results
+ * @param showScores Whether to show the relevance scores
+ * The table is written at once rather than flushing every row.
+ */
+void CLI::printFoodPage(const string& title, const FoodPage& page, size_t offset, bool showScores) {
+    ostringstream out;
+    out << TerminalColors::bold("\n" + title + "\n");
+    out << left << setw(20) << "ID" << setw(10) << "Calories" << setw(10) << "Type";
+    if (showScores) {
+        out << setw(8) << "Score";
+    }
+    out << "Keywords\n" << string(showScores ? 78 : 70, '-') << '\n';
     
-    for (const auto& food : foods) {
-        string type = food->isComposite() ? "Composite" : "Basic";
+    for (const auto& [food, score] : page.foods) {
         string keywordsList;
         for (const auto& keyword : food->getKeywords()) {
-            keywordsList += keyword + ", ";
+            keywordsList += (keywordsList.empty() ? "" : ", ") + keyword;
         }
-        if (!keywordsList.empty()) {
-            keywordsList = keywordsList.substr(0, keywordsList.length() - 2);
+        out << left << setw(20) << food->getId()
+            << setw(10) << food->getCaloriesPerServing()
+            << setw(10) << (food->isComposite() ? "Composite" : "Basic");
+        if (showScores) {
+            ostringstream scoreText;
+            scoreText << fixed << setprecision(2) << score;
+            out << setw(8) << scoreText.str();
         }
-        
-        cout << left << setw(20) << food->getId() 
-                 << setw(10) << food->getCaloriesPerServing()
-                 << setw(10) << type
-                 << keywordsList << endl;
+        out << keywordsList << '\n';
     }
-    cout << endl;
+    
+    size_t shownEnd = offset + page.foods.size();
+    if (offset > 0 || shownEnd < page.total) {
+        out << '\n';
+        if (page.foods.empty()) {
+            out << TerminalColors::info("No results at offset " + to_string(offset) + ".");
+        } else {
+            out << TerminalColors::info("Showing " + to_string(offset + 1) + "-" + to_string(shownEnd) + " of " +
+                                        to_string(page.total) + ".");
+        }
+        if (shownEnd < page.total) {
+            out << TerminalColors::info(" Use --offset " + to_string(shownEnd) + " for more.");
+        }
+        out << '\n';
+    }
+    out << '\n';
+    cout << out.str() << flush;
+}
+
+/**
+ * parseCount Method
+ * @param option The option the value belongs to
+ * @param value The value given for the option
+ * @return The value as a count
+ * @throws invalid_argument if the value is not a non-negative whole number
+ */
+size_t CLI::parseCount(const string& option, const string& value) {
+    try {
+        size_t parsed = 0;
+        unsigned long count = stoul(value, &parsed);
+        if (parsed == value.size() && isdigit(static_cast<unsigned char>(value[0]))) {
+            return count;
+        }
+    } catch (const exception&) {
+    }
+    throw invalid_argument(option + " must be a non-negative number");
+}
+
+/**
+ * setSearchCache Method
+ * @param args Command arguments
+ * Shows or changes how many search results stay cached, or turns the cache off.
+ */
+void CLI::setSearchCache(const vector<string>& args) {
+    if (args.size() > 2) {
+        throw invalid_argument("Usage: " + helpText["search-cache"]);
+    }
+    if (args.size() == 2 && args[1] == "off") {
+        foodDb.setSearchCacheCapacity(0);
+    } else if (args.size() == 2) {
+        size_t queries;
+        try {
+            size_t parsed = 0;
+            queries = stoul(args[1], &parsed);
+            if (parsed != args[1].size() || queries == 0) {
+                throw invalid_argument(args[1]);
+            }
+        } catch (const exception&) {
+            throw invalid_argument("Usage: search-cache [queries|off] - queries must be a positive number");
+        }
+        foodDb.setSearchCacheCapacity(queries);
+    }
+    
+    SearchCacheStats stats = foodDb.getSearchCacheStats();
+    if (stats.capacity == 0) {
+        cout << "Search results are not cached." << endl;
+    } else {
+        cout << "Up to " << TerminalColors::info(to_string(stats.capacity)) << " search queries stay cached; "
+             << stats.entries << " are cached now." << endl;
+    }
+    uint64_t lookups = stats.hits + stats.misses;
+    stringstream ss;
+    ss << stats.hits << " hit(s), " << stats.misses << " miss(es)";
+    if (lookups > 0) {
+        ss << " (" << fixed << setprecision(1) << 100.0 * stats.hits / lookups << "% hit rate)";
+    }
+    ss << ", " << stats.evictions << " eviction(s).";
+    cout << ss.str() << endl;
 }
 
 /**
@@ -732,6 +1495,31 @@ void CLI::createCompositeFood(const vector<string>& args) {
     cout << TerminalColors::success("Composite food '" + id + "' created successfully.") << endl;
 }
 
+/**
+ * updateBasicFood Method
+ * @param args Command arguments
+ * Changes the calories of a basic food.
+ */
+void CLI::updateBasicFood(const vector<string>& args) {
+    if (args.size() < 3) {
+        throw invalid_argument("Usage: update-food <food_id> <calories>");
+    }
+    
+    string foodId = args[1];
+    float calories;
+    try {
+        calories = stof(args[2]);
+    } catch (const exception&) {
+        throw invalid_argument("Calories must be a number");
+    }
+    
+    size_t updated = foodDb.updateBasicFood(foodId, calories);
+    cout << TerminalColors::success("Food '" + foodId + "' updated successfully.") << endl;
+    if (updated > 0) {
+        cout << TerminalColors::info("Recalculated " + to_string(updated) + " composite food(s).") << endl;
+    }
+}
+
 /**
  * addFoodToLog Method
  * @param args Command arguments
@@ -760,7 +1548,7 @@ void CLI::addFoodToLog(const vector<string>& args) {
         {"servings", args[2]}
     };
     
-    logHistory.executeCommand("add-food", params);
+    logHistory->executeCommand("add-food", params);
     
     float calories = food->getCaloriesPerServing() * servings;
     cout << TerminalColors::success("Added " + args[2] + " serving(s) of '" + foodId + "' (" 
@@ -779,10 +1567,9 @@ void CLI::removeFoodFromLog(const vector<string>& args) {
     
     string foodId = args[1];
     
-    auto log = logHistory.getCurrentLog();
-    auto foods = log->getFoods();
+    auto log = logHistory->getCurrentLog();
     
-    if (foods.find(foodId) == foods.end()) {
+    if (log->getServings(foodId) <= 0) {
         throw invalid_argument("Food not in log: " + foodId);
     }
     
@@ -790,41 +1577,277 @@ void CLI::removeFoodFromLog(const vector<string>& args) {
         {"food_id", foodId}
     };
     
-    logHistory.executeCommand("remove-food", params);
+    logHistory->executeCommand("remove-food", params);
     
     cout << TerminalColors::success("Removed '" + foodId + "' from the log.") << endl;
 }
 
+/**
+ * logBatch Method
+ * @param args Command arguments
+ * Logs the entries of a file or of standard input as one operation, which a
+ * single undo reverts. Every line is validated before any entry is logged.
+ * Fields may be separated by spaces or commas; empty lines and lines starting
+ * with '#' are skipped.
+ */
+void CLI::logBatch(const vector<string>& args) {
+    if (args.size() < 2) {
+        throw invalid_argument("Usage: log-batch <file|->");
+    }
+    
+    ifstream file;
+    bool fromStdin = args[1] == "-";
+    if (!fromStdin) {
+        file.open(args[1]);
+        if (!file.is_open()) {
+            throw invalid_argument("Cannot open file: " + args[1]);
+        }
+    }
+    istream& in = fromStdin ? *input : file;
+    
+    vector<LogOperation> operations;
+    string line;
+    string error;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        if (fromStdin && line == "end") {
+            break;
+        }
+        replace(line.begin(), line.end(), ',', ' ');
+        istringstream fields(line);
+        vector<string> parts;
+        for (string field; fields >> field;) {
+            parts.push_back(field);
+        }
+        if (parts.empty() || parts[0][0] == '#' || !error.empty()) {
+            continue;
+        }
+        try {
+            operations.push_back(parseBatchEntry(parts));
+        } catch (const invalid_argument& e) {
+            error = "Line " + to_string(lineNumber) + ": " + e.what();
+        }
+    }
+    
+    // Lines up to "end" are consumed even after an error, so none run as commands
+    if (fromStdin) {
+        inputLine += lineNumber;
+    }
+    if (!error.empty()) {
+        throw invalid_argument(error);
+    }
+    
+    if (operations.empty()) {
+        cout << TerminalColors::warning("No entries to log.") << endl;
+        return;
+    }
+    
+    size_t applied = logHistory->executeBatch(operations);
+    
+    vector<Date> dates;
+    dates.reserve(operations.size());
+    for (const auto& op : operations) {
+        dates.push_back(op.date);
+    }
+    sort(dates.begin(), dates.end());
+    size_t days = unique(dates.begin(), dates.end()) - dates.begin();
+    
+    cout << TerminalColors::success("Logged " + to_string(applied) + " entr" + (applied == 1 ? "y" : "ies") + " on "
+                                     + to_string(days) + " day(s).") << endl;
+    if (logHistory->canUndo()) {
+        cout << TerminalColors::info("Use 'undo' to revert the whole batch.") << endl;
+    } else {
+        cout << TerminalColors::warning("The batch exceeds the undo limit of " + to_string(logHistory->getUndoLimit())
+                                        + " change(s) and cannot be undone (see 'undo-limit').") << endl;
+    }
+}
+
+/**
+ * parseBatchEntry Method
+ * @param parts The fields of a log-batch line
+ * @return The log operation the line describes
+ * @throws invalid_argument if the line is malformed or names an unknown food
+ */
+LogOperation CLI::parseBatchEntry(const vector<string>& parts) {
+    LogOperation op{LogOperation::ADD, currentDate, "", 0.0f};
+    size_t next = 0;
+    if (parts[0] == "remove") {
+        op.type = LogOperation::REMOVE;
+        next = 1;
+    }
+    if (next < parts.size() && Date::tryParse(parts[next], op.date)) {
+        next++;
+    }
+    
+    size_t expected = op.type == LogOperation::ADD ? 2 : 1;
+    if (parts.size() - next != expected) {
+        throw invalid_argument("expected [YYYY-MM-DD] <food_id> <servings> or remove [YYYY-MM-DD] <food_id>");
+    }
+    op.foodId = parts[next];
+    if (!foodDb.getFood(op.foodId)) {
+        throw invalid_argument("food not found: " + op.foodId);
+    }
+    if (op.type == LogOperation::ADD) {
+        try {
+            op.servings = stof(parts[next + 1]);
+        } catch (const exception&) {
+            throw invalid_argument("servings must be a number");
+        }
+        if (op.servings <= 0) {
+            throw invalid_argument("servings must be positive");
+        }
+    }
+    return op;
+}
+
+/**
+ * planMeals Method
+ * @param args Command arguments
+ * Suggests sets of foods, optionally matching keywords, whose calories add up to
+ * what is left of the current date's target, or to a given target.
+ */
+void CLI::planMeals(const vector<string>& args) {
+    MealPlanOptions options;
+    bool matchAll = true;
+    bool hasTarget = false;
+    vector<string> keywords;
+    
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--all") {
+            matchAll = true;
+        } else if (args[i] == "--any") {
+            matchAll = false;
+        } else if ((args[i] == "--target" || args[i] == "--tolerance") && i + 1 < args.size()) {
+            float value;
+            try {
+                value = stof(args[i + 1]);
+            } catch (const exception&) {
+                throw invalid_argument(args[i] + " must be a number");
+            }
+            (args[i] == "--target" ? options.targetCalories : options.tolerance) = value;
+            hasTarget = hasTarget || args[i] == "--target";
+            i++;
+        } else if ((args[i] == "--foods" || args[i] == "--servings" || args[i] == "--plans") && i + 1 < args.size()) {
+            size_t value = parseCount(args[i], args[i + 1]);
+            (args[i] == "--foods" ? options.maxFoods : args[i] == "--servings" ? options.maxServings : options.plans) = value;
+            i++;
+        } else if (args[i].rfind("--", 0) == 0) {
+            throw invalid_argument("Usage: " + helpText["plan-meals"]);
+        } else {
+            keywords.push_back(args[i]);
+        }
+    }
+    
+    float dayTarget = 0.0f;
+    float consumed = 0.0f;
+    if (!hasTarget) {
+        dayTarget = userProfile->calculateTargetCalories();
+        consumed = static_cast<float>(logHistory->getDayCalories(currentDate));
+        options.targetCalories = dayTarget - consumed;
+        if (options.targetCalories <= 0.0f) {
+            throw invalid_argument("The calorie target of " + currentDate.toString() +
+                                   " is already reached; give one with --target");
+        }
+    }
+    
+    vector<FoodCalories> foods = foodDb.getFoodCalories(keywords, matchAll);
+    if (foods.empty()) {
+        throw invalid_argument("No foods match the keywords");
+    }
+    MealPlanResult result = MealPlanner::plan(foods, options);
+    
+    ostringstream out;
+    out << TerminalColors::bold("\nMeal Plans for " + to_string(lround(options.targetCalories)) +
+                                " calories (+/- " + to_string(static_cast<int>(options.tolerance)) + "):\n");
+    if (!hasTarget) {
+        out << "Target " << lround(dayTarget) << " minus " << lround(consumed)
+            << " already logged on " << currentDate.toString() << '\n';
+    }
+    if (result.plans.empty() || fabs(result.plans.front().calories - options.targetCalories) > options.tolerance) {
+        out << TerminalColors::warning("No plan within the tolerance" +
+                                       string(result.plans.empty() ? "." : "; the closest found:")) << '\n';
+    }
+    
+    for (size_t i = 0; i < result.plans.size(); i++) {
+        const MealPlan& plan = result.plans[i];
+        int difference = static_cast<int>(lround(plan.calories - options.targetCalories));
+        out << TerminalColors::underline("\nPlan " + to_string(i + 1) + ": " + to_string(static_cast<int>(lround(plan.calories))) +
+                                         " calories (" + (difference >= 0 ? "+" : "") + to_string(difference) + ")") << '\n';
+        for (const auto& [handle, servings] : plan.foods) {
+            auto food = foodDb.getFood(handle);
+            if (!food) {
+                continue;
+            }
+            out << "  " << static_cast<int>(servings) << " x " << left << setw(20) << food->getId()
+                << food->getCaloriesPerServing() << " calories each\n";
+        }
+    }
+    
+    ostringstream summary;
+    summary << "Tried " << result.combinations << " combinations of " << result.candidates << " food(s) in "
+            << fixed << setprecision(2) << result.milliseconds << " ms ("
+            << (result.complete ? "searched all" : result.timedOut ? "time limit reached" : "stopped once enough plans were found")
+            << ").";
+    out << '\n' << TerminalColors::info(summary.str()) << "\n\n";
+    cout << out.str();
+}
+
 /**
  * viewDailyHistory Method
  * @param args Command arguments
- * Shows the history of daily metrics.
+ * Shows the history of daily metrics with the BMR and target calories of each
+ * day, one page at a time.
  */
 void CLI::viewDailyHistory(const vector<string>& args) {
-    User& user = userProfile.getUser();
-    const auto& metrics = user.getDailyMetrics();
+    const size_t PAGE_SIZE = 20;
+    User& user = userProfile->getUser();
+    const MetricSeries& metrics = user.getDailyMetrics();
     
     if (metrics.empty()) {
         cout << TerminalColors::warning("No metrics history available.") << endl;
         return;
     }
     
-    int limit = -1; // Default: show all records
+    // Rows to show; pages are counted from the most recent one
+    size_t pages = (metrics.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t page = 1;
+    size_t begin = 0;
+    size_t end = metrics.size();
+    bool paged = true;
     
     // Parse arguments
     if (args.size() > 1) {
-        if (args[1] == "all") {
-            limit = -1; // Show all
-        } else if (args[1] == "last" && args.size() > 2) {
-            try {
-                limit = stoi(args[2]);
+        try {
+            if (args[1] == "all") {
+                paged = false;
+            } else if (args[1] == "last" && args.size() > 2) {
+                int limit = stoi(args[2]);
                 if (limit <= 0) {
                     throw invalid_argument("Number must be positive");
                 }
-            } catch (const exception&) {
-                throw invalid_argument("Usage: history [all|last N] - N must be a positive number");
+                begin = metrics.size() - min(metrics.size(), static_cast<size_t>(limit));
+                paged = false;
+            } else if (args[1] == "page" && args.size() > 2) {
+                int requested = stoi(args[2]);
+                if (requested <= 0) {
+                    throw invalid_argument("Number must be positive");
+                }
+                page = static_cast<size_t>(requested);
+            } else {
+                throw invalid_argument(args[1]);
             }
+        } catch (const exception&) {
+            throw invalid_argument("Usage: history [all|last N|page N] - N must be a positive number");
+        }
+    }
+    if (paged) {
+        if (page > pages) {
+            throw invalid_argument("Page " + to_string(page) + " does not exist; the history has " +
+                                   to_string(pages) + " page(s)");
         }
+        end = metrics.size() - (page - 1) * PAGE_SIZE;
+        begin = end - min(end, PAGE_SIZE);
     }
     
     cout << TerminalColors::bold("\nDaily Metrics History:\n");
@@ -832,25 +1855,167 @@ void CLI::viewDailyHistory(const vector<string>& args) {
          << setw(20) << "Date" 
          << setw(10) << "Weight" 
          << setw(10) << "Age" 
-         << "Activity Level" << endl;
-    cout << string(60, '-') << endl;
+         << setw(20) << "Activity Level"
+         << setw(10) << "BMR"
+         << "Target" << endl;
+    cout << string(80, '-') << endl;
+    
+    // Calories are computed a chunk of rows at a time, so "all" never copies the whole history
+    const size_t CHUNK_SIZE = 4096;
+    ConstSpan<float> weights = metrics.weights();
+    ConstSpan<uint16_t> ages = metrics.ages();
+    ConstSpan<uint8_t> activityLevels = metrics.activityLevels();
+    for (size_t chunk = begin; chunk < end; chunk += CHUNK_SIZE) {
+        CalorieSeries series = user.getCalorieSeries(chunk, min(end, chunk + CHUNK_SIZE));
+        for (size_t i = 0; i < series.timestamps.size(); i++) {
+            size_t row = chunk + i;
+            cout << left 
+                 << setw(20) << user.getFormattedDate(series.timestamps[i])
+                 << setw(10) << weights[row]
+                 << setw(10) << ages[row]
+                 << setw(20) << User::activityLevelToString(static_cast<User::ActivityLevel>(activityLevels[row]))
+                 << setw(10) << static_cast<int>(series.bmr[i])
+                 << static_cast<int>(series.targetCalories[i]) << endl;
+        }
+    }
     
-    int count = 0;
-    // If limit is set, show only the last 'limit' entries
-    int startIdx = limit > 0 ? max(0, static_cast<int>(metrics.size()) - limit) : 0;
+    string shown = "Showing " + to_string(end - begin) + " of " + to_string(metrics.size()) + " records";
+    if (paged) {
+        shown += " (page " + to_string(page) + " of " + to_string(pages) + ", most recent first";
+        shown += page < pages ? "; 'history page " + to_string(page + 1) + "' for older records)" : ")";
+    }
+    cout << endl << TerminalColors::info(shown + ".") << endl;
+}
+
+/**
+ * createUser Method
+ * @param args Command arguments
+ * Creates an additional user with an empty log.
+ */
+void CLI::createUser(const vector<string>& args) {
+    if (args.size() != 7) {
+        throw invalid_argument("Usage: create-user <user_id> <name> <age> <gender> <height_cm> <weight_kg>");
+    }
+    if (args[1] == "default") {
+        throw invalid_argument("'default' is the name of the default user");
+    }
     
-    for (size_t i = startIdx; i < metrics.size(); i++) {
-        const auto& metric = metrics[i];
-        cout << left 
-             << setw(20) << user.getFormattedDate(metric.timestamp)
-             << setw(10) << metric.weight
-             << setw(10) << metric.age
-             << User::activityLevelToString(static_cast<User::ActivityLevel>(metric.activityLevel)) 
-             << endl;
-        count++;
+    int age;
+    float height, weight;
+    try {
+        age = stoi(args[3]);
+        height = stof(args[5]);
+        weight = stof(args[6]);
+    } catch (const exception&) {
+        throw invalid_argument("Usage: create-user <user_id> <name> <age> <gender> <height_cm> <weight_kg> - age, height and weight must be numbers");
+    }
+    if (age <= 0 || height <= 0 || weight <= 0) {
+        throw invalid_argument("age, height and weight must be positive");
     }
     
-    cout << endl << TerminalColors::info("Showing " + to_string(count) + " of " + to_string(metrics.size()) + " records.") << endl;
+    User user(args[2], age, User::stringToGender(args[4]), height, weight);
+    tenants.create(args[1], user);
+    cout << TerminalColors::success("Created user '" + args[1] + "' (" + args[2] + ").") << endl;
+    cout << "Use 'switch-user " << args[1] << "' to manage their profile and logs; "
+         << "activity level, goal and calorie method can be changed with 'profile'." << endl;
+}
+
+/**
+ * switchUser Method
+ * @param args Command arguments
+ * Selects the user the profile and log commands act on.
+ */
+void CLI::switchUser(const vector<string>& args) {
+    if (args.size() > 2) {
+        throw invalid_argument("Usage: switch-user [user_id]");
+    }
+    selectUser(args.size() == 2 && args[1] != "default" ? args[1] : "");
+    cout << TerminalColors::success("Now managing " + userProfile->getUser().getName() +
+                                    " (" + getCurrentUserId() + ")") << endl;
+}
+
+/**
+ * listUsers Method
+ * @param args Command arguments (unused)
+ * Lists the default user and all additional users.
+ */
+void CLI::listUsers(const vector<string>& args) {
+    (void)args; // Suppress unused parameter warning
+    
+    string current = getCurrentUserId();
+    vector<string> users = tenants.listUsers();
+    users.insert(users.begin(), "default");
+    
+    cout << TerminalColors::bold("\nUsers:\n");
+    for (const auto& userId : users) {
+        bool loaded = userId == "default" || tenants.isLoaded(userId);
+        cout << (userId == current ? "* " : "  ") << left << setw(30) << userId
+             << (loaded ? "loaded" : "") << endl;
+    }
+    
+    TenantCacheStats stats = tenants.getStats();
+    cout << endl << TerminalColors::info(to_string(stats.loaded) + " of " + to_string(stats.capacity) +
+                                        " additional users loaded (" + to_string(stats.hits) + " hits, " +
+                                        to_string(stats.misses) + " misses, " + to_string(stats.evictions) +
+                                        " evictions)") << endl;
+}
+
+/**
+ * setUserCache Method
+ * @param args Command arguments
+ * Shows or changes how many additional users stay loaded.
+ */
+void CLI::setUserCache(const vector<string>& args) {
+    if (args.size() > 2) {
+        throw invalid_argument("Usage: user-cache [users]");
+    }
+    if (args.size() == 2) {
+        size_t users;
+        try {
+            size_t parsed = 0;
+            users = stoul(args[1], &parsed);
+            if (parsed != args[1].size() || users == 0) {
+                throw invalid_argument(args[1]);
+            }
+        } catch (const exception&) {
+            throw invalid_argument("Usage: user-cache [users] - users must be a positive number");
+        }
+        tenants.setCapacity(users);
+    }
+    
+    TenantCacheStats stats = tenants.getStats();
+    cout << "Up to " << TerminalColors::info(to_string(stats.capacity))
+         << " additional users stay loaded; " << stats.loaded << " are loaded now." << endl;
+}
+
+/**
+ * selectUser Method
+ * @param userId An additional user's ID, or empty for the default user
+ * @throws invalid_argument if the user does not exist
+ */
+void CLI::selectUser(const string& userId) {
+    if (userId.empty() || userId == "default") {
+        tenant.reset();
+        userProfile = &UserProfile::getInstance();
+        logHistory = &defaultLogs;
+    } else {
+        if (tenant && tenant->userId == userId) {
+            return;
+        }
+        shared_ptr<Tenant> next = tenants.acquire(userId);
+        tenant = next;
+        userProfile = &tenant->profile;
+        logHistory = &tenant->logHistory;
+    }
+    logHistory->setCurrentDate(currentDate);
+}
+
+/**
+ * getCurrentUserId Method
+ * @return The selected user's ID, "default" for the default user
+ */
+string CLI::getCurrentUserId() const {
+    return tenant ? tenant->userId : "default";
 }
 
 /**
@@ -861,6 +2026,8 @@ void CLI::clearScreen(const vector<string>& args) {
     (void)args; // Suppress unused parameter warning
     
     // ANSI escape code to clear the screen
-    cout << "\033[2J\033[1;1H";
+    if (TerminalColors::isEnabled()) {
+        cout << "\033[2J\033[1;1H";
+    }
     cout << TerminalColors::bold("Screen cleared.") << endl;
 }
\ No newline at end of file
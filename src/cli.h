@@ -11,6 +11,10 @@
  * - Methods for all supported commands (food, log, profile management)
  * - User input parsing and validation
  * - Output formatting utilities
+ * - Non-interactive batch mode emitting one JSON result per command
+ * - Selection of the user whose profile and logs the commands act on
+ * - Saving on a background thread, with a flush before exiting or reloading
+ * - Timing of every command for the stats command (see Metrics)
  * 
  * The CLI class serves as the main interface between the user and the application,
  * translating text commands into actions on the underlying data models.
@@ -24,12 +28,15 @@
 #include <map>
 #include <functional>
 #include <sstream>
+#include <istream>
 #include "models/user.h"
 #include "models/food.h"
 #include "models/log_entry.h"
 #include "manager/food_database.h"
 #include "manager/user_profile.h"
+#include "manager/tenant_manager.h"
 #include "utils/terminal_colors.h"
+#include "utils/background_saver.h"
 
 using namespace std;
 
@@ -39,59 +46,115 @@ using namespace std;
  */
 class CLI {
 public:
-    CLI();
+    // A non-interactive CLI never prompts and prints no terminal formatting
+    explicit CLI(bool interactive = true);
     void run();
+    int runBatch(istream& script, bool save = true);
+    
+    // Single commands with captured output (used by batch and server mode); a
+    // non-empty userId runs the command for that user instead of the selected one
+    json runCommand(const vector<string>& args, const string& userId = "");
+    vector<string> getCommandNames() const;
+    static vector<string> parseCommandLine(const string& line);
+    static size_t parseCount(const string& option, const string& value);
 
 private:
+    // Search results shown when no --limit is given
+    static const size_t SEARCH_PAGE_SIZE = 25;
+    
+    // Seconds between background syncs of the journal unless changed with autosave
+    static const size_t DEFAULT_AUTOSAVE_SECONDS = 5;
+    
     // Command handlers
     using CommandFunc = function<void(const vector<string>&)>;
     map<string, CommandFunc> commands;
     map<string, string> helpText;
     
     // Current date
-    string currentDate;
+    Date currentDate;
+    
+    // Mode, and the stream commands are read from ("log-batch -" reads from it too)
+    // with the number of lines read from it
+    bool interactive;
+    istream* input;
+    size_t inputLine;
+    bool quitRequested;
     
-    // Data managers
+    // Data managers. userProfile and logHistory belong to the selected user: the
+    // default user (data/user.json, data/logs) or an additional one (data/users/<id>)
     FoodDatabase& foodDb;
-    UserProfile& userProfile;
-    LogHistory logHistory;
+    UserProfile* userProfile;
+    LogHistory* logHistory;
+    LogHistory defaultLogs;
+    TenantManager tenants;
+    shared_ptr<Tenant> tenant;
+    
+    // Write-ahead journal of food and log changes
+    Journal journal;
+    
+    // Thread writing the base files and syncing the journal; declared last, so
+    // its remaining jobs run before the data they use is destroyed
+    BackgroundSaver saver;
     
     // Initialize commands
     void registerCommands();
     
     // Helper methods
-    vector<string> parseCommandLine(const string& line);
     void displayHelp(const vector<string>& args);
     bool confirmAction(const string& message);
     
     // Date helper
-    string getCurrentDate() const;
+    Date getCurrentDate() const;
     
     // Food database commands
     void addBasicFood(const vector<string>& args);
     void listFoods(const vector<string>& args);
     void searchFoods(const vector<string>& args);
+    void setSearchCache(const vector<string>& args);
+    void printFoodPage(const string& title, const FoodPage& page, size_t offset, bool showScores);
     void createCompositeFood(const vector<string>& args);
+    void updateBasicFood(const vector<string>& args);
     
     // Log commands
     void addFoodToLog(const vector<string>& args);
     void removeFoodFromLog(const vector<string>& args);
+    void logBatch(const vector<string>& args);
+    LogOperation parseBatchEntry(const vector<string>& parts);
     void viewLog(const vector<string>& args);
+    void viewIngredients(const vector<string>& args);
     void setDate(const vector<string>& args);
     void undoCommand(const vector<string>& args);
     void redoCommand(const vector<string>& args);
+    void setUndoLimit(const vector<string>& args);
+    void setLogCache(const vector<string>& args);
     
     // User profile commands
     void viewProfile(const vector<string>& args);
     void updateProfile(const vector<string>& args);
     void viewCalories(const vector<string>& args);
+    void viewCaloriesRange(const vector<string>& args);
+    void planMeals(const vector<string>& args);
+    void viewTrend(const vector<string>& args);
     void viewDailyHistory(const vector<string>& args);  // New command
     
+    // User management commands
+    void createUser(const vector<string>& args);
+    void switchUser(const vector<string>& args);
+    void listUsers(const vector<string>& args);
+    void setUserCache(const vector<string>& args);
+    void selectUser(const string& userId);
+    string getCurrentUserId() const;
+    
     // Data management commands
     void saveData(const vector<string>& args);
     void loadData(const vector<string>& args);
     void manualSave(const vector<string>& args);  // Add this
     void manualLoad(const vector<string>& args);  // Add this
+    void writeBaseFiles();
+    void replayJournal();
+    void setAutosave(const vector<string>& args);
+    void viewStats(const vector<string>& args);
+    void flushSaves();
     
     // UI commands
     void clearScreen(const vector<string>& args);
@@ -2,12 +2,22 @@
  * @file main.cpp
  * @brief Main entry point for the diet manager application.
  * 
+ * Usage:
+ *   diet_manager                                  Interactive session
+ *   diet_manager --batch [script|-] [--no-save]   Run a command script (standard
+ *                                                 input if none or '-') without
+ *                                                 prompts, printing JSON results
+ *   diet_manager --serve <address> [--workers N]  Serve JSON requests on a Unix
+ *                                                 socket (unix:<path>) or TCP
+ *                                                 port (<host>:<port>, :<port>)
  */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <filesystem>
 #include "cli.h"
+#include "server.h"
 
 /**
  * Create directories if they don't exist
@@ -16,22 +26,80 @@ void ensureDirectoriesExist() {
     std::filesystem::create_directories("data");
 }
 
+/**
+ * Print the command line usage
+ */
+void printUsage() {
+    std::cerr << "Usage: diet_manager [--batch [script|-] [--no-save]]" << std::endl
+              << "       diet_manager --serve <address> [--workers N]" << std::endl;
+}
+
 /**
  * Main function - entry point of the application
  */
 int main(int argc, char* argv[]) {
+    bool batch = false;
+    bool save = true;
+    std::string scriptPath = "-";
+    std::string serveAddress;
+    size_t workers = ThreadPool::defaultThreadCount();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                scriptPath = argv[++i];
+            }
+        } else if (arg == "--no-save") {
+            save = false;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            try {
+                workers = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                workers = 0;
+            }
+            if (workers == 0) {
+                printUsage();
+                return 2;
+            }
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    bool serve = !serveAddress.empty();
+    if ((!save && !batch) || (batch && serve)) {
+        printUsage();
+        return 2;
+    }
+    
     try {
         // Ensure data directory exists
         ensureDirectoriesExist();
         
-        // Custom data paths could be provided as command line args
-        // Not implemented in this version, but could be added
-        (void)argc; // Suppress unused parameter warning
-        (void)argv; // Suppress unused parameter warning
-        
         // Initialize and run the CLI
-        CLI cli;
-        cli.run();
+        CLI cli(!batch && !serve);
+        if (serve) {
+            Server server(cli, serveAddress, workers);
+            server.run();
+            json result = cli.runCommand({"save", "--wait"});
+            if (!result["ok"].get<bool>()) {
+                std::cerr << "Failed to save: " << result["error"].get<std::string>() << std::endl;
+                return 1;
+            }
+        } else if (!batch) {
+            cli.run();
+        } else if (scriptPath == "-") {
+            return cli.runBatch(std::cin, save);
+        } else {
+            std::ifstream script(scriptPath);
+            if (!script.is_open()) {
+                throw std::runtime_error("Cannot open script " + scriptPath);
+            }
+            return cli.runBatch(script, save);
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,122 @@
+/**
+ * @file calorie_graph.cpp
+ * @brief Composite Food Dependency Graph Implementation
+ *
+ * This file implements the CalorieGraph class defined in calorie_graph.h.
+ * It records reverse-dependency edges as composites are created or loaded and
+ * computes the set of composites affected by a change to a single food.
+ *
+ * Key implementations:
+ * - Edge registration for composite foods
+ * - Reachability search over reverse-dependency edges
+ * - Kahn's algorithm restricted to the affected subgraph
+ * - Cycle detection for inconsistent composite definitions
+ */
+
+#include "calorie_graph.h"
+#include "../utils/load_arena.h"
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * CalorieGraph Constructor
+ * @param resource The memory resource of the edge lists
+ */
+CalorieGraph::CalorieGraph(std::pmr::memory_resource* resource) : dependents(resource) {
+}
+
+/**
+ * clear Method
+ * Removes all edges from the graph, freeing their memory.
+ */
+void CalorieGraph::clear() {
+    LoadArena::reset(dependents);
+}
+
+/**
+ * addComposite Method
+ * @param composite The handle of the composite food
+ * @param components The handles of its components
+ * Registers the composite as a dependent of each of its components.
+ */
+void CalorieGraph::addComposite(FoodHandle composite, ConstSpan<FoodHandle> components) {
+    for (FoodHandle component : components) {
+        if (component >= dependents.size()) {
+            dependents.resize(static_cast<size_t>(component) + 1);
+        }
+        dependents[component].push_back(composite);
+    }
+}
+
+/**
+ * getDependents Method
+ * @param food The handle of a food
+ * @return The handles of the composites that use the food directly
+ */
+ConstSpan<FoodHandle> CalorieGraph::getDependents(FoodHandle food) const {
+    if (food >= dependents.size()) {
+        return {};
+    }
+    const std::pmr::vector<FoodHandle>& edges = dependents[food];
+    return {edges.data(), edges.data() + edges.size()};
+}
+
+/**
+ * affectedInTopologicalOrder Method
+ * @param food The handle of the food that changed
+ * @return The handles of all composites that depend on the food, directly or
+ *         through other composites, ordered so that each composite follows its components
+ * @throws runtime_error if the affected composites contain a dependency cycle
+ */
+std::vector<FoodHandle> CalorieGraph::affectedInTopologicalOrder(FoodHandle food) const {
+    // Collect every composite reachable from the changed food
+    std::unordered_set<FoodHandle> affected;
+    std::queue<FoodHandle> pending;
+    pending.push(food);
+    while (!pending.empty()) {
+        FoodHandle current = pending.front();
+        pending.pop();
+        for (FoodHandle dependent : getDependents(current)) {
+            if (dependent == food) {
+                throw std::runtime_error("Cycle detected in composite food dependencies");
+            }
+            if (affected.insert(dependent).second) {
+                pending.push(dependent);
+            }
+        }
+    }
+
+    // Count incoming edges from inside the affected subgraph
+    std::unordered_map<FoodHandle, size_t> inDegree;
+    for (FoodHandle node : affected) {
+        for (FoodHandle dependent : getDependents(node)) {
+            inDegree[dependent]++;
+        }
+    }
+    for (FoodHandle dependent : getDependents(food)) {
+        inDegree[dependent]++;
+    }
+
+    // Kahn's algorithm starting from the changed food
+    std::vector<FoodHandle> order;
+    order.reserve(affected.size());
+    pending.push(food);
+    while (!pending.empty()) {
+        FoodHandle current = pending.front();
+        pending.pop();
+        for (FoodHandle dependent : getDependents(current)) {
+            if (--inDegree[dependent] == 0) {
+                order.push_back(dependent);
+                pending.push(dependent);
+            }
+        }
+    }
+
+    if (order.size() != affected.size()) {
+        throw std::runtime_error("Cycle detected in composite food dependencies");
+    }
+
+    return order;
+}
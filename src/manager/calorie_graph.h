@@ -0,0 +1,51 @@
+/**
+ * @file calorie_graph.h
+ * @brief Composite Food Dependency Graph
+ *
+ * This file defines the CalorieGraph class which tracks which composite foods are
+ * built from which other foods. FoodDatabase uses it to find exactly the composites
+ * whose calories are affected when a food changes, so that only those have to be
+ * recalculated instead of rebuilding every composite.
+ *
+ * Key features:
+ * - Reverse-dependency edges from each component to the composites using it
+ * - Topological ordering of all composites affected by a change
+ * - Cycle detection while ordering affected composites
+ *
+ * Nested recipes share sub-recipes, so the graph is a DAG rather than a tree; the
+ * topological order guarantees every composite is updated after all of its
+ * affected components. The edge lists allocate from a memory resource given at
+ * construction, such as the database's LoadArena.
+ */
+
+#ifndef CALORIE_GRAPH_H
+#define CALORIE_GRAPH_H
+
+#include <vector>
+#include <memory_resource>
+#include "food_store.h"
+
+using namespace std;
+
+/**
+ * CalorieGraph Class
+ * This class maintains the reverse-dependency graph between foods and composites.
+ */
+class CalorieGraph {
+public:
+    explicit CalorieGraph(pmr::memory_resource* resource = pmr::get_default_resource());
+
+    // Graph maintenance
+    void clear();
+    void addComposite(FoodHandle composite, ConstSpan<FoodHandle> components);
+
+    // Queries
+    ConstSpan<FoodHandle> getDependents(FoodHandle food) const;
+    vector<FoodHandle> affectedInTopologicalOrder(FoodHandle food) const;
+
+private:
+    // Component handle -> handles of composites that use it directly
+    pmr::vector<pmr::vector<FoodHandle>> dependents;
+};
+
+#endif // CALORIE_GRAPH_H
@@ -10,23 +10,34 @@
  * - Singleton pattern for global database access
  * - CRUD operations for basic and composite food items
  * - Food searching algorithms with keyword matching
- * - JSON serialization and deserialization
+ * - Reader-writer locking so lookups and searches can run on many threads
+ * - JSON serialization and streaming deserialization
+ * - Dirty tracking and crash-safe rewrites of the database files
+ * - Flat storage with on-demand Food views
+ * - Binary snapshot persistence
+ * - Journaling of modifications and replay of journal records
  * - ID generation and validation
  * - Calorie calculations for composite foods
- * - Data source integration for extensibility
+ * - Dependency-driven recalculation of composite calories
+ * - Data source integration for extensibility, including batched multi-source imports
  * 
  * The implementation supports both basic foods with direct calorie values and
  * composite foods composed of other food items with specific serving quantities.
  */
 
 #include "food_database.h"
+#include "../utils/metrics.h"
+#include "../utils/atomic_file.h"
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
 #include <iomanip>
-#include <regex>
 #include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
+#include <mutex>
 
 /**
  * FoodDatabase getInstance Method
@@ -38,19 +49,47 @@ FoodDatabase& FoodDatabase::getInstance() {
     return instance;
 }
 
+namespace {
+
+/**
+ * pageEnd Function
+ * @param total The number of results
+ * @param limit The maximum number of results on the page (0 for all)
+ * @param offset The number of results before the page
+ * @return The index one past the page's last result (0 if the page is empty)
+ */
+size_t pageEnd(size_t total, size_t limit, size_t offset) {
+    if (offset >= total) {
+        return 0;
+    }
+    return limit == 0 || limit >= total - offset ? total : offset + limit;
+}
+
+} // namespace
+
 /**
  * FoodDatabase Constructor
  * Initializes the database with default paths.
  */
 FoodDatabase::FoodDatabase() 
     : defaultBasicFoodPath("data/basic_food.json"),
-      defaultCompositeFoodPath("data/composite_food.json") {
+      defaultCompositeFoodPath("data/composite_food.json"),
+      defaultSnapshotPath("data/food_db.snap"),
+      savedVersion(0),
+      journal(nullptr),
+      dirty(false),
+      version(0), calorieVersion(0) {
 }
 
 /**
  * FoodDatabase Destructor
+ * Saves unsaved changes. With a journal attached, its owner commits or discards
+ * them instead.
  */
 FoodDatabase::~FoodDatabase() {
+    if (!dirty || journal) {
+        return;
+    }
     try {
         saveToFiles();
     } catch (const std::exception& e) {
@@ -64,21 +103,30 @@ FoodDatabase::~FoodDatabase() {
  * @return A shared pointer to the Food object with the given ID, or nullptr if not found
  */
 std::shared_ptr<Food> FoodDatabase::getFood(const std::string& id) const {
-    auto it = foods.find(id);
-    if (it != foods.end()) {
-        return it->second;
-    }
-    return nullptr;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return store.view(store.find(id));
+}
+
+/**
+ * getFood Method
+ * @param handle The handle of the food ID (see FoodIds)
+ * @return A shared pointer to the Food object with the given handle, or nullptr if not found
+ */
+std::shared_ptr<Food> FoodDatabase::getFood(FoodHandle handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return store.view(handle);
 }
 
 /**
  * getAllFoods Method
- * @return A vector of all Food objects in the database
+ * @return A vector of all Food objects in the database, ordered by ID
  */
 std::vector<std::shared_ptr<Food>> FoodDatabase::getAllFoods() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     std::vector<std::shared_ptr<Food>> result;
-    for (const auto& [_, food] : foods) {
-        result.push_back(food);
+    result.reserve(store.size());
+    for (FoodHandle handle : store.sortedHandles()) {
+        result.push_back(store.view(handle));
     }
     return result;
 }
@@ -87,46 +135,132 @@ std::vector<std::shared_ptr<Food>> FoodDatabase::getAllFoods() const {
  * searchFoods Method
  * @param keywords The keywords to search for
  * @param matchAll Whether all keywords must match (AND) or at least one (OR)
- * @return A vector of Food objects that match the search criteria
+ * @return A vector of Food objects that match the search criteria, ordered by ID
+ * Matching is answered by the inverted keyword index instead of scanning all foods,
+ * or by the search cache when the same query was answered since the last change.
  */
 std::vector<std::shared_ptr<Food>> FoodDatabase::searchFoods(const std::vector<std::string>& keywords, bool matchAll) const {
+    METRICS_TIMER("FoodDatabase::searchFoods");
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<FoodHandle> handles = matchingHandles(keywords, matchAll);
+    
     std::vector<std::shared_ptr<Food>> result;
+    result.reserve(handles.size());
+    for (FoodHandle handle : handles) {
+        result.push_back(store.view(handle));
+    }
     
-    for (const auto& [_, food] : foods) {
-        const std::vector<std::string>& foodKeywords = food->getKeywords();
-        
-        bool matches = matchAll;
-        for (const auto& keyword : keywords) {
-            // Convert to lowercase for case-insensitive search
-            std::string lowerKeyword = keyword;
-            std::transform(lowerKeyword.begin(), lowerKeyword.end(), lowerKeyword.begin(), ::tolower);
-            
-            bool keywordFound = false;
-            for (const auto& foodKeyword : foodKeywords) {
-                std::string lowerFoodKeyword = foodKeyword;
-                std::transform(lowerFoodKeyword.begin(), lowerFoodKeyword.end(), lowerFoodKeyword.begin(), ::tolower);
-                
-                if (lowerFoodKeyword.find(lowerKeyword) != std::string::npos) {
-                    keywordFound = true;
-                    break;
-                }
-            }
-            
-            if (matchAll && !keywordFound) {
-                matches = false;
-                break;
-            } else if (!matchAll && keywordFound) {
-                matches = true;
-                break;
-            }
-        }
-        
-        if (matches || keywords.empty()) {
-            result.push_back(food);
+    return result;
+}
+
+/**
+ * rankFoods Method
+ * @param keywords The keywords to search for
+ * @param matchAll Whether all keywords must match (AND) or at least one (OR)
+ * @param limit The maximum number of results (0 for all)
+ * @param offset The number of best results to skip
+ * @return The matches ranked [offset, offset + limit), best first, with the total
+ *         number of matches
+ * Only the best offset + limit matches are kept, in a bounded heap, so neither the
+ * ranking nor the construction of Food objects touches the other matches. Equal
+ * scores are ordered by ID.
+ */
+FoodPage FoodDatabase::rankFoods(const std::vector<std::string>& keywords, bool matchAll,
+                                 size_t limit, size_t offset) const {
+    METRICS_TIMER("FoodDatabase::rankFoods");
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    // Ranking needs no ID order, so matches not cached yet are not sorted by ID
+    std::string key = SearchCache::makeKey(keywords, matchAll);
+    std::vector<FoodHandle> handles;
+    bool byId = false;
+    if (!searchCache.find(key, version, handles, byId)) {
+        handles = searchIndex.search(keywords, matchAll);
+        searchCache.insert(key, version, handles, false);
+    }
+    
+    std::vector<std::string> queries;
+    queries.reserve(keywords.size());
+    for (const auto& keyword : keywords) {
+        queries.push_back(SearchIndex::normalize(keyword));
+    }
+    
+    // (score, handle); ranksBefore puts the worst kept match at the front of the heap
+    using Candidate = std::pair<float, FoodHandle>;
+    auto ranksBefore = [this](const Candidate& a, const Candidate& b) {
+        return a.first != b.first ? a.first > b.first : store.getId(a.second) < store.getId(b.second);
+    };
+    size_t keep = pageEnd(handles.size(), limit, offset);
+    std::vector<Candidate> best;
+    best.reserve(keep);
+    for (size_t i = 0; i < handles.size() && keep > 0; i++) {
+        Candidate candidate(SearchIndex::score(queries, store.getKeywords(handles[i])), handles[i]);
+        if (best.size() < keep) {
+            best.push_back(candidate);
+            std::push_heap(best.begin(), best.end(), ranksBefore);
+        } else if (ranksBefore(candidate, best.front())) {
+            std::pop_heap(best.begin(), best.end(), ranksBefore);
+            best.back() = candidate;
+            std::push_heap(best.begin(), best.end(), ranksBefore);
         }
     }
+    std::sort_heap(best.begin(), best.end(), ranksBefore);
     
-    return result;
+    FoodPage page;
+    page.total = handles.size();
+    for (size_t i = offset; i < best.size(); i++) {
+        page.foods.push_back({store.view(best[i].second), best[i].first});
+    }
+    return page;
+}
+
+/**
+ * getFoodPage Method
+ * @param limit The maximum number of foods (0 for all)
+ * @param offset The number of foods to skip
+ * @return The foods [offset, offset + limit) in ID order, with the total number of foods
+ */
+FoodPage FoodDatabase::getFoodPage(size_t limit, size_t offset) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const std::vector<FoodHandle>& handles = store.sortedHandles();
+    FoodPage page;
+    page.total = handles.size();
+    size_t end = pageEnd(handles.size(), limit, offset);
+    for (size_t i = offset; i < end; i++) {
+        page.foods.push_back({store.view(handles[i]), 0.0f});
+    }
+    return page;
+}
+
+/**
+ * matchingHandles Method
+ * @param keywords The keywords to search for
+ * @param matchAll Whether all keywords must match (AND) or at least one (OR)
+ * @return The handles of the matching foods, ordered by ID
+ * The caller holds the reader lock, so the version cannot change meanwhile. The
+ * search cache answers queries repeated since the last change; matches cached by
+ * a ranked search are sorted by ID here once.
+ */
+std::vector<FoodHandle> FoodDatabase::matchingHandles(const std::vector<std::string>& keywords, bool matchAll) const {
+    std::string key = SearchCache::makeKey(keywords, matchAll);
+    std::vector<FoodHandle> handles;
+    bool byId = false;
+    if (!searchCache.find(key, version, handles, byId)) {
+        handles = searchIndex.search(keywords, matchAll);
+    }
+    if (!byId) {
+        // Resolve the names once rather than in every comparison
+        std::vector<std::pair<const std::string*, FoodHandle>> byId;
+        byId.reserve(handles.size());
+        for (FoodHandle handle : handles) {
+            byId.emplace_back(&store.getId(handle), handle);
+        }
+        std::sort(byId.begin(), byId.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+        for (size_t i = 0; i < byId.size(); i++) {
+            handles[i] = byId[i].second;
+        }
+        searchCache.insert(key, version, handles, true);
+    }
+    return handles;
 }
 
 /**
@@ -136,10 +270,65 @@ std::vector<std::shared_ptr<Food>> FoodDatabase::searchFoods(const std::vector<s
  * @param calories The calories per serving
  */
 void FoodDatabase::addBasicFood(const std::string& id, const std::vector<std::string>& keywords, float calories) {
-    if (foods.find(id) != foods.end()) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (store.contains(id)) {
         throw std::invalid_argument("Food with ID '" + id + "' already exists");
     }
-    foods[id] = std::make_shared<BasicFood>(id, keywords, calories);
+    journalFood(insertBasicFood(id, keywords, calories));
+    markModified();
+}
+
+/**
+ * getIngredients Method
+ * @param id The ID of a food
+ * @return The basic foods in one serving of the food with their servings, sorted
+ *         by handle: the food itself for a basic food, nothing for an unknown ID
+ */
+std::vector<FoodServings> FoodDatabase::getIngredients(const std::string& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    FoodHandle handle = store.find(id);
+    if (!store.contains(handle)) {
+        return {};
+    }
+    if (!store.isComposite(handle)) {
+        return {{handle, 1.0f}};
+    }
+    ConstSpan<FoodServings> expansion = ingredients.getIngredients(handle);
+    return std::vector<FoodServings>(expansion.begin(), expansion.end());
+}
+
+/**
+ * sumIngredients Method
+ * @param servings Servings of foods, e.g. the entries of one or more daily logs
+ * @return The basic foods they contain with their total servings, sorted by handle
+ * Unknown foods are skipped.
+ */
+std::vector<FoodServings> FoodDatabase::sumIngredients(ConstSpan<FoodServings> servings) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<FoodServings> parts;
+    for (const auto& [handle, amount] : servings) {
+        if (!store.contains(handle)) {
+            continue;
+        }
+        if (!store.isComposite(handle)) {
+            parts.emplace_back(handle, amount);
+            continue;
+        }
+        for (const auto& [basic, perServing] : ingredients.getIngredients(handle)) {
+            parts.emplace_back(basic, perServing * amount);
+        }
+    }
+    
+    std::sort(parts.begin(), parts.end(), [](const FoodServings& a, const FoodServings& b) { return a.first < b.first; });
+    std::vector<FoodServings> result;
+    for (const FoodServings& part : parts) {
+        if (!result.empty() && result.back().first == part.first) {
+            result.back().second += part.second;
+        } else {
+            result.push_back(part);
+        }
+    }
+    return result;
 }
 
 /**
@@ -154,14 +343,49 @@ std::string FoodDatabase::addBasicFood(const std::vector<std::string>& keywords,
     }
     
     // Use the first keyword as the base for ID generation
+    std::unique_lock<std::shared_mutex> lock(mutex);
     std::string id = generateFoodId(keywords[0]);
-    
-    // Call the original method with the generated ID
-    addBasicFood(id, keywords, calories);
+    journalFood(insertBasicFood(id, keywords, calories));
+    markModified();
     
     return id;
 }
 
+/**
+ * addBasicFoods Method (Autogenerated ID bulk version)
+ * @param foods The keywords and calories per serving of each new food
+ * @return The generated IDs, in the order of the input
+ * All IDs are generated in one pass under a single acquisition of the writer
+ * lock. The input is validated first, so either all foods are added or none.
+ */
+std::vector<std::string> FoodDatabase::addBasicFoods(const std::vector<std::pair<std::vector<std::string>, float>>& foods) {
+    for (const auto& [keywords, _] : foods) {
+        if (keywords.empty()) {
+            throw std::invalid_argument("At least one keyword must be provided");
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::string> ids;
+    std::vector<json> records;
+    ids.reserve(foods.size());
+    for (const auto& [keywords, calories] : foods) {
+        ids.push_back(generateFoodId(keywords[0]));
+        FoodHandle handle = insertBasicFood(ids.back(), keywords, calories);
+        if (journal) {
+            records.push_back(foodJournalRecord(handle));
+        }
+    }
+    if (journal) {
+        journal->append(records);
+    }
+    if (!ids.empty()) {
+        markModified();
+    }
+    
+    return ids;
+}
+
 /**
  * createCompositeFood Method
  * @param id The ID of the new composite food
@@ -170,28 +394,37 @@ std::string FoodDatabase::addBasicFood(const std::vector<std::string>& keywords,
  */
 void FoodDatabase::createCompositeFood(const std::string& id, const std::vector<std::string>& keywords, 
                                       const std::map<std::string, float>& components) {
-    if (foods.find(id) != foods.end()) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    buildCompositeFood(id, keywords, components);
+}
+
+/**
+ * buildCompositeFood Method
+ * @param id The ID of the new composite food
+ * @param keywords The keywords for searching
+ * @param components A map of food IDs to servings
+ * Validates the ID and components and stores the composite. The caller holds the writer lock.
+ */
+void FoodDatabase::buildCompositeFood(const std::string& id, const std::vector<std::string>& keywords,
+                                     const std::map<std::string, float>& components) {
+    if (store.contains(id)) {
         throw std::invalid_argument("Food with ID '" + id + "' already exists");
     }
     
     // Check that all component foods exist
-    for (const auto& [compId, _] : components) {
-        if (foods.find(compId) == foods.end()) {
+    std::vector<std::pair<FoodHandle, float>> componentHandles;
+    componentHandles.reserve(components.size());
+    for (const auto& [compId, servings] : components) {
+        FoodHandle handle = store.find(compId);
+        if (!store.contains(handle)) {
             throw std::invalid_argument("Component food '" + compId + "' does not exist");
         }
-    }
-    
-    auto compositeFood = std::make_shared<CompositeFood>(id, keywords);
-    
-    // Add components and calculate total calories
-    for (const auto& [compId, servings] : components) {
-        compositeFood->addComponent(compId, servings);
+        componentHandles.emplace_back(handle, servings);
     }
     
     float totalCalories = calculateCompositeFoodCalories(components);
-    compositeFood->setTotalCalories(totalCalories);
-    
-    foods[id] = compositeFood;
+    journalFood(insertCompositeFood(id, keywords, componentHandles, totalCalories));
+    markModified();
 }
 
 /**
@@ -207,14 +440,84 @@ std::string FoodDatabase::createCompositeFood(const std::vector<std::string>& ke
     }
     
     // Use the first keyword as the base for ID generation
+    std::unique_lock<std::shared_mutex> lock(mutex);
     std::string id = generateFoodId(keywords[0]);
-    
-    // Call the original method with the generated ID
-    createCompositeFood(id, keywords, components);
+    buildCompositeFood(id, keywords, components);
     
     return id;
 }
 
+/**
+ * updateBasicFood Method
+ * @param id The ID of the basic food to update
+ * @param calories The new calories per serving
+ * @return The number of composite foods whose calories were recalculated
+ */
+size_t FoodDatabase::updateBasicFood(const std::string& id, float calories) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    FoodHandle handle = store.find(id);
+    if (!store.contains(handle)) {
+        throw std::invalid_argument("Food with ID '" + id + "' does not exist");
+    }
+    if (store.isComposite(handle)) {
+        throw std::invalid_argument("Food '" + id + "' is a composite food; its calories are derived from its components");
+    }
+    
+    float delta = calories - store.getCalories(handle);
+    store.setCalories(handle, calories);
+    markModified();
+    if (journal) {
+        journal->append(json{{"op", "food-update"}, {"id", id}, {"calories", calories}});
+    }
+    
+    try {
+        return propagateCalorieChange(handle, delta);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Cannot update '" + id + "': " + e.what());
+    }
+}
+
+/**
+ * propagateCalorieChange Method
+ * @param handle The handle of the food whose calories changed
+ * @param delta The change in calories per serving of that food
+ * @return The number of composite foods that were updated
+ * Walks the composites that depend on the food in topological order and applies
+ * the change scaled by servings. Applying deltas rather than summing components
+ * from scratch keeps contributions of components that are not in the database.
+ */
+size_t FoodDatabase::propagateCalorieChange(FoodHandle handle, float delta) {
+    if (delta == 0.0f) {
+        return 0;
+    }
+    calorieVersion++;
+    
+    std::unordered_map<FoodHandle, float> deltas = {{handle, delta}};
+    size_t updated = 0;
+    
+    for (FoodHandle composite : calorieGraph.affectedInTopologicalOrder(handle)) {
+        if (!store.isComposite(composite)) {
+            continue;
+        }
+        
+        ConstSpan<FoodHandle> componentFoods = store.getComponentFoods(composite);
+        ConstSpan<float> componentServings = store.getComponentServings(composite);
+        float compositeDelta = 0.0f;
+        for (size_t i = 0; i < componentFoods.size(); i++) {
+            auto it = deltas.find(componentFoods[i]);
+            if (it != deltas.end()) {
+                compositeDelta += it->second * componentServings[i];
+            }
+        }
+        
+        store.setCalories(composite, store.getCalories(composite) + compositeDelta);
+        deltas[composite] = compositeDelta;
+        updated++;
+    }
+    
+    return updated;
+}
+
 /**
  * generateFoodId Method
  * @param baseKeyword The base keyword to use for ID generation
@@ -234,8 +537,12 @@ std::string FoodDatabase::generateFoodId(const std::string& baseKeyword) {
         return baseId;
     }
     
-    // If not unique, append a number until we find a unique ID
-    int counter = 1;
+    // If not unique, continue after the highest suffix in use for this base.
+    // The check only repeats when an ID of another base happens to collide.
+    size_t& counter = nextIdSuffix[baseId];
+    if (counter == 0) {
+        counter = 1;
+    }
     std::string uniqueId;
     
     do {
@@ -246,6 +553,28 @@ std::string FoodDatabase::generateFoodId(const std::string& baseKeyword) {
     return uniqueId;
 }
 
+/**
+ * noteIdSuffix Method
+ * @param id The ID of a food added to the database
+ * Records a numeric suffix of the ID so generateFoodId never probes suffixes
+ * that are already taken. Called for every inserted food, so loading the
+ * database rebuilds the table.
+ */
+void FoodDatabase::noteIdSuffix(const std::string& id) {
+    size_t digits = id.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(id[digits - 1]))) {
+        digits--;
+    }
+    // No suffix, no base, or too long to be one we generated
+    if (digits == id.size() || digits == 0 || id.size() - digits > 18) {
+        return;
+    }
+    
+    size_t suffix = std::stoull(id.substr(digits));
+    size_t& counter = nextIdSuffix[id.substr(0, digits)];
+    counter = std::max(counter, suffix + 1);
+}
+
 /**
  * sanitizeForId Method
  * @param input The string to sanitize
@@ -253,25 +582,24 @@ std::string FoodDatabase::generateFoodId(const std::string& baseKeyword) {
  */
 std::string FoodDatabase::sanitizeForId(const std::string& input) {
     std::string result;
+    result.reserve(input.size());
     
-    // Convert to lowercase
+    // Single pass: lowercase alphanumerics, collapse separators into one underscore
     for (char c : input) {
-        if (std::isalnum(c)) {
-            result += std::tolower(c);
+        unsigned char uc = static_cast<unsigned char>(c);
+        if (std::isalnum(uc)) {
+            result += static_cast<char>(std::tolower(uc));
         } else if (c == ' ' || c == '-' || c == '_') {
-            // Replace spaces, hyphens, and underscores with underscores
-            result += '_';
+            // Replace spaces, hyphens, and underscores with underscores,
+            // skipping leading and repeated ones
+            if (!result.empty() && result.back() != '_') {
+                result += '_';
+            }
         }
         // Ignore other non-alphanumeric characters
     }
     
-    // Replace multiple consecutive underscores with a single one
-    result = std::regex_replace(result, std::regex("_+"), "_");
-    
-    // Remove leading and trailing underscores
-    if (!result.empty() && result.front() == '_') {
-        result.erase(0, 1);
-    }
+    // Remove a trailing underscore
     if (!result.empty() && result.back() == '_') {
         result.pop_back();
     }
@@ -279,27 +607,167 @@ std::string FoodDatabase::sanitizeForId(const std::string& input) {
     return result;
 }
 
+/**
+ * insertBasicFood Method
+ * @param id The ID of the new food
+ * @param keywords The keywords for searching, moved into the store
+ * @param calories The calories per serving
+ * @return The handle of the stored food
+ */
+FoodHandle FoodDatabase::insertBasicFood(const std::string& id, std::vector<std::string> keywords, float calories) {
+    size_t knownIds = store.handleCount();
+    FoodHandle handle = store.addBasic(id, std::move(keywords), calories);
+    indexFood(handle, knownIds);
+    return handle;
+}
+
+/**
+ * insertCompositeFood Method
+ * @param id The ID of the new composite food
+ * @param keywords The keywords for searching, moved into the store
+ * @param components Handles of the component foods with their servings
+ * @param calories The total calories per serving
+ * @return The handle of the stored food
+ */
+FoodHandle FoodDatabase::insertCompositeFood(const std::string& id, std::vector<std::string> keywords,
+                                             const std::vector<std::pair<FoodHandle, float>>& components, float calories) {
+    size_t knownIds = store.handleCount();
+    FoodHandle handle = store.addComposite(id, std::move(keywords), components, calories);
+    indexFood(handle, knownIds);
+    return handle;
+}
+
+/**
+ * indexFood Method
+ * @param handle The handle of a newly stored food
+ * @param knownIds The number of food IDs interned before the food was stored
+ * Registers the food's keywords with the search index, records composite
+ * dependencies in the calorie graph and notes the ID's numeric suffix. An ID
+ * interned before may be logged without calories so far, which the food changes.
+ */
+void FoodDatabase::indexFood(FoodHandle handle, size_t knownIds) {
+    if (handle < knownIds) {
+        calorieVersion++;
+    }
+    noteIdSuffix(store.getId(handle));
+    searchIndex.addDocument(handle, store.getKeywords(handle));
+    ingredients.addFood(handle, !calorieGraph.getDependents(handle).empty());
+    if (store.isComposite(handle)) {
+        calorieGraph.addComposite(handle, store.getComponentFoods(handle));
+    }
+}
+
+/**
+ * foodJournalRecord Method
+ * @param handle The handle of a stored food
+ * @return A journal record that adds the food with its current data
+ */
+json FoodDatabase::foodJournalRecord(FoodHandle handle) const {
+    FoodEntry food = store.entry(handle);
+    json record;
+    record["op"] = "food-add";
+    record["food"] = food.composite ? compositeFoodToJson(food) : basicFoodToJson(food);
+    return record;
+}
+
+/**
+ * journalFood Method
+ * @param handle The handle of a newly stored food
+ * Appends the food to the journal, if one is attached. The caller holds the writer lock.
+ */
+void FoodDatabase::journalFood(FoodHandle handle) {
+    if (journal) {
+        journal->append(foodJournalRecord(handle));
+    }
+}
+
 /**
  * isIdUnique Method
  * @param id The ID to check
  * @return True if the ID is unique, false otherwise
  */
 bool FoodDatabase::isIdUnique(const std::string& id) const {
-    return foods.find(id) == foods.end();
+    return !store.contains(id);
+}
+
+/**
+ * clearFoods Method
+ * Removes all foods and the derived indexes, and releases the arena they used.
+ */
+void FoodDatabase::clearFoods() {
+    version++;
+    calorieVersion++;
+    searchCache.clear();
+    store.clear();
+    searchIndex.clear();
+    calorieGraph.clear();
+    catalogArena.release();
+    ingredients.clear();
+    nextIdSuffix.clear();
+    lastLoadStats.clear();
+}
+
+/**
+ * calculateTotalCalories Method
+ * @param servings A map of food IDs to servings, such as a day's log
+ * @return The total calories of the servings; unknown foods count as zero
+ */
+float FoodDatabase::calculateTotalCalories(const std::map<std::string, float>& servings) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return calculateCompositeFoodCalories(servings);
+}
+
+/**
+ * calculateTotalCalories Method
+ * @param servings Food handles and servings, such as a day's log entries
+ * @return The total calories of the servings; unknown foods count as zero
+ * The handles index the calorie column directly, so no food ID is hashed.
+ */
+float FoodDatabase::calculateTotalCalories(ConstSpan<FoodServings> servings) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    float totalCalories = 0.0f;
+    for (const auto& [handle, count] : servings) {
+        if (store.contains(handle)) {
+            totalCalories += store.getCalories(handle) * count;
+        }
+    }
+    return totalCalories;
+}
+
+/**
+ * getFoodCalories Method
+ * @param keywords The keywords foods must match; empty for all foods
+ * @param matchAll Whether all keywords must match (AND) or at least one (OR)
+ * @return The handles and calories per serving of the foods, ordered by ID
+ */
+std::vector<FoodCalories> FoodDatabase::getFoodCalories(const std::vector<std::string>& keywords, bool matchAll) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<FoodHandle> matches;
+    if (!keywords.empty()) {
+        matches = matchingHandles(keywords, matchAll);
+    }
+    const std::vector<FoodHandle>& handles = keywords.empty() ? store.sortedHandles() : matches;
+    std::vector<FoodCalories> foods;
+    foods.reserve(handles.size());
+    for (FoodHandle handle : handles) {
+        foods.push_back({handle, store.getCalories(handle)});
+    }
+    return foods;
 }
 
 /**
  * calculateCompositeFoodCalories Method
  * @param components A map of food IDs to servings
  * @return The total calories for the composite food
+ * The caller holds the lock.
  */
-float FoodDatabase::calculateCompositeFoodCalories(const std::map<std::string, float>& components) {
+float FoodDatabase::calculateCompositeFoodCalories(const std::map<std::string, float>& components) const {
     float totalCalories = 0.0f;
     
     for (const auto& [compId, servings] : components) {
-        auto compFood = getFood(compId);
-        if (compFood) {
-            totalCalories += compFood->getCaloriesPerServing() * servings;
+        FoodHandle handle = store.find(compId);
+        if (store.contains(handle)) {
+            totalCalories += store.getCalories(handle) * servings;
         }
     }
     
@@ -310,41 +778,98 @@ float FoodDatabase::calculateCompositeFoodCalories(const std::map<std::string, f
  * saveToFiles Method
  * @param basicFoodPath The path to save basic foods to (uses default if empty)
  * @param compositeFoodPath The path to save composite foods to (uses default if empty)
+ * Each file is written to a temporary file that is renamed into place, so a crash
+ * never leaves a truncated database behind.
  */
 void FoodDatabase::saveToFiles(const std::string& basicFoodPath, const std::string& compositeFoodPath) {
+    METRICS_TIMER("FoodDatabase::saveToFiles");
     std::string bPath = basicFoodPath.empty() ? defaultBasicFoodPath : basicFoodPath;
     std::string cPath = compositeFoodPath.empty() ? defaultCompositeFoodPath : compositeFoodPath;
+    bool defaultFiles = basicFoodPath.empty() && compositeFoodPath.empty();
+    
+    // Saving only reads the database; concurrent saves are serialized by saveMutex
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    
+    // Keep the startup snapshot in sync with the default database files
+    writeFiles(store, bPath, cPath, defaultFiles ? defaultSnapshotPath : "");
+    if (defaultFiles) {
+        savedVersion = version;
+        dirty = false;
+    }
+}
+
+/**
+ * prepareSave Method
+ * @return A job writing the default files from a copy of the foods taken now, or
+ *         nullptr if nothing changed since they were last written
+ * Copying the flat columns is much cheaper than serializing them, so the job can
+ * run on another thread while the database keeps changing. The database counts
+ * as saved once the copy is taken; if the job fails, it is marked changed again.
+ * A job finishing after a newer save leaves the files alone.
+ */
+std::function<void()> FoodDatabase::prepareSave() {
+    METRICS_TIMER("FoodDatabase::prepareSave");
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (!dirty) {
+        return nullptr;
+    }
+    auto foods = std::make_shared<const FoodStore>(store);
+    uint64_t copiedVersion = version;
+    dirty = false;
     
+    return [this, foods, copiedVersion]() {
+        std::lock_guard<std::mutex> saveLock(saveMutex);
+        if (copiedVersion <= savedVersion) {
+            return;
+        }
+        try {
+            writeFiles(*foods, defaultBasicFoodPath, defaultCompositeFoodPath, defaultSnapshotPath);
+            savedVersion = copiedVersion;
+        } catch (...) {
+            dirty = true;
+            throw;
+        }
+    };
+}
+
+/**
+ * writeFiles Method
+ * @param foods The foods to write: the database's store or a copy of it
+ * @param basicFoodPath The path to save basic foods to
+ * @param compositeFoodPath The path to save composite foods to
+ * @param snapshotPath The path of the binary snapshot to write too, or empty
+ * The caller holds saveMutex, and the reader lock if foods is the database's store.
+ */
+void FoodDatabase::writeFiles(const FoodStore& foods, const std::string& basicFoodPath,
+                              const std::string& compositeFoodPath, const std::string& snapshotPath) const {
+    METRICS_TIMER("FoodDatabase::writeFiles");
     try {
         // Save basic foods
-        std::ofstream bFile(bPath);
-        if (!bFile.is_open()) {
-            throw std::runtime_error("Failed to open file for writing: " + bPath);
-        }
-        
-        json basicFoodsJson = json::array();
-        for (const auto& [_, food] : foods) {
-            if (!food->isComposite()) {
-                basicFoodsJson.push_back(basicFoodToJson(dynamic_cast<const BasicFood*>(food.get())));
+        AtomicFile::write(basicFoodPath, [this, &foods](std::ostream& out) {
+            json basicFoodsJson = json::array();
+            for (FoodHandle handle : foods.sortedHandles()) {
+                if (!foods.isComposite(handle)) {
+                    basicFoodsJson.push_back(basicFoodToJson(foods.entry(handle)));
+                }
             }
-        }
-        bFile << std::setw(4) << basicFoodsJson << std::endl;
-        bFile.close();
+            out << std::setw(4) << basicFoodsJson << std::endl;
+        });
         
         // Save composite foods
-        std::ofstream cFile(cPath);
-        if (!cFile.is_open()) {
-            throw std::runtime_error("Failed to open file for writing: " + cPath);
-        }
-        
-        json compositeFoodsJson = json::array();
-        for (const auto& [_, food] : foods) {
-            if (food->isComposite()) {
-                compositeFoodsJson.push_back(compositeFoodToJson(dynamic_cast<const CompositeFood*>(food.get())));
+        AtomicFile::write(compositeFoodPath, [this, &foods](std::ostream& out) {
+            json compositeFoodsJson = json::array();
+            for (FoodHandle handle : foods.sortedHandles()) {
+                if (foods.isComposite(handle)) {
+                    compositeFoodsJson.push_back(compositeFoodToJson(foods.entry(handle)));
+                }
             }
+            out << std::setw(4) << compositeFoodsJson << std::endl;
+        });
+        
+        if (!snapshotPath.empty()) {
+            writeSnapshot(snapshotPath, foods);
         }
-        cFile << std::setw(4) << compositeFoodsJson << std::endl;
-        cFile.close();
     } catch (const std::exception& e) {
         throw std::runtime_error("Error saving food database: " + std::string(e.what()));
     }
@@ -354,52 +879,309 @@ void FoodDatabase::saveToFiles(const std::string& basicFoodPath, const std::stri
  * loadFromFiles Method
  * @param basicFoodPath The path to load basic foods from (uses default if empty)
  * @param compositeFoodPath The path to load composite foods from (uses default if empty)
+ * Files are streamed record by record; per-file timings are available afterwards
+ * through getLastLoadStats. When loading the default files and the binary snapshot
+ * is at least as new as both, the snapshot is read instead.
  */
 void FoodDatabase::loadFromFiles(const std::string& basicFoodPath, const std::string& compositeFoodPath) {
+    METRICS_TIMER("FoodDatabase::loadFromFiles");
     std::string bPath = basicFoodPath.empty() ? defaultBasicFoodPath : basicFoodPath;
     std::string cPath = compositeFoodPath.empty() ? defaultCompositeFoodPath : compositeFoodPath;
     
-    foods.clear();
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    
+    // Loaded contents match the files; loading other files leaves changes to save
+    dirty = !(basicFoodPath.empty() && compositeFoodPath.empty());
+    
+    if (basicFoodPath.empty() && compositeFoodPath.empty() && isSnapshotFresh()) {
+        try {
+            readSnapshot(defaultSnapshotPath);
+            return;
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring food snapshot: " << e.what() << std::endl;
+        }
+    }
+    
+    clearFoods();
     
     try {
         // Load basic foods first
-        std::ifstream bFile(bPath);
-        if (bFile.is_open()) {
-            json basicFoodsJson;
-            bFile >> basicFoodsJson;
-            bFile.close();
-            
-            if (basicFoodsJson.is_array()) {
-                for (const auto& foodJson : basicFoodsJson) {
-                    auto food = basicFoodFromJson(foodJson);
-                    if (food) {
-                        foods[food->getId()] = food;
-                    }
-                }
+        loadFoodFile(bPath, [this](FoodRecord& record) {
+            if (!store.contains(record.id)) {
+                insertBasicFood(record.id, std::move(record.keywords), record.calories);
             }
-        }
+        });
         
-        // Then load composite foods (which might reference basic foods)
-        std::ifstream cFile(cPath);
-        if (cFile.is_open()) {
-            json compositeFoodsJson;
-            cFile >> compositeFoodsJson;
-            cFile.close();
-            
-            if (compositeFoodsJson.is_array()) {
-                for (const auto& foodJson : compositeFoodsJson) {
-                    auto food = compositeFoodFromJson(foodJson);
-                    if (food) {
-                        foods[food->getId()] = food;
-                    }
-                }
+        // Then load composite foods (components may reference foods that are missing)
+        std::vector<std::pair<FoodHandle, float>> components;
+        loadFoodFile(cPath, [this, &components](FoodRecord& record) {
+            if (store.contains(record.id)) {
+                return;
             }
-        }
+            components.clear();
+            for (const auto& [compId, servings] : record.components) {
+                components.emplace_back(store.intern(compId), servings);
+            }
+            insertCompositeFood(record.id, std::move(record.keywords), components, record.calories);
+        });
     } catch (const std::exception& e) {
         throw std::runtime_error("Error loading food database: " + std::string(e.what()));
     }
 }
 
+/**
+ * loadFoodFile Method
+ * @param path The path of the food file to stream
+ * @param handler The callback building a food from each record
+ * Missing files are skipped. The time spent on the file is recorded in lastLoadStats.
+ */
+void FoodDatabase::loadFoodFile(const std::string& path, const FoodJsonReader::RecordHandler& handler) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t count = FoodJsonReader::read(file, handler);
+    auto end = std::chrono::steady_clock::now();
+    
+    double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    lastLoadStats.push_back({path, count, milliseconds});
+}
+
+/**
+ * getLastLoadStats Method
+ * @return Timing information for each file read by the last loadFromFiles call
+ */
+const std::vector<FoodFileLoadStats>& FoodDatabase::getLastLoadStats() const {
+    return lastLoadStats;
+}
+
+/**
+ * markModified Method
+ * Records a change to the stored foods. The caller holds the writer lock.
+ */
+void FoodDatabase::markModified() {
+    dirty = true;
+    version++;
+}
+
+/**
+ * setSearchCacheCapacity Method
+ * @param queries The maximum number of cached search queries (0 disables the cache)
+ */
+void FoodDatabase::setSearchCacheCapacity(size_t queries) {
+    searchCache.setCapacity(queries);
+}
+
+/**
+ * getSearchCacheStats Method
+ * @return The counters of the search cache
+ */
+SearchCacheStats FoodDatabase::getSearchCacheStats() const {
+    return searchCache.getStats();
+}
+
+/**
+ * getVersion Method
+ * @return A counter that changes whenever foods are added, updated or reloaded
+ * Callers caching values derived from the database compare it to detect changes.
+ */
+uint64_t FoodDatabase::getVersion() const {
+    return version;
+}
+
+/**
+ * getCalorieVersion Method
+ * @return A counter that changes whenever the calories of a food ID that may be
+ *         logged change: calorie updates, reloads and foods added under an ID
+ *         that was referenced before
+ * Adding a food under a new ID leaves it as is, since no log can refer to it yet.
+ */
+uint64_t FoodDatabase::getCalorieVersion() const {
+    return calorieVersion;
+}
+
+/**
+ * setArenaLoading Method
+ * @param enabled True to keep the keyword text, the search index and the
+ *                calorie graph in an arena, false to allocate them from the heap
+ * The current foods keep their memory; the mode applies from the next load.
+ */
+void FoodDatabase::setArenaLoading(bool enabled) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    catalogArena.setEnabled(enabled);
+}
+
+/**
+ * isArenaLoading Method
+ * @return Whether the index of the loaded foods is kept in an arena
+ */
+bool FoodDatabase::isArenaLoading() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return catalogArena.isEnabled();
+}
+
+/**
+ * isDirty Method
+ * @return True if the database changed since the default files were last written or loaded
+ */
+bool FoodDatabase::isDirty() const {
+    return dirty;
+}
+
+/**
+ * saveSnapshot Method
+ * @param snapshotPath The path to write the snapshot to (uses default if empty)
+ */
+void FoodDatabase::saveSnapshot(const std::string& snapshotPath) {
+    std::string path = snapshotPath.empty() ? defaultSnapshotPath : snapshotPath;
+    
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    writeSnapshot(path, store);
+}
+
+/**
+ * writeSnapshot Method
+ * @param path The path to write the snapshot to
+ * @param foods The foods to write
+ * The caller holds at least the reader lock if foods is the database's store.
+ */
+void FoodDatabase::writeSnapshot(const std::string& path, const FoodStore& foods) const {
+    try {
+        FoodSnapshot::write(path, foods);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error saving food snapshot: " + std::string(e.what()));
+    }
+}
+
+/**
+ * loadSnapshot Method
+ * @param snapshotPath The path of the snapshot to map (uses default if empty)
+ * Maps the snapshot and copies its flat records into the store, building the
+ * search index and dependency graph on the way. The mapping is released afterwards.
+ */
+void FoodDatabase::loadSnapshot(const std::string& snapshotPath) {
+    std::string path = snapshotPath.empty() ? defaultSnapshotPath : snapshotPath;
+    
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    readSnapshot(path);
+}
+
+/**
+ * readSnapshot Method
+ * @param path The path of the snapshot to map
+ * Replaces the database contents with the snapshot. The caller holds the writer lock.
+ */
+void FoodDatabase::readSnapshot(const std::string& path) {
+    clearFoods();
+    
+    try {
+        auto start = std::chrono::steady_clock::now();
+        
+        FoodSnapshot snapshot(path);
+        store.reserve(snapshot.size());
+        
+        // Basic foods are visited first, so composites find their components interned
+        std::vector<std::pair<FoodHandle, float>> components;
+        snapshot.forEach([&](const FoodSnapshot::FoodRef& ref) {
+            std::string id(snapshot.getId(ref));
+            if (!ref.composite) {
+                insertBasicFood(id, snapshot.getKeywords(ref), snapshot.getCalories(ref));
+                return;
+            }
+            components.clear();
+            for (const auto& [compId, servings] : snapshot.getComponents(ref)) {
+                components.emplace_back(store.intern(compId), servings);
+            }
+            insertCompositeFood(id, snapshot.getKeywords(ref), components, snapshot.getCalories(ref));
+        });
+        
+        auto end = std::chrono::steady_clock::now();
+        double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        lastLoadStats.push_back({path, snapshot.size(), milliseconds});
+    } catch (const std::exception& e) {
+        clearFoods();
+        throw std::runtime_error("Error loading food snapshot: " + std::string(e.what()));
+    }
+}
+
+/**
+ * isSnapshotFresh Method
+ * @return True if the default snapshot exists and is not older than the default JSON files
+ */
+bool FoodDatabase::isSnapshotFresh() const {
+    std::error_code ec;
+    auto snapshotTime = std::filesystem::last_write_time(defaultSnapshotPath, ec);
+    if (ec) {
+        return false;
+    }
+    
+    for (const auto& path : {defaultBasicFoodPath, defaultCompositeFoodPath}) {
+        auto fileTime = std::filesystem::last_write_time(path, ec);
+        if (!ec && fileTime > snapshotTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * setJournal Method
+ * @param journal The journal to append modifications to, or nullptr to stop journaling
+ * The journal must stay open while attached. Replayed records are not journaled
+ * again, so detach the journal before replaying it.
+ */
+void FoodDatabase::setJournal(Journal* journal) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    this->journal = journal;
+}
+
+/**
+ * applyJournalRecord Method
+ * @param record A record written by this class to the journal
+ * Re-applies a food insertion or calorie update. Foods that already exist are
+ * skipped and updates set absolute values, so records already contained in the
+ * loaded files change nothing. Records of other kinds are ignored.
+ */
+void FoodDatabase::applyJournalRecord(const json& record) {
+    std::string op = record.value("op", "");
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    
+    if (op == "food-add") {
+        const json& food = record.at("food");
+        std::string id = food.at("id").get<std::string>();
+        if (store.contains(id)) {
+            return;
+        }
+        std::vector<std::string> keywords = food.at("keywords").get<std::vector<std::string>>();
+        float calories = food.at("calories").get<float>();
+        markModified();
+        if (!food.contains("components")) {
+            insertBasicFood(id, std::move(keywords), calories);
+            return;
+        }
+        std::vector<std::pair<FoodHandle, float>> components;
+        for (const auto& [compId, servings] : food.at("components").items()) {
+            components.emplace_back(store.intern(compId), servings.get<float>());
+        }
+        insertCompositeFood(id, std::move(keywords), components, calories);
+    } else if (op == "food-update") {
+        FoodHandle handle = store.find(record.at("id").get<std::string>());
+        if (!store.contains(handle) || store.isComposite(handle)) {
+            return;
+        }
+        float calories = record.at("calories").get<float>();
+        float delta = calories - store.getCalories(handle);
+        if (delta != 0.0f) {
+            store.setCalories(handle, calories);
+            propagateCalorieChange(handle, delta);
+            markModified();
+        }
+    }
+}
+
 /**
  * registerFoodDataSource Method
  * @param sourceName The name of the data source
@@ -407,6 +1189,7 @@ void FoodDatabase::loadFromFiles(const std::string& basicFoodPath, const std::st
  */
 void FoodDatabase::registerFoodDataSource(const std::string& sourceName, 
                                         std::function<std::vector<std::shared_ptr<BasicFood>>(const std::string&)> dataFunction) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
     foodDataSources[sourceName] = dataFunction;
 }
 
@@ -417,81 +1200,125 @@ void FoodDatabase::registerFoodDataSource(const std::string& sourceName,
  * @return A vector of BasicFood objects imported from the source
  */
 std::vector<std::shared_ptr<BasicFood>> FoodDatabase::importFromSource(const std::string& sourceName, const std::string& query) {
-    auto it = foodDataSources.find(sourceName);
-    if (it == foodDataSources.end()) {
-        throw std::invalid_argument("Unknown food data source: " + sourceName);
+    FoodDataSource source;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = foodDataSources.find(sourceName);
+        if (it == foodDataSources.end()) {
+            throw std::invalid_argument("Unknown food data source: " + sourceName);
+        }
+        source = it->second;
     }
     
-    auto importedFoods = it->second(query);
+    // The source runs without holding the lock
+    auto importedFoods = source(query);
     
     // Add imported foods to the database
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    std::vector<json> records;
     for (const auto& food : importedFoods) {
-        if (foods.find(food->getId()) == foods.end()) {
-            foods[food->getId()] = food;
+        if (!store.contains(food->getId())) {
+            FoodHandle handle = insertBasicFood(food->getId(), food->getKeywords(), food->getCaloriesPerServing());
+            if (journal) {
+                records.push_back(foodJournalRecord(handle));
+            }
+            markModified();
         }
     }
+    if (journal) {
+        journal->append(records);
+    }
     
     return importedFoods;
 }
 
 /**
- * basicFoodToJson Method
- * @param food The BasicFood to convert to JSON
- * @return A JSON object representing the BasicFood
+ * importFromSources Method
+ * @param sourceNames The names of the registered data sources to import from
+ * @param query The query to pass to every data source
+ * @param options Concurrency, batching and progress settings for the pipeline
+ * @return Progress and throughput counters of the import
+ * Runs the sources concurrently through an ImportPipeline. IDs are sanitized and
+ * deduplicated across sources; foods whose ID already exists are skipped.
  */
-json FoodDatabase::basicFoodToJson(const BasicFood* food) const {
-    json j;
-    j["id"] = food->getId();
-    j["keywords"] = food->getKeywords();
-    j["calories"] = food->getCaloriesPerServing();
-    return j;
+ImportStats FoodDatabase::importFromSources(const std::vector<std::string>& sourceNames, const std::string& query,
+                                          const ImportOptions& options) {
+    std::vector<std::pair<std::string, FoodDataSource>> sources;
+    sources.reserve(sourceNames.size());
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        for (const auto& name : sourceNames) {
+            auto it = foodDataSources.find(name);
+            if (it == foodDataSources.end()) {
+                throw std::invalid_argument("Unknown food data source: " + name);
+            }
+            sources.emplace_back(name, it->second);
+        }
+    }
+    
+    // The pipeline takes the writer lock itself, once per inserted batch
+    ImportPipeline pipeline(*this, options);
+    return pipeline.run(sources, query);
 }
 
 /**
- * compositeFoodToJson Method
- * @param food The CompositeFood to convert to JSON
- * @return A JSON object representing the CompositeFood
+ * addImportedFoods Method
+ * @param records Normalized basic food records; their keywords are moved from
+ * @return The number of foods added (records with an existing ID are skipped)
+ * The whole batch is inserted under a single acquisition of the writer lock.
  */
-json FoodDatabase::compositeFoodToJson(const CompositeFood* food) const {
-    json j;
-    j["id"] = food->getId();
-    j["keywords"] = food->getKeywords();
-    j["components"] = food->getComponents();
-    j["calories"] = food->getCaloriesPerServing();
-    return j;
+size_t FoodDatabase::addImportedFoods(std::vector<FoodRecord>& records) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    
+    size_t inserted = 0;
+    std::vector<json> journalRecords;
+    for (auto& record : records) {
+        if (store.contains(record.id)) {
+            continue;
+        }
+        FoodHandle handle = insertBasicFood(record.id, std::move(record.keywords), record.calories);
+        if (journal) {
+            journalRecords.push_back(foodJournalRecord(handle));
+        }
+        inserted++;
+    }
+    if (journal) {
+        journal->append(journalRecords);
+    }
+    if (inserted > 0) {
+        markModified();
+    }
+    return inserted;
 }
 
 /**
- * basicFoodFromJson Method
- * @param j The JSON to convert to a BasicFood
- * @return A shared pointer to a new BasicFood object
+ * basicFoodToJson Method
+ * @param food The stored basic food to convert to JSON
+ * @return A JSON object representing the BasicFood
  */
-std::shared_ptr<BasicFood> FoodDatabase::basicFoodFromJson(const json& j) const {
-    std::string id = j["id"];
-    std::vector<std::string> keywords = j["keywords"];
-    float calories = j["calories"];
-    
-    return std::make_shared<BasicFood>(id, keywords, calories);
+json FoodDatabase::basicFoodToJson(const FoodEntry& food) const {
+    json j;
+    j["id"] = food.id;
+    j["keywords"] = json(std::vector<std::string>(food.keywords.begin(), food.keywords.end()));
+    j["calories"] = food.calories;
+    return j;
 }
 
 /**
- * compositeFoodFromJson Method
- * @param j The JSON to convert to a CompositeFood
- * @return A shared pointer to a new CompositeFood object
+ * compositeFoodToJson Method
+ * @param food The stored composite food to convert to JSON
+ * @return A JSON object representing the CompositeFood
  */
-std::shared_ptr<CompositeFood> FoodDatabase::compositeFoodFromJson(const json& j) const {
-    std::string id = j["id"];
-    std::vector<std::string> keywords = j["keywords"];
-    std::map<std::string, float> components = j["components"];
-    float calories = j["calories"];
-    
-    auto food = std::make_shared<CompositeFood>(id, keywords);
-    
-    for (const auto& [compId, servings] : components) {
-        food->addComponent(compId, servings);
+json FoodDatabase::compositeFoodToJson(const FoodEntry& food) const {
+    json components = json::object();
+    for (size_t i = 0; i < food.componentFoods.size(); i++) {
+        components[store.getId(food.componentFoods[i])] = food.componentServings[i];
     }
     
-    food->setTotalCalories(calories);
-    
-    return food;
+    json j;
+    j["id"] = food.id;
+    j["keywords"] = json(std::vector<std::string>(food.keywords.begin(), food.keywords.end()));
+    j["components"] = components;
+    j["calories"] = food.calories;
+    return j;
 }
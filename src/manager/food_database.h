@@ -8,11 +8,21 @@
  * 
  * Key features:
  * - Singleton pattern implementation for global access
+ * - Thread-safe access: concurrent readers, one writer at a time
  * - Storage of basic and composite food items
- * - Food search functionality by ID or keywords
+ * - Food search functionality by ID or keywords, backed by an inverted index
+ * - Ranked, paginated searches keeping only the best matches in a bounded heap
+ * - LRU cache of search results, invalidated by every change (see SearchCache)
  * - Creation of composite foods from basic components
- * - Serialization and deserialization to/from JSON files
- * - Extensibility for additional food data sources
+ * - Incremental calorie updates of composites through a dependency graph
+ * - Flattened basic ingredients of composites (see IngredientExpansion)
+ * - Serialization and deserialization to/from JSON files, skipped when nothing changed
+ * - Saving in the background from a copy of the foods taken under the reader lock
+ * - Flat, handle-indexed storage of all foods (see FoodStore)
+ * - Memory-mapped binary snapshots for fast startup
+ * - Keyword text, search index and dependency graph kept in an arena released on reload (see LoadArena)
+ * - Extensibility for additional food data sources, with a concurrent multi-source import pipeline
+ * - Optional write-ahead journal receiving every insertion and update (see Journal)
  * 
  * The database serves as the central repository for all food information used by the application.
  */
@@ -24,12 +34,63 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include "../models/food.h"
+#include "food_store.h"
+#include "search_index.h"
+#include "search_cache.h"
+#include "calorie_graph.h"
+#include "ingredient_expansion.h"
+#include "food_json_reader.h"
+#include "food_snapshot.h"
+#include "import_pipeline.h"
+#include "../utils/journal.h"
+#include "../utils/load_arena.h"
 #include <nlohmann/json.hpp>
 
 using namespace std;
 using json = nlohmann::json;
 
+/**
+ * FoodFileLoadStats struct
+ * Timing information for one database file read by loadFromFiles
+ */
+struct FoodFileLoadStats {
+    string path;
+    size_t foods;
+    double milliseconds;
+};
+
+/**
+ * RankedFood struct
+ * A food returned by a ranked search, with its relevance score
+ */
+struct RankedFood {
+    shared_ptr<Food> food;
+    float score;
+};
+
+/**
+ * FoodPage struct
+ * One page of a ranked search or of the food list
+ */
+struct FoodPage {
+    vector<RankedFood> foods;
+    size_t total = 0;   // Matches (or foods) on all pages
+};
+
+/**
+ * FoodCalories struct
+ * A food's handle with its calories per serving
+ */
+struct FoodCalories {
+    FoodHandle handle;
+    float calories;
+};
+
 /**
  * FoodDatabase Class
  * This class manages the food database, including basic and composite foods.
@@ -40,11 +101,26 @@ public:
     
     // Food database methods
     shared_ptr<Food> getFood(const string& id) const;
+    shared_ptr<Food> getFood(FoodHandle handle) const;
     vector<shared_ptr<Food>> getAllFoods() const;
     vector<shared_ptr<Food>> searchFoods(const vector<string>& keywords, bool matchAll = true) const;
+    FoodPage rankFoods(const vector<string>& keywords, bool matchAll, size_t limit, size_t offset = 0) const;
+    FoodPage getFoodPage(size_t limit, size_t offset = 0) const;
+    float calculateTotalCalories(const map<string, float>& servings) const;
+    float calculateTotalCalories(ConstSpan<FoodServings> servings) const;
+    vector<FoodCalories> getFoodCalories(const vector<string>& keywords = {}, bool matchAll = true) const;
+    
+    // Basic ingredients (servings of basic foods, sorted by handle)
+    vector<FoodServings> getIngredients(const string& id) const;
+    vector<FoodServings> sumIngredients(ConstSpan<FoodServings> servings) const;
+    
+    // Search result cache, in queries
+    void setSearchCacheCapacity(size_t queries);
+    SearchCacheStats getSearchCacheStats() const;
     
     // Modified methods to use autogenerated IDs
     string addBasicFood(const vector<string>& keywords, float calories);
+    vector<string> addBasicFoods(const vector<pair<vector<string>, float>>& foods);
     string createCompositeFood(const vector<string>& keywords, 
                                   const map<string, float>& components);
     
@@ -53,14 +129,42 @@ public:
     void createCompositeFood(const string& id, const vector<string>& keywords, 
                             const map<string, float>& components);
     
+    // Updates a basic food and recalculates only the composites that depend on it
+    size_t updateBasicFood(const string& id, float calories);
+    
     // Serialization
     void saveToFiles(const string& basicFoodPath = "", const string& compositeFoodPath = "");
+    function<void()> prepareSave();
     void loadFromFiles(const string& basicFoodPath = "", const string& compositeFoodPath = "");
+    const vector<FoodFileLoadStats>& getLastLoadStats() const;
+    bool isDirty() const;
+    uint64_t getVersion() const;
+    uint64_t getCalorieVersion() const;
+    
+    // Arena for the index of the loaded foods (default) or the heap; applies from the next load
+    void setArenaLoading(bool enabled);
+    bool isArenaLoading() const;
+    
+    // Binary snapshot (faster startup alternative to the JSON files)
+    void saveSnapshot(const string& snapshotPath = "");
+    void loadSnapshot(const string& snapshotPath = "");
+    
+    // Write-ahead journal (modifications are appended while one is attached)
+    void setJournal(Journal* journal);
+    void applyJournalRecord(const json& record);
     
     // Helper for extensibility (downloading food data from web sources)
     void registerFoodDataSource(const string& sourceName, 
                                function<vector<shared_ptr<BasicFood>>(const string&)> dataFunction);
     vector<shared_ptr<BasicFood>> importFromSource(const string& sourceName, const string& query);
+    ImportStats importFromSources(const vector<string>& sourceNames, const string& query,
+                                  const ImportOptions& options = ImportOptions());
+    
+    // Bulk insertion used by the import pipeline (takes the writer lock once per batch)
+    size_t addImportedFoods(vector<FoodRecord>& records);
+    
+    // ID normalization shared with the import pipeline
+    static string sanitizeForId(const string& input);
     
 private:
     FoodDatabase();
@@ -68,24 +172,74 @@ private:
     FoodDatabase(const FoodDatabase&) = delete;
     FoodDatabase& operator=(const FoodDatabase&) = delete;
     
-    map<string, shared_ptr<Food>> foods;
+    // Memory of the keyword text, the search index and the calorie graph,
+    // released when the foods are cleared
+    LoadArena catalogArena;
+    // Flat storage of all foods; Food objects are views built on demand
+    FoodStore store{&catalogArena};
+    SearchIndex searchIndex{&catalogArena};
+    mutable SearchCache searchCache;
+    CalorieGraph calorieGraph{&catalogArena};
+    IngredientExpansion ingredients{store};
     string defaultBasicFoodPath;
     string defaultCompositeFoodPath;
+    string defaultSnapshotPath;
+    vector<FoodFileLoadStats> lastLoadStats;
+    
+    // Base ID -> next numeric suffix to try when generating IDs
+    unordered_map<string, size_t> nextIdSuffix;
+    
+    // Readers (lookups, searches, saves) share the lock; every modification takes it exclusively
+    mutable shared_mutex mutex;
+    std::mutex saveMutex;
+    
+    // Version of the foods last written to the default files; guarded by saveMutex
+    uint64_t savedVersion;
+    
+    // Journal receiving insertions and updates; not owned
+    Journal* journal;
+    
+    // Set by every modification, cleared when the default files are written or loaded
+    atomic<bool> dirty;
+    
+    // Incremented by every change, including reloads
+    atomic<uint64_t> version;
+    
+    // Incremented when the calories of an ID that may be logged change: updates,
+    // reloads and foods added under an ID already referenced elsewhere
+    atomic<uint64_t> calorieVersion;
     
     // Map of data source names to food data source functions
     map<string, function<vector<shared_ptr<BasicFood>>(const string&)>> foodDataSources;
     
     // Helper methods
-    json basicFoodToJson(const BasicFood* food) const;
-    json compositeFoodToJson(const CompositeFood* food) const;
-    shared_ptr<BasicFood> basicFoodFromJson(const json& j) const;
-    shared_ptr<CompositeFood> compositeFoodFromJson(const json& j) const;
+    json basicFoodToJson(const FoodEntry& food) const;
+    json compositeFoodToJson(const FoodEntry& food) const;
+    void loadFoodFile(const string& path, const FoodJsonReader::RecordHandler& handler);
+    
+    FoodHandle insertBasicFood(const string& id, vector<string> keywords, float calories);
+    FoodHandle insertCompositeFood(const string& id, vector<string> keywords,
+                                   const vector<pair<FoodHandle, float>>& components, float calories);
+    void indexFood(FoodHandle handle, size_t knownIds);
+    vector<FoodHandle> matchingHandles(const vector<string>& keywords, bool matchAll) const;
+    json foodJournalRecord(FoodHandle handle) const;
+    void journalFood(FoodHandle handle);
+    void clearFoods();
+    void markModified();
+    void buildCompositeFood(const string& id, const vector<string>& keywords,
+                            const map<string, float>& components);
+    void writeFiles(const FoodStore& foods, const string& basicFoodPath,
+                    const string& compositeFoodPath, const string& snapshotPath) const;
+    void writeSnapshot(const string& path, const FoodStore& foods) const;
+    void readSnapshot(const string& path);
+    bool isSnapshotFresh() const;
     
-    float calculateCompositeFoodCalories(const map<string, float>& components);
+    float calculateCompositeFoodCalories(const map<string, float>& components) const;
+    size_t propagateCalorieChange(FoodHandle handle, float delta);
     
     // Helper methods for ID generation
     string generateFoodId(const string& baseKeyword);
-    string sanitizeForId(const string& input);
+    void noteIdSuffix(const string& id);
     bool isIdUnique(const string& id) const;
 };
 
@@ -0,0 +1,171 @@
+/**
+ * @file food_json_reader.cpp
+ * @brief Streaming Reader Implementation
+ *
+ * This file implements the FoodJsonReader class defined in food_json_reader.h.
+ * A SAX handler tracks the nesting depth of the parser and fills a FoodRecord
+ * from the events that belong to the current top-level array element.
+ *
+ * Key implementations:
+ * - SAX event handler for the food file layout
+ * - Skipping of unknown or unexpectedly nested fields
+ * - Reuse of one record, with its components in an arena reset per record
+ * - Conversion of parse errors into runtime exceptions
+ *
+ * Nesting depths used by the handler:
+ * 1 = top-level array, 2 = food object, 3 = keywords array / components object.
+ */
+
+#include "food_json_reader.h"
+#include <cstddef>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * FoodSaxHandler Class
+ * Builds FoodRecord objects from SAX events and passes them to a callback.
+ */
+class FoodSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit FoodSaxHandler(const FoodJsonReader::RecordHandler& handler)
+        : handler(handler), recordArena(recordBuffer, sizeof(recordBuffer)), record(&recordArena) {}
+
+    size_t getCount() const { return count; }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t value) override { return number(static_cast<float>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return number(static_cast<float>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return number(static_cast<float>(value)); }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& value) override {
+        if (depth == RECORD_DEPTH && field == Field::ID) {
+            record.id = std::move(value);
+        } else if (depth == FIELD_DEPTH && field == Field::KEYWORDS) {
+            record.keywords.push_back(std::move(value));
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        depth++;
+        if (depth == RECORD_DEPTH && inTopLevelArray) {
+            resetRecord();
+            field = Field::NONE;
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth == RECORD_DEPTH && inTopLevelArray) {
+            if (record.id.empty()) {
+                throw std::runtime_error("Food record " + std::to_string(count + 1) + " has no 'id'");
+            }
+            keywordHint = record.keywords.size();
+            handler(record);
+            count++;
+        }
+        depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        depth++;
+        if (depth == 1) {
+            inTopLevelArray = true;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        depth--;
+        return true;
+    }
+
+    bool key(string_t& value) override {
+        if (depth == RECORD_DEPTH) {
+            if (value == "id") {
+                field = Field::ID;
+            } else if (value == "keywords") {
+                field = Field::KEYWORDS;
+            } else if (value == "calories") {
+                field = Field::CALORIES;
+            } else if (value == "components") {
+                field = Field::COMPONENTS;
+            } else {
+                field = Field::NONE;
+            }
+        } else if (depth == FIELD_DEPTH && field == Field::COMPONENTS) {
+            componentId = std::move(value);
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+        throw std::runtime_error("Parse error at byte " + std::to_string(position) + ": " + ex.what());
+    }
+
+private:
+    enum class Field { NONE, ID, KEYWORDS, CALORIES, COMPONENTS };
+    static const int RECORD_DEPTH = 2;
+    static const int FIELD_DEPTH = 3;
+    // Enough for the components of typical recipes; larger ones spill to the heap
+    static const size_t RECORD_BUFFER_SIZE = 4096;
+
+    /**
+     * resetRecord Method
+     * Empties the record for the next one. The keywords keep their capacity
+     * unless the handler moved them out, and the components' nodes are
+     * reclaimed by resetting the arena.
+     */
+    void resetRecord() {
+        record.id.clear();
+        record.keywords.clear();
+        record.keywords.reserve(keywordHint);
+        record.components.clear();
+        record.calories = 0.0f;
+        recordArena.release();
+    }
+
+    bool number(float value) {
+        if (depth == RECORD_DEPTH && field == Field::CALORIES) {
+            record.calories = value;
+        } else if (depth == FIELD_DEPTH && field == Field::COMPONENTS) {
+            record.components[std::pmr::string(componentId, &recordArena)] += value;
+        }
+        return true;
+    }
+
+    const FoodJsonReader::RecordHandler& handler;
+    alignas(std::max_align_t) std::byte recordBuffer[RECORD_BUFFER_SIZE];
+    std::pmr::monotonic_buffer_resource recordArena;
+    FoodRecord record;
+    size_t keywordHint = 0;
+    std::string componentId;
+    Field field = Field::NONE;
+    int depth = 0;
+    bool inTopLevelArray = false;
+    size_t count = 0;
+};
+
+} // namespace
+
+/**
+ * read Method
+ * @param input The stream to read from
+ * @param handler The callback invoked for every complete food record
+ * @return The number of records read
+ * Records are handed out in file order. The record passed to the handler is
+ * reset before the next record is read. Its ID and keywords may be moved from;
+ * its components are stored in the reader and have to be copied to be kept.
+ */
+size_t FoodJsonReader::read(std::istream& input, const RecordHandler& handler) {
+    FoodSaxHandler sax(handler);
+    json::sax_parse(input, &sax);
+    return sax.getCount();
+}
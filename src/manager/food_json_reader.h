@@ -0,0 +1,57 @@
+/**
+ * @file food_json_reader.h
+ * @brief Streaming Reader for Food Database Files
+ *
+ * This file defines the FoodJsonReader class which reads basic_food.json and
+ * composite_food.json as a stream of SAX events. Each food record is assembled
+ * directly from the parser events and handed to a callback as soon as its closing
+ * brace is read, so the whole file is never materialized as a JSON document.
+ *
+ * Key components:
+ * - FoodRecord struct holding the fields of a single food entry
+ * - FoodJsonReader class driving nlohmann's SAX parser over an input stream
+ *
+ * Unknown fields are skipped, which keeps the reader tolerant of files written by
+ * newer versions of the application. The record handed to the callback is reused
+ * for the next one, and its components live in a small arena of the reader, so
+ * reading a file allocates almost nothing per record.
+ */
+
+#ifndef FOOD_JSON_READER_H
+#define FOOD_JSON_READER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory_resource>
+#include <istream>
+#include <functional>
+
+using namespace std;
+
+/**
+ * FoodRecord struct
+ * Represents one food entry as it appears in the database files
+ */
+struct FoodRecord {
+    explicit FoodRecord(pmr::memory_resource* resource = pmr::get_default_resource()) : components(resource) {}
+
+    string id;
+    vector<string> keywords;
+    pmr::map<pmr::string, float> components; // Only present for composite foods
+    float calories = 0.0f;
+};
+
+/**
+ * FoodJsonReader Class
+ * This class streams food records out of a JSON array without building a DOM.
+ */
+class FoodJsonReader {
+public:
+    using RecordHandler = function<void(FoodRecord& record)>;
+
+    // Reads every record of the top-level array, returning the number of records
+    static size_t read(istream& input, const RecordHandler& handler);
+};
+
+#endif // FOOD_JSON_READER_H
@@ -0,0 +1,378 @@
+/**
+ * @file food_snapshot.cpp
+ * @brief Binary Snapshot Implementation
+ *
+ * This file implements the FoodSnapshot class defined in food_snapshot.h.
+ * Writing lays out the string table, flat food arrays and CSR component lists
+ * in a temporary file that is renamed into place. Reading maps the file with
+ * mmap, validates the header and section bounds, and then serves lookups and
+ * record access directly from the mapped bytes.
+ *
+ * Key implementations:
+ * - String interning and section layout for the writer
+ * - Atomic replacement of the snapshot file
+ * - Memory mapping and structural validation of the file
+ * - Binary search by ID over the sorted food arrays
+ * - Record access for loading the snapshot into a FoodStore
+ */
+
+#include "food_snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'D', 'M', 'F', 'O', 'O', 'D', 'S', '\0'};
+
+/**
+ * align8 Function
+ * @param pos A file position
+ * @return The position rounded up to the next multiple of 8
+ */
+uint64_t align8(uint64_t pos) {
+    return (pos + 7) & ~static_cast<uint64_t>(7);
+}
+
+/**
+ * writeSection Function
+ * Pads the stream to the section position and writes the section bytes.
+ */
+void writeSection(std::ofstream& out, uint64_t pos, const void* bytes, size_t size) {
+    static const char padding[8] = {};
+    uint64_t current = static_cast<uint64_t>(out.tellp());
+    out.write(padding, static_cast<std::streamsize>(pos - current));
+    if (size > 0) {
+        out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+    }
+}
+
+} // namespace
+
+/**
+ * write Method
+ * @param path The path of the snapshot file to write
+ * @param store The foods to store
+ * The snapshot is written to a temporary file and renamed over the target.
+ */
+void FoodSnapshot::write(const std::string& path, const FoodStore& store) {
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIndex;
+    auto intern = [&](std::string_view view) {
+        std::string s(view);
+        auto it = stringIndex.find(s);
+        if (it != stringIndex.end()) {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(strings.size());
+        stringIndex.emplace(s, index);
+        strings.push_back(s);
+        return index;
+    };
+
+    std::vector<uint32_t> keywordRefs;
+    std::vector<FoodRecord> basicRecords;
+    std::vector<FoodRecord> compositeRecords;
+    std::vector<uint32_t> componentOffsetList = {0};
+    std::vector<ComponentRecord> componentRecords;
+
+    // Foods are visited in ID order, so both record arrays come out sorted
+    for (FoodHandle handle : store.sortedHandles()) {
+        FoodEntry food = store.entry(handle);
+        FoodRecord rec;
+        rec.id = intern(food.id);
+        rec.keywordBegin = static_cast<uint32_t>(keywordRefs.size());
+        for (const auto& keyword : food.keywords) {
+            keywordRefs.push_back(intern(keyword));
+        }
+        rec.keywordCount = static_cast<uint32_t>(keywordRefs.size()) - rec.keywordBegin;
+        rec.calories = food.calories;
+
+        if (food.composite) {
+            for (size_t i = 0; i < food.componentFoods.size(); i++) {
+                componentRecords.push_back({intern(store.getId(food.componentFoods[i])), food.componentServings[i]});
+            }
+            componentOffsetList.push_back(static_cast<uint32_t>(componentRecords.size()));
+            compositeRecords.push_back(rec);
+        } else {
+            basicRecords.push_back(rec);
+        }
+    }
+
+    // Flatten the string table
+    std::vector<uint32_t> stringOffsetList;
+    std::string stringBytes;
+    stringOffsetList.reserve(strings.size() + 1);
+    for (const auto& s : strings) {
+        stringOffsetList.push_back(static_cast<uint32_t>(stringBytes.size()));
+        stringBytes += s;
+    }
+    stringOffsetList.push_back(static_cast<uint32_t>(stringBytes.size()));
+
+    // Lay out the sections
+    Header hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic));
+    hdr.version = FORMAT_VERSION;
+    hdr.stringCount = static_cast<uint32_t>(strings.size());
+    hdr.keywordRefCount = static_cast<uint32_t>(keywordRefs.size());
+    hdr.basicCount = static_cast<uint32_t>(basicRecords.size());
+    hdr.compositeCount = static_cast<uint32_t>(compositeRecords.size());
+    hdr.componentCount = static_cast<uint32_t>(componentRecords.size());
+
+    hdr.stringOffsetsPos = align8(sizeof(Header));
+    hdr.stringDataPos = align8(hdr.stringOffsetsPos + stringOffsetList.size() * sizeof(uint32_t));
+    hdr.keywordRefsPos = align8(hdr.stringDataPos + stringBytes.size());
+    hdr.basicPos = align8(hdr.keywordRefsPos + keywordRefs.size() * sizeof(uint32_t));
+    hdr.compositePos = align8(hdr.basicPos + basicRecords.size() * sizeof(FoodRecord));
+    hdr.componentOffsetsPos = align8(hdr.compositePos + compositeRecords.size() * sizeof(FoodRecord));
+    hdr.componentsPos = align8(hdr.componentOffsetsPos + componentOffsetList.size() * sizeof(uint32_t));
+    hdr.fileSize = hdr.componentsPos + componentRecords.size() * sizeof(ComponentRecord);
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + tempPath);
+        }
+
+        out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        writeSection(out, hdr.stringOffsetsPos, stringOffsetList.data(), stringOffsetList.size() * sizeof(uint32_t));
+        writeSection(out, hdr.stringDataPos, stringBytes.data(), stringBytes.size());
+        writeSection(out, hdr.keywordRefsPos, keywordRefs.data(), keywordRefs.size() * sizeof(uint32_t));
+        writeSection(out, hdr.basicPos, basicRecords.data(), basicRecords.size() * sizeof(FoodRecord));
+        writeSection(out, hdr.compositePos, compositeRecords.data(), compositeRecords.size() * sizeof(FoodRecord));
+        writeSection(out, hdr.componentOffsetsPos, componentOffsetList.data(), componentOffsetList.size() * sizeof(uint32_t));
+        writeSection(out, hdr.componentsPos, componentRecords.data(), componentRecords.size() * sizeof(ComponentRecord));
+
+        if (!out) {
+            throw std::runtime_error("Failed to write snapshot: " + tempPath);
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+/**
+ * FoodSnapshot Constructor
+ * @param path The path of the snapshot file to map
+ * @throws runtime_error if the file cannot be mapped or is not a valid snapshot
+ */
+FoodSnapshot::FoodSnapshot(const std::string& path)
+    : data(nullptr), length(0), header(nullptr) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open snapshot: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        throw std::runtime_error("Snapshot is truncated: " + path);
+    }
+
+    length = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map snapshot: " + path);
+    }
+    data = static_cast<const char*>(mapping);
+    header = reinterpret_cast<const Header*>(data);
+
+    try {
+        validate();
+    } catch (...) {
+        ::munmap(const_cast<char*>(data), length);
+        throw;
+    }
+
+    stringOffsets = reinterpret_cast<const uint32_t*>(data + header->stringOffsetsPos);
+    stringData = data + header->stringDataPos;
+    keywordRefs = reinterpret_cast<const uint32_t*>(data + header->keywordRefsPos);
+    basics = reinterpret_cast<const FoodRecord*>(data + header->basicPos);
+    composites = reinterpret_cast<const FoodRecord*>(data + header->compositePos);
+    componentOffsets = reinterpret_cast<const uint32_t*>(data + header->componentOffsetsPos);
+    components = reinterpret_cast<const ComponentRecord*>(data + header->componentsPos);
+}
+
+/**
+ * FoodSnapshot Destructor
+ * Unmaps the snapshot file.
+ */
+FoodSnapshot::~FoodSnapshot() {
+    if (data) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+}
+
+/**
+ * validate Method
+ * Checks the magic, version and that every section lies inside the mapping.
+ */
+void FoodSnapshot::validate() const {
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a food database snapshot");
+    }
+    if (header->version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header->version));
+    }
+    if (header->fileSize != length) {
+        throw std::runtime_error("Snapshot size does not match its header");
+    }
+
+    auto checkSection = [this](uint64_t pos, uint64_t count, uint64_t elementSize) {
+        if (pos % 8 != 0 || pos > length || count * elementSize > length - pos) {
+            throw std::runtime_error("Snapshot section out of bounds");
+        }
+    };
+    checkSection(header->stringOffsetsPos, header->stringCount + 1ULL, sizeof(uint32_t));
+    checkSection(header->keywordRefsPos, header->keywordRefCount, sizeof(uint32_t));
+    checkSection(header->basicPos, header->basicCount, sizeof(FoodRecord));
+    checkSection(header->compositePos, header->compositeCount, sizeof(FoodRecord));
+    checkSection(header->componentOffsetsPos, header->compositeCount + 1ULL, sizeof(uint32_t));
+    checkSection(header->componentsPos, header->componentCount, sizeof(ComponentRecord));
+
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(data + header->stringOffsetsPos);
+    checkSection(header->stringDataPos, offsets[header->stringCount], 1);
+
+    const uint32_t* rows = reinterpret_cast<const uint32_t*>(data + header->componentOffsetsPos);
+    if (rows[header->compositeCount] != header->componentCount) {
+        throw std::runtime_error("Snapshot component table is inconsistent");
+    }
+}
+
+/**
+ * size Method
+ * @return The number of foods stored in the snapshot
+ */
+size_t FoodSnapshot::size() const {
+    return header->basicCount + header->compositeCount;
+}
+
+/**
+ * getString Method
+ * @param index The index of a string in the string table
+ * @return A view of the string inside the mapping
+ */
+std::string_view FoodSnapshot::getString(uint32_t index) const {
+    if (index >= header->stringCount) {
+        throw std::runtime_error("Snapshot string index out of range");
+    }
+    uint32_t begin = stringOffsets[index];
+    uint32_t end = stringOffsets[index + 1];
+    if (begin > end || end > stringOffsets[header->stringCount]) {
+        throw std::runtime_error("Snapshot string table is inconsistent");
+    }
+    return std::string_view(stringData + begin, end - begin);
+}
+
+/**
+ * record Method
+ * @param ref A reference to a food record
+ * @return The record the reference points to
+ */
+const FoodSnapshot::FoodRecord& FoodSnapshot::record(const FoodRef& ref) const {
+    return ref.composite ? composites[ref.index] : basics[ref.index];
+}
+
+/**
+ * find Method
+ * @param id The food ID to look up
+ * @param ref Receives the reference to the record when found
+ * @return True if the snapshot contains a food with the given ID
+ */
+bool FoodSnapshot::find(std::string_view id, FoodRef& ref) const {
+    auto search = [&](const FoodRecord* records, uint32_t count, bool composite) {
+        const FoodRecord* end = records + count;
+        const FoodRecord* it = std::lower_bound(records, end, id,
+            [this](const FoodRecord& rec, std::string_view key) { return getString(rec.id) < key; });
+        if (it != end && getString(it->id) == id) {
+            ref = {composite, static_cast<uint32_t>(it - records)};
+            return true;
+        }
+        return false;
+    };
+    return search(basics, header->basicCount, false) || search(composites, header->compositeCount, true);
+}
+
+/**
+ * getId Method
+ * @param ref A reference to a food record
+ * @return A view of the food's ID inside the mapping
+ */
+std::string_view FoodSnapshot::getId(const FoodRef& ref) const {
+    return getString(record(ref).id);
+}
+
+/**
+ * getKeywords Method
+ * @param ref A reference to a food record
+ * @return The food's keywords
+ */
+std::vector<std::string> FoodSnapshot::getKeywords(const FoodRef& ref) const {
+    const FoodRecord& rec = record(ref);
+    if (static_cast<uint64_t>(rec.keywordBegin) + rec.keywordCount > header->keywordRefCount) {
+        throw std::runtime_error("Snapshot keyword span out of range");
+    }
+
+    std::vector<std::string> keywords;
+    keywords.reserve(rec.keywordCount);
+    for (uint32_t i = 0; i < rec.keywordCount; i++) {
+        keywords.emplace_back(getString(keywordRefs[rec.keywordBegin + i]));
+    }
+    return keywords;
+}
+
+/**
+ * getCalories Method
+ * @param ref A reference to a food record
+ * @return The calories per serving stored for the food
+ */
+float FoodSnapshot::getCalories(const FoodRef& ref) const {
+    return record(ref).calories;
+}
+
+/**
+ * getComponents Method
+ * @param ref A reference to a food record
+ * @return The composite's component IDs with servings (empty for basic foods)
+ */
+std::vector<std::pair<std::string_view, float>> FoodSnapshot::getComponents(const FoodRef& ref) const {
+    std::vector<std::pair<std::string_view, float>> result;
+    if (!ref.composite) {
+        return result;
+    }
+
+    uint32_t begin = componentOffsets[ref.index];
+    uint32_t end = componentOffsets[ref.index + 1];
+    if (begin > end || end > header->componentCount) {
+        throw std::runtime_error("Snapshot component span out of range");
+    }
+    result.reserve(end - begin);
+    for (uint32_t i = begin; i < end; i++) {
+        result.emplace_back(getString(components[i].food), components[i].servings);
+    }
+    return result;
+}
+
+/**
+ * forEach Method
+ * @param visitor The callback invoked with a reference to every record
+ * Basic foods are visited before composite foods.
+ */
+void FoodSnapshot::forEach(const std::function<void(const FoodRef&)>& visitor) const {
+    for (uint32_t i = 0; i < header->basicCount; i++) {
+        visitor({false, i});
+    }
+    for (uint32_t i = 0; i < header->compositeCount; i++) {
+        visitor({true, i});
+    }
+}
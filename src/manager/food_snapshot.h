@@ -0,0 +1,118 @@
+/**
+ * @file food_snapshot.h
+ * @brief Binary Snapshot of the Food Database
+ *
+ * This file defines the FoodSnapshot class which writes and reads a compact,
+ * versioned binary image of the food database. The snapshot is memory-mapped when
+ * opened and read in place; its flat arrays map almost one to one onto FoodStore
+ * columns, so loading is a sequential copy without any parsing.
+ *
+ * File layout (all sections 8-byte aligned, native byte order):
+ * - Header with magic, format version, element counts and section offsets
+ * - String table: offsets array followed by the concatenated bytes of every ID and keyword
+ * - Keyword references: string indices referenced by the food records
+ * - Basic foods: flat array of {id, keyword span, calories}, sorted by ID
+ * - Composite foods: flat array of {id, keyword span, calories}, sorted by ID
+ * - Components in CSR form: per-composite row offsets plus {food, servings} pairs
+ *
+ * The JSON files remain the interchange format; the snapshot only speeds up startup.
+ */
+
+#ifndef FOOD_SNAPSHOT_H
+#define FOOD_SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include "food_store.h"
+
+using namespace std;
+
+/**
+ * FoodSnapshot Class
+ * This class provides read-only, in-place access to a memory-mapped snapshot file.
+ */
+class FoodSnapshot {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    // Reference to a food record inside the snapshot
+    struct FoodRef {
+        bool composite;
+        uint32_t index;
+    };
+
+    // Writing
+    static void write(const string& path, const FoodStore& store);
+
+    // Reading
+    explicit FoodSnapshot(const string& path);
+    ~FoodSnapshot();
+    FoodSnapshot(const FoodSnapshot&) = delete;
+    FoodSnapshot& operator=(const FoodSnapshot&) = delete;
+
+    size_t size() const;
+    bool find(string_view id, FoodRef& ref) const;
+
+    // Record access (views point into the mapping)
+    string_view getId(const FoodRef& ref) const;
+    float getCalories(const FoodRef& ref) const;
+    vector<string> getKeywords(const FoodRef& ref) const;
+    vector<pair<string_view, float>> getComponents(const FoodRef& ref) const;
+    void forEach(const function<void(const FoodRef&)>& visitor) const;
+
+private:
+    // On-disk structures
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t stringCount;
+        uint32_t keywordRefCount;
+        uint32_t basicCount;
+        uint32_t compositeCount;
+        uint32_t componentCount;
+        uint64_t stringOffsetsPos;
+        uint64_t stringDataPos;
+        uint64_t keywordRefsPos;
+        uint64_t basicPos;
+        uint64_t compositePos;
+        uint64_t componentOffsetsPos;
+        uint64_t componentsPos;
+        uint64_t fileSize;
+    };
+
+    struct FoodRecord {
+        uint32_t id;
+        uint32_t keywordBegin;
+        uint32_t keywordCount;
+        float calories;
+    };
+
+    struct ComponentRecord {
+        uint32_t food;
+        float servings;
+    };
+
+    // Mapping
+    const char* data;
+    size_t length;
+    const Header* header;
+
+    // Section views into the mapping
+    const uint32_t* stringOffsets;
+    const char* stringData;
+    const uint32_t* keywordRefs;
+    const FoodRecord* basics;
+    const FoodRecord* composites;
+    const uint32_t* componentOffsets;
+    const ComponentRecord* components;
+
+    string_view getString(uint32_t index) const;
+    const FoodRecord& record(const FoodRef& ref) const;
+    void validate() const;
+};
+
+#endif // FOOD_SNAPSHOT_H
@@ -0,0 +1,401 @@
+/**
+ * @file food_store.cpp
+ * @brief Flat Storage Engine Implementation
+ *
+ * This file implements the FoodStore class defined in food_store.h.
+ * Keywords and components of all foods live in shared pools; each food only
+ * records the offset and length of its span in those pools. The characters of
+ * the keywords are bump-allocated in large blocks, so storing a keyword never
+ * costs a heap allocation of its own. Columns are indexed by handle and grow
+ * together with the interner.
+ *
+ * Key implementations:
+ * - Insertion of basic and composite foods into the columns and pools
+ * - In-place calorie updates that invalidate cached Food views
+ * - Maintenance of the ID-ordered handle list used for iteration
+ * - On-demand construction of shared Food views, safe for concurrent readers
+ */
+
+#include "food_store.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * FoodStore Constructor
+ * @param resource The memory resource the keyword text is allocated from
+ */
+FoodStore::FoodStore(std::pmr::memory_resource* resource) : keywordText(resource) {
+}
+
+/**
+ * FoodStore Copy Constructor
+ * @param other The store to copy
+ * The copy shares the interned handles but has its own keyword text on the
+ * heap, so it stays valid when the original is cleared. Its Food views are
+ * built again on request.
+ */
+FoodStore::FoodStore(const FoodStore& other)
+    : kinds(other.kinds),
+      calories(other.calories),
+      keywordBegin(other.keywordBegin),
+      keywordCount(other.keywordCount),
+      componentBegin(other.componentBegin),
+      componentCount(other.componentCount),
+      keywordText(std::pmr::get_default_resource()),
+      componentFoodPool(other.componentFoodPool),
+      componentServingPool(other.componentServingPool),
+      foodCount(other.foodCount),
+      sorted(other.sortedHandles()),
+      views(other.kinds.size()) {
+    keywordPool.reserve(other.keywordPool.size());
+    for (std::string_view keyword : other.keywordPool) {
+        addKeyword(keyword);
+    }
+}
+
+/**
+ * intern Method
+ * @param id A food ID
+ * @return The handle of the ID, assigning one if needed
+ */
+FoodHandle FoodStore::intern(std::string_view id) {
+    FoodHandle handle = ids.intern(id);
+    ensureColumns(handle);
+    return handle;
+}
+
+/**
+ * find Method
+ * @param id A food ID
+ * @return The handle of the ID, or INVALID_FOOD if it was never seen
+ */
+FoodHandle FoodStore::find(std::string_view id) const {
+    return ids.find(id);
+}
+
+/**
+ * getId Method
+ * @param handle A food handle
+ * @return The food ID the handle stands for
+ */
+const std::string& FoodStore::getId(FoodHandle handle) const {
+    return ids.name(handle);
+}
+
+/**
+ * handleCount Method
+ * @return The number of handles assigned, including IDs without a stored food
+ */
+size_t FoodStore::handleCount() const {
+    return ids.size();
+}
+
+/**
+ * columnCount Method
+ * @return The number of handles the columns are sized for: every stored food
+ *         and every ID referenced by one, but not IDs only known to the logs
+ */
+size_t FoodStore::columnCount() const {
+    return kinds.size();
+}
+
+/**
+ * ensureColumns Method
+ * @param handle A handle that must be addressable in every column
+ */
+void FoodStore::ensureColumns(FoodHandle handle) {
+    if (handle < kinds.size()) {
+        return;
+    }
+    size_t count = static_cast<size_t>(handle) + 1;
+    kinds.resize(count, NONE);
+    calories.resize(count, 0.0f);
+    keywordBegin.resize(count, 0);
+    keywordCount.resize(count, 0);
+    componentBegin.resize(count, 0);
+    componentCount.resize(count, 0);
+    views.resize(count);
+}
+
+/**
+ * addFood Method
+ * @param id The ID of the new food
+ * @param kind Whether the food is basic or composite
+ * @param keywords The keywords of the food, copied into the keyword pool
+ * @param foodCalories The calories per serving
+ * @return The handle of the new food
+ */
+FoodHandle FoodStore::addFood(std::string_view id, Kind kind, const std::vector<std::string>& keywords, float foodCalories) {
+    FoodHandle handle = intern(id);
+    if (kinds[handle] != NONE) {
+        throw std::invalid_argument("Food with ID '" + std::string(id) + "' already exists");
+    }
+
+    kinds[handle] = kind;
+    calories[handle] = foodCalories;
+    keywordBegin[handle] = static_cast<uint32_t>(keywordPool.size());
+    keywordCount[handle] = static_cast<uint32_t>(keywords.size());
+    for (const std::string& keyword : keywords) {
+        addKeyword(keyword);
+    }
+    foodCount++;
+
+    // Appending in ID order keeps the ordered handle list valid without sorting
+    if (sortedValid.load(std::memory_order_relaxed) && !sorted.empty() && getId(sorted.back()) > id) {
+        sortedValid.store(false, std::memory_order_relaxed);
+    }
+    sorted.push_back(handle);
+
+    return handle;
+}
+
+/**
+ * addKeyword Method
+ * @param keyword A keyword to append to the keyword pool
+ */
+void FoodStore::addKeyword(std::string_view keyword) {
+    char* text = static_cast<char*>(keywordText.allocate(keyword.size(), 1));
+    std::copy(keyword.begin(), keyword.end(), text);
+    keywordPool.emplace_back(text, keyword.size());
+}
+
+/**
+ * addBasic Method
+ * @param id The ID of the new food
+ * @param keywords The keywords of the food
+ * @param foodCalories The calories per serving
+ * @return The handle of the new food
+ */
+FoodHandle FoodStore::addBasic(std::string_view id, std::vector<std::string> keywords, float foodCalories) {
+    return addFood(id, BASIC, keywords, foodCalories);
+}
+
+/**
+ * addComposite Method
+ * @param id The ID of the new composite food
+ * @param keywords The keywords of the food
+ * @param components Handles of the component foods with their servings
+ * @param foodCalories The total calories per serving
+ * @return The handle of the new food
+ * Repeated components are merged by adding their servings.
+ */
+FoodHandle FoodStore::addComposite(std::string_view id, std::vector<std::string> keywords,
+                                   const std::vector<std::pair<FoodHandle, float>>& components, float foodCalories) {
+    std::vector<std::pair<FoodHandle, float>> merged = components;
+    std::sort(merged.begin(), merged.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    FoodHandle handle = addFood(id, COMPOSITE, keywords, foodCalories);
+    componentBegin[handle] = static_cast<uint32_t>(componentFoodPool.size());
+    for (const auto& [food, servings] : merged) {
+        if (componentFoodPool.size() > componentBegin[handle] && componentFoodPool.back() == food) {
+            componentServingPool.back() += servings;
+        } else {
+            componentFoodPool.push_back(food);
+            componentServingPool.push_back(servings);
+        }
+    }
+    componentCount[handle] = static_cast<uint32_t>(componentFoodPool.size()) - componentBegin[handle];
+    return handle;
+}
+
+/**
+ * setCalories Method
+ * @param handle The handle of a stored food
+ * @param foodCalories The new calories per serving
+ */
+void FoodStore::setCalories(FoodHandle handle, float foodCalories) {
+    if (!contains(handle)) {
+        throw std::invalid_argument("Unknown food handle");
+    }
+    calories[handle] = foodCalories;
+
+    // Views are immutable; holders of the old one keep a consistent copy
+    std::atomic_store(&views[handle], std::shared_ptr<Food>());
+}
+
+/**
+ * reserve Method
+ * @param expectedFoods The number of foods expected to be stored
+ */
+void FoodStore::reserve(size_t expectedFoods) {
+    ids.reserve(expectedFoods);
+    kinds.reserve(expectedFoods);
+    calories.reserve(expectedFoods);
+    keywordBegin.reserve(expectedFoods);
+    keywordCount.reserve(expectedFoods);
+    componentBegin.reserve(expectedFoods);
+    componentCount.reserve(expectedFoods);
+    sorted.reserve(expectedFoods);
+    views.reserve(expectedFoods);
+}
+
+/**
+ * clear Method
+ * Removes all foods and frees the keyword text. Handles stay assigned, as log
+ * entries hold them.
+ */
+void FoodStore::clear() {
+    kinds.clear();
+    calories.clear();
+    keywordBegin.clear();
+    keywordCount.clear();
+    componentBegin.clear();
+    componentCount.clear();
+    keywordPool.clear();
+    keywordText.release();
+    componentFoodPool.clear();
+    componentServingPool.clear();
+    foodCount = 0;
+    sorted.clear();
+    sortedValid.store(true);
+    views.clear();
+}
+
+/**
+ * contains Method
+ * @param handle A food handle
+ * @return True if a food is stored for the handle
+ */
+bool FoodStore::contains(FoodHandle handle) const {
+    return handle < kinds.size() && kinds[handle] != NONE;
+}
+
+/**
+ * contains Method
+ * @param id A food ID
+ * @return True if a food with the ID is stored
+ */
+bool FoodStore::contains(std::string_view id) const {
+    return contains(find(id));
+}
+
+/**
+ * size Method
+ * @return The number of stored foods
+ */
+size_t FoodStore::size() const {
+    return foodCount;
+}
+
+/**
+ * isComposite Method
+ * @param handle The handle of a stored food
+ * @return True if the food is a composite food
+ */
+bool FoodStore::isComposite(FoodHandle handle) const {
+    return kinds[handle] == COMPOSITE;
+}
+
+/**
+ * getCalories Method
+ * @param handle The handle of a stored food
+ * @return The calories per serving of the food
+ */
+float FoodStore::getCalories(FoodHandle handle) const {
+    return calories[handle];
+}
+
+/**
+ * getKeywords Method
+ * @param handle The handle of a stored food
+ * @return A view of the food's keywords
+ */
+ConstSpan<std::string_view> FoodStore::getKeywords(FoodHandle handle) const {
+    const std::string_view* first = keywordPool.data() + keywordBegin[handle];
+    return {first, first + keywordCount[handle]};
+}
+
+/**
+ * getComponentFoods Method
+ * @param handle The handle of a stored food
+ * @return A view of the component handles (empty for basic foods)
+ */
+ConstSpan<FoodHandle> FoodStore::getComponentFoods(FoodHandle handle) const {
+    const FoodHandle* first = componentFoodPool.data() + componentBegin[handle];
+    return {first, first + componentCount[handle]};
+}
+
+/**
+ * getComponentServings Method
+ * @param handle The handle of a stored food
+ * @return A view of the component servings, parallel to getComponentFoods
+ */
+ConstSpan<float> FoodStore::getComponentServings(FoodHandle handle) const {
+    const float* first = componentServingPool.data() + componentBegin[handle];
+    return {first, first + componentCount[handle]};
+}
+
+/**
+ * entry Method
+ * @param handle The handle of a stored food
+ * @return A view of all data stored for the food
+ */
+FoodEntry FoodStore::entry(FoodHandle handle) const {
+    return {handle, getId(handle), isComposite(handle), calories[handle],
+            getKeywords(handle), getComponentFoods(handle), getComponentServings(handle)};
+}
+
+/**
+ * sortedHandles Method
+ * @return The handles of all stored foods, ordered by ID
+ * The list is sorted on first use after out-of-order insertions; concurrent
+ * readers wait for the one that sorts.
+ */
+const std::vector<FoodHandle>& FoodStore::sortedHandles() const {
+    if (!sortedValid.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(sortMutex);
+        if (!sortedValid.load(std::memory_order_relaxed)) {
+            // Resolve the names once; interned names never move
+            std::vector<std::pair<const std::string*, FoodHandle>> byId;
+            byId.reserve(sorted.size());
+            for (FoodHandle handle : sorted) {
+                byId.emplace_back(&getId(handle), handle);
+            }
+            std::sort(byId.begin(), byId.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+            for (size_t i = 0; i < byId.size(); i++) {
+                sorted[i] = byId[i].second;
+            }
+            sortedValid.store(true, std::memory_order_release);
+        }
+    }
+    return sorted;
+}
+
+/**
+ * view Method
+ * @param handle A food handle
+ * @return A shared Food object for the stored food, or nullptr if none is stored
+ * If several readers build the same view at once, the first one published wins.
+ */
+std::shared_ptr<Food> FoodStore::view(FoodHandle handle) const {
+    if (!contains(handle)) {
+        return nullptr;
+    }
+    std::shared_ptr<Food> cached = std::atomic_load(&views[handle]);
+    if (cached) {
+        return cached;
+    }
+
+    ConstSpan<std::string_view> keywords = getKeywords(handle);
+    std::vector<std::string> keywordList(keywords.begin(), keywords.end());
+
+    std::shared_ptr<Food> built;
+    if (kinds[handle] == BASIC) {
+        built = std::make_shared<BasicFood>(getId(handle), std::move(keywordList), calories[handle]);
+    } else {
+        auto composite = std::make_shared<CompositeFood>(getId(handle), std::move(keywordList));
+        ConstSpan<FoodHandle> foods = getComponentFoods(handle);
+        ConstSpan<float> servings = getComponentServings(handle);
+        for (size_t i = 0; i < foods.size(); i++) {
+            composite->addComponent(getId(foods[i]), servings[i]);
+        }
+        composite->setTotalCalories(calories[handle]);
+        built = composite;
+    }
+
+    if (std::atomic_compare_exchange_strong(&views[handle], &cached, built)) {
+        return built;
+    }
+    return cached;
+}
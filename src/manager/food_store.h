@@ -0,0 +1,130 @@
+/**
+ * @file food_store.h
+ * @brief Flat Storage Engine for the Food Database
+ *
+ * This file defines the FoodStore class which holds every food of the database in
+ * contiguous arrays instead of individually allocated objects. Food IDs are interned
+ * to dense handles by the process-wide FoodIds interner, and all per-food data is
+ * stored in struct-of-arrays form indexed by handle.
+ *
+ * Key components:
+ * - FoodEntry, a non-owning view of one stored food
+ * - FoodStore, the storage engine with lookups through an open-addressing hash map
+ *
+ * Shared Food objects are still available for existing callers: they are built
+ * from the arrays on first request and cached per handle.
+ *
+ * Thread safety: const methods, including copying the store, may run
+ * concurrently with each other, but not with a non-const method. Handed out Food views are never modified; updating
+ * a food drops its cached view, and the next request builds a new one.
+ */
+
+#ifndef FOOD_STORE_H
+#define FOOD_STORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <memory_resource>
+#include "../models/food.h"
+#include "../utils/food_ids.h"
+#include "../utils/const_span.h"
+
+using namespace std;
+
+/**
+ * FoodEntry struct
+ * A non-owning view of a food stored in a FoodStore
+ */
+struct FoodEntry {
+    FoodHandle handle;
+    const string& id;
+    bool composite;
+    float calories;
+    ConstSpan<string_view> keywords;
+    ConstSpan<FoodHandle> componentFoods;   // Empty for basic foods
+    ConstSpan<float> componentServings;     // Parallel to componentFoods
+};
+
+/**
+ * FoodStore Class
+ * This class stores foods in flat arrays indexed by interned handles.
+ */
+class FoodStore {
+public:
+    // Keyword text is allocated from the resource, in blocks released by clear()
+    explicit FoodStore(pmr::memory_resource* resource = pmr::get_default_resource());
+    // Copies the stored foods onto the heap but not the cached views, e.g. for saving in the background
+    FoodStore(const FoodStore& other);
+    FoodStore& operator=(const FoodStore&) = delete;
+
+    // Handles
+    FoodHandle intern(string_view id);
+    FoodHandle find(string_view id) const;
+    const string& getId(FoodHandle handle) const;
+    size_t handleCount() const;
+    size_t columnCount() const;
+
+    // Insertion and updates
+    FoodHandle addBasic(string_view id, vector<string> keywords, float calories);
+    FoodHandle addComposite(string_view id, vector<string> keywords,
+                            const vector<pair<FoodHandle, float>>& components, float calories);
+    void setCalories(FoodHandle handle, float calories);
+    void reserve(size_t expectedFoods);
+    void clear();
+
+    // Queries
+    bool contains(FoodHandle handle) const;
+    bool contains(string_view id) const;
+    size_t size() const;
+    bool isComposite(FoodHandle handle) const;
+    float getCalories(FoodHandle handle) const;
+    ConstSpan<string_view> getKeywords(FoodHandle handle) const;
+    ConstSpan<FoodHandle> getComponentFoods(FoodHandle handle) const;
+    ConstSpan<float> getComponentServings(FoodHandle handle) const;
+    FoodEntry entry(FoodHandle handle) const;
+
+    // Present foods ordered by ID
+    const vector<FoodHandle>& sortedHandles() const;
+
+    // Immutable shared Food view of a stored food, built on first use
+    shared_ptr<Food> view(FoodHandle handle) const;
+
+private:
+    enum Kind : uint8_t { NONE = 0, BASIC = 1, COMPOSITE = 2 };
+
+    // Handles are shared with the logs, so they outlive clear()
+    FoodIds& ids = FoodIds::getInstance();
+
+    // Per-handle columns (also sized for IDs that are only referenced elsewhere)
+    vector<uint8_t> kinds;
+    vector<float> calories;
+    vector<uint32_t> keywordBegin;
+    vector<uint32_t> keywordCount;
+    vector<uint32_t> componentBegin;
+    vector<uint32_t> componentCount;
+
+    // Shared pools the spans point into; keywords view characters in keywordText
+    pmr::monotonic_buffer_resource keywordText;
+    vector<string_view> keywordPool;
+    vector<FoodHandle> componentFoodPool;
+    vector<float> componentServingPool;
+
+    size_t foodCount = 0;
+    // Lazily maintained caches; readers update them concurrently
+    mutable vector<FoodHandle> sorted;
+    mutable atomic<bool> sortedValid{true};
+    mutable std::mutex sortMutex;
+    mutable vector<shared_ptr<Food>> views;   // Accessed with atomic_load/atomic_store
+
+    FoodHandle addFood(string_view id, Kind kind, const vector<string>& keywords, float calories);
+    void addKeyword(string_view keyword);
+    void ensureColumns(FoodHandle handle);
+};
+
+#endif // FOOD_STORE_H
@@ -0,0 +1,316 @@
+/**
+ * @file import_pipeline.cpp
+ * @brief Multi-Source Bulk Import Pipeline Implementation
+ *
+ * This file implements the ImportPipeline class defined in import_pipeline.h.
+ * Each stage is a group of long-running workers on a dedicated thread pool. The
+ * last worker of a stage to finish closes the queue feeding the next stage, so
+ * shutdown propagates down the pipeline once every source has been fetched.
+ *
+ * Key implementations:
+ * - Per-source fetch tasks that split large results into batches
+ * - Validation of fetched foods into FoodRecord batches
+ * - ID and keyword normalization with cross-source deduplication
+ * - Batched insertion on the calling thread with progress callbacks
+ * - Error collection that aborts the pipeline without leaving workers blocked
+ */
+
+#include "import_pipeline.h"
+#include "food_database.h"
+#include "food_json_reader.h"
+#include "search_index.h"
+#include "../utils/bounded_queue.h"
+#include "../utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+
+using FoodBatch = std::vector<std::shared_ptr<BasicFood>>;
+using RecordBatch = std::vector<FoodRecord>;
+
+/**
+ * ImportCounters struct
+ * Counters shared by all stages of one run
+ */
+struct ImportCounters {
+    std::atomic<size_t> sourcesFetched{0};
+    std::atomic<size_t> sourcesFailed{0};
+    std::atomic<size_t> fetched{0};
+    std::atomic<size_t> parsed{0};
+    std::atomic<size_t> rejected{0};
+    std::atomic<size_t> duplicates{0};
+    std::atomic<size_t> inserted{0};
+    std::atomic<size_t> batches{0};
+
+    std::mutex errorMutex;
+    std::vector<std::string> errors;
+
+    void addError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        errors.push_back(error);
+    }
+
+    ImportStats snapshot(std::chrono::steady_clock::time_point start) {
+        ImportStats stats;
+        stats.sourcesFetched = sourcesFetched.load();
+        stats.sourcesFailed = sourcesFailed.load();
+        stats.fetched = fetched.load();
+        stats.parsed = parsed.load();
+        stats.rejected = rejected.load();
+        stats.duplicates = duplicates.load();
+        stats.inserted = inserted.load();
+        stats.batches = batches.load();
+        stats.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            stats.errors = errors;
+        }
+        return stats;
+    }
+};
+
+/**
+ * normalizeKeywords Function
+ * @param keywords The keywords of a fetched food
+ * @return The keywords trimmed and lowercased, without empty entries or duplicates
+ */
+std::vector<std::string> normalizeKeywords(const std::vector<std::string>& keywords) {
+    std::vector<std::string> result;
+    result.reserve(keywords.size());
+    for (const auto& keyword : keywords) {
+        size_t begin = keyword.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        size_t end = keyword.find_last_not_of(" \t\r\n");
+        std::string normalized = SearchIndex::normalize(keyword.substr(begin, end - begin + 1));
+        if (std::find(result.begin(), result.end(), normalized) == result.end()) {
+            result.push_back(std::move(normalized));
+        }
+    }
+    return result;
+}
+
+/**
+ * resolveThreads Function
+ * @param requested The requested number of threads (0 for the default)
+ * @param fallback The default number of threads
+ * @return The number of threads to use for a stage
+ */
+size_t resolveThreads(size_t requested, size_t fallback) {
+    return std::max<size_t>(1, requested == 0 ? fallback : requested);
+}
+
+} // namespace
+
+/**
+ * itemsPerSecond Method
+ * @return The number of inserted foods per second of elapsed time
+ */
+double ImportStats::itemsPerSecond() const {
+    return milliseconds > 0.0 ? inserted * 1000.0 / milliseconds : 0.0;
+}
+
+/**
+ * ImportPipeline Constructor
+ * @param database The database the foods are imported into
+ * @param options Thread counts, queue capacity, batch size and progress callback
+ */
+ImportPipeline::ImportPipeline(FoodDatabase& database, ImportOptions options)
+    : database(database), options(std::move(options)) {
+    if (this->options.batchSize == 0) {
+        this->options.batchSize = 1;
+    }
+}
+
+/**
+ * run Method
+ * @param sources The data sources to import from, by name
+ * @param query The query passed to every data source
+ * @return The counters of the finished run
+ * Failing sources are recorded in the returned errors and do not stop the
+ * import. An error in any other stage aborts the run and is rethrown.
+ */
+ImportStats ImportPipeline::run(const std::vector<std::pair<std::string, FoodDataSource>>& sources,
+                                const std::string& query) {
+    auto start = std::chrono::steady_clock::now();
+    ImportCounters counters;
+    if (sources.empty()) {
+        return counters.snapshot(start);
+    }
+
+    size_t hardware = ThreadPool::defaultThreadCount();
+    size_t fetchThreads = resolveThreads(options.fetchThreads, std::min(sources.size(), hardware));
+    size_t parseThreads = resolveThreads(options.parseThreads, hardware / 2);
+    size_t normalizeThreads = resolveThreads(options.normalizeThreads, hardware / 2);
+
+    BoundedQueue<FoodBatch> fetchedQueue(options.queueCapacity);
+    BoundedQueue<RecordBatch> parsedQueue(options.queueCapacity);
+    BoundedQueue<RecordBatch> normalizedQueue(options.queueCapacity);
+
+    // The first unexpected error closes every queue so that all stages wind down
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    auto abortAll = [&](std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = error;
+            }
+        }
+        fetchedQueue.close();
+        parsedQueue.close();
+        normalizedQueue.close();
+    };
+    auto guarded = [&](std::function<void()> body) {
+        return [&abortAll, body]() {
+            try {
+                body();
+            } catch (...) {
+                abortAll(std::current_exception());
+            }
+        };
+    };
+
+    // IDs already claimed by an earlier batch of this run
+    std::mutex seenMutex;
+    std::unordered_set<std::string> seenIds;
+
+    std::atomic<size_t> nextSource{0};
+    std::atomic<size_t> fetchersLeft{fetchThreads};
+    std::atomic<size_t> parsersLeft{parseThreads};
+    std::atomic<size_t> normalizersLeft{normalizeThreads};
+    std::vector<std::future<void>> workers;
+
+    // Every stage worker is a long-running task, so the pool needs one thread per worker
+    ThreadPool pool(fetchThreads + parseThreads + normalizeThreads);
+
+    // Fetch stage: one source at a time per worker
+    for (size_t i = 0; i < fetchThreads; i++) {
+        workers.push_back(pool.submit(guarded([&]() {
+            for (size_t index = nextSource++; index < sources.size(); index = nextSource++) {
+                const auto& [name, source] = sources[index];
+                FoodBatch foods;
+                try {
+                    foods = source(query);
+                } catch (const std::exception& e) {
+                    counters.sourcesFailed++;
+                    counters.addError("Source '" + name + "': " + e.what());
+                    continue;
+                }
+                counters.sourcesFetched++;
+                counters.fetched += foods.size();
+
+                for (size_t offset = 0; offset < foods.size(); offset += options.batchSize) {
+                    size_t end = std::min(foods.size(), offset + options.batchSize);
+                    FoodBatch batch(std::make_move_iterator(foods.begin() + offset),
+                                    std::make_move_iterator(foods.begin() + end));
+                    if (!fetchedQueue.push(std::move(batch))) {
+                        return;
+                    }
+                }
+            }
+            if (--fetchersLeft == 0) {
+                fetchedQueue.close();
+            }
+        })));
+    }
+
+    // Parse stage: validate foods and flatten them into records
+    for (size_t i = 0; i < parseThreads; i++) {
+        workers.push_back(pool.submit(guarded([&]() {
+            FoodBatch batch;
+            while (fetchedQueue.pop(batch)) {
+                RecordBatch records;
+                records.reserve(batch.size());
+                for (const auto& food : batch) {
+                    float calories = food ? food->getCaloriesPerServing() : 0.0f;
+                    if (!food || !std::isfinite(calories) || calories < 0.0f ||
+                        (food->getId().empty() && food->getKeywords().empty())) {
+                        counters.rejected++;
+                        continue;
+                    }
+                    FoodRecord record;
+                    record.id = food->getId();
+                    record.keywords = food->getKeywords();
+                    record.calories = calories;
+                    records.push_back(std::move(record));
+                }
+                counters.parsed += records.size();
+                if (!records.empty() && !parsedQueue.push(std::move(records))) {
+                    return;
+                }
+            }
+            if (--parsersLeft == 0) {
+                parsedQueue.close();
+            }
+        })));
+    }
+
+    // Normalize stage: sanitize IDs and keywords, keep the first food per ID
+    for (size_t i = 0; i < normalizeThreads; i++) {
+        workers.push_back(pool.submit(guarded([&]() {
+            RecordBatch batch;
+            while (parsedQueue.pop(batch)) {
+                for (auto& record : batch) {
+                    record.keywords = normalizeKeywords(record.keywords);
+                    std::string base = record.id.empty() && !record.keywords.empty() ? record.keywords[0] : record.id;
+                    record.id = FoodDatabase::sanitizeForId(base);
+                }
+
+                RecordBatch unique;
+                unique.reserve(batch.size());
+                {
+                    std::lock_guard<std::mutex> lock(seenMutex);
+                    for (auto& record : batch) {
+                        if (record.id.empty()) {
+                            counters.rejected++;
+                        } else if (!seenIds.insert(record.id).second) {
+                            counters.duplicates++;
+                        } else {
+                            unique.push_back(std::move(record));
+                        }
+                    }
+                }
+                if (!unique.empty() && !normalizedQueue.push(std::move(unique))) {
+                    return;
+                }
+            }
+            if (--normalizersLeft == 0) {
+                normalizedQueue.close();
+            }
+        })));
+    }
+
+    // Insert stage: the calling thread is the only writer
+    try {
+        RecordBatch batch;
+        while (normalizedQueue.pop(batch)) {
+            size_t inserted = database.addImportedFoods(batch);
+            counters.inserted += inserted;
+            counters.duplicates += batch.size() - inserted;
+            counters.batches++;
+            if (options.onProgress) {
+                options.onProgress(counters.snapshot(start));
+            }
+        }
+    } catch (...) {
+        abortAll(std::current_exception());
+    }
+
+    for (auto& worker : workers) {
+        worker.wait();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    return counters.snapshot(start);
+}
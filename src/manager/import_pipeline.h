@@ -0,0 +1,85 @@
+/**
+ * @file import_pipeline.h
+ * @brief Multi-Source Bulk Import Pipeline
+ *
+ * This file defines the ImportPipeline class which pulls foods from several
+ * registered data sources at once and adds them to the FoodDatabase in batches.
+ * Work flows through four stages connected by bounded queues:
+ *
+ * - Fetch: calls each data source function (one source per task)
+ * - Parse: turns fetched foods into flat records and rejects invalid ones
+ * - Normalize: sanitizes IDs and keywords and drops duplicate IDs across sources
+ * - Insert: adds each batch to the database under its writer lock
+ *
+ * Fetch, parse and normalize run concurrently on a thread pool; the insert stage
+ * runs on the calling thread, so there is only ever a single writer. Bounded
+ * queues provide backpressure, keeping memory use proportional to the queue
+ * capacity rather than to the size of the import.
+ */
+
+#ifndef IMPORT_PIPELINE_H
+#define IMPORT_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include "../models/food.h"
+
+using namespace std;
+
+class FoodDatabase;
+
+// Function type of a registered food data source
+using FoodDataSource = function<vector<shared_ptr<BasicFood>>(const string&)>;
+
+/**
+ * ImportStats struct
+ * Progress and throughput counters of an import run
+ */
+struct ImportStats {
+    size_t sourcesFetched = 0;
+    size_t sourcesFailed = 0;
+    size_t fetched = 0;      // Foods returned by the sources
+    size_t parsed = 0;       // Foods that passed validation
+    size_t rejected = 0;     // Foods with invalid data or an empty ID
+    size_t duplicates = 0;   // Foods whose ID was already imported or stored
+    size_t inserted = 0;     // Foods added to the database
+    size_t batches = 0;      // Batches handed to the insert stage
+    double milliseconds = 0.0;
+    vector<string> errors;
+
+    double itemsPerSecond() const;
+};
+
+/**
+ * ImportOptions struct
+ * Tuning parameters for an import run (zero selects a default)
+ */
+struct ImportOptions {
+    size_t fetchThreads = 0;       // Default: one per source, up to the hardware threads
+    size_t parseThreads = 0;       // Default: half the hardware threads
+    size_t normalizeThreads = 0;   // Default: half the hardware threads
+    size_t queueCapacity = 8;      // Batches buffered between two stages
+    size_t batchSize = 1024;       // Foods per batch
+    function<void(const ImportStats&)> onProgress;   // Called after every inserted batch
+};
+
+/**
+ * ImportPipeline Class
+ * This class runs a staged, concurrent import from several data sources.
+ */
+class ImportPipeline {
+public:
+    ImportPipeline(FoodDatabase& database, ImportOptions options = ImportOptions());
+
+    ImportStats run(const vector<pair<string, FoodDataSource>>& sources, const string& query);
+
+private:
+    FoodDatabase& database;
+    ImportOptions options;
+};
+
+#endif // IMPORT_PIPELINE_H
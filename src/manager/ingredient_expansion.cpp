@@ -0,0 +1,153 @@
+/**
+ * @file ingredient_expansion.cpp
+ * @brief Flattened Basic Ingredients of Composite Foods Implementation
+ *
+ * This file implements the IngredientExpansion class defined in ingredient_expansion.h.
+ * Pending composites are expanded by a depth-first walk over their components, so
+ * every composite is expanded after the composites it uses and can copy their
+ * expansions scaled by its servings instead of walking them again.
+ *
+ * Key implementations:
+ * - Tracking of composites waiting to be expanded
+ * - Depth-first expansion with memoization and cycle guard
+ * - Merging of the ingredients of all components into one sorted array
+ */
+
+#include "ingredient_expansion.h"
+#include <algorithm>
+
+/**
+ * IngredientExpansion Constructor
+ * @param store The food store holding the composites' components
+ */
+IngredientExpansion::IngredientExpansion(const FoodStore& store) : store(store) {
+}
+
+/**
+ * clear Method
+ * Drops every expansion, as when all foods are removed.
+ */
+void IngredientExpansion::clear() {
+    begin.clear();
+    count.clear();
+    states.clear();
+    pool.clear();
+    pending.clear();
+    rebuildAll = false;
+    valid.store(true, std::memory_order_release);
+}
+
+/**
+ * addFood Method
+ * @param handle The handle of a food just added to the store
+ * @param hasDependents Whether composites added earlier refer to the food
+ * Queues a new composite for expansion. A food that earlier composites refer to
+ * changes their expansions, so they are all recomputed.
+ */
+void IngredientExpansion::addFood(FoodHandle handle, bool hasDependents) {
+    if (hasDependents) {
+        rebuildAll = true;
+        pending.clear();
+    } else if (store.isComposite(handle) && !rebuildAll) {
+        pending.push_back(handle);
+    }
+    if (rebuildAll || !pending.empty()) {
+        valid.store(false, std::memory_order_release);
+    }
+}
+
+/**
+ * getIngredients Method
+ * @param composite The handle of a composite food
+ * @return The basic foods in one serving of the composite with their servings,
+ *         sorted by handle; empty for basic or unknown foods
+ * The span stays valid until the next change to the database.
+ */
+ConstSpan<FoodServings> IngredientExpansion::getIngredients(FoodHandle composite) const {
+    if (!valid.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(expandMutex);
+        if (!valid.load(std::memory_order_relaxed)) {
+            expandPending();
+            valid.store(true, std::memory_order_release);
+        }
+    }
+    if (composite >= states.size() || states[composite] != EXPANDED) {
+        return {};
+    }
+    const FoodServings* first = pool.data() + begin[composite];
+    return {first, first + count[composite]};
+}
+
+/**
+ * expandPending Method
+ * Expands the queued composites, or every composite after a rebuild request.
+ */
+void IngredientExpansion::expandPending() const {
+    // Handles interned only by logs or undo records have no columns to read
+    size_t handles = store.columnCount();
+    if (rebuildAll) {
+        pool.clear();
+        states.assign(handles, PENDING);
+        pending.clear();
+        for (FoodHandle handle = 0; handle < handles; handle++) {
+            if (store.isComposite(handle)) {
+                pending.push_back(handle);
+            }
+        }
+        rebuildAll = false;
+    }
+    begin.resize(handles);
+    count.resize(handles);
+    states.resize(handles, PENDING);
+
+    for (FoodHandle composite : pending) {
+        expand(composite);
+    }
+    pending.clear();
+}
+
+/**
+ * expand Method
+ * @param composite The handle of a composite food
+ * Expands the composite's composite components first, then merges their scaled
+ * expansions and its basic components into the composite's own array.
+ */
+void IngredientExpansion::expand(FoodHandle composite) const {
+    if (states[composite] != PENDING) {
+        return;
+    }
+    states[composite] = EXPANDING;
+
+    ConstSpan<FoodHandle> foods = store.getComponentFoods(composite);
+    ConstSpan<float> servings = store.getComponentServings(composite);
+    std::vector<FoodServings> parts;
+    for (size_t i = 0; i < foods.size(); i++) {
+        FoodHandle food = foods[i];
+        if (!store.contains(food)) {
+            continue;
+        }
+        if (!store.isComposite(food)) {
+            parts.emplace_back(food, servings[i]);
+            continue;
+        }
+        expand(food);
+        // A component still being expanded closes a cycle
+        if (states[food] == EXPANDED) {
+            for (uint32_t j = begin[food]; j < begin[food] + count[food]; j++) {
+                parts.emplace_back(pool[j].first, pool[j].second * servings[i]);
+            }
+        }
+    }
+
+    std::sort(parts.begin(), parts.end(), [](const FoodServings& a, const FoodServings& b) { return a.first < b.first; });
+    begin[composite] = static_cast<uint32_t>(pool.size());
+    for (const FoodServings& part : parts) {
+        if (pool.size() > begin[composite] && pool.back().first == part.first) {
+            pool.back().second += part.second;
+        } else {
+            pool.push_back(part);
+        }
+    }
+    count[composite] = static_cast<uint32_t>(pool.size() - begin[composite]);
+    states[composite] = EXPANDED;
+}
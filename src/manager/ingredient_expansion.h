@@ -0,0 +1,70 @@
+/**
+ * @file ingredient_expansion.h
+ * @brief Flattened Basic Ingredients of Composite Foods
+ *
+ * This file defines the IngredientExpansion class which stores, for every
+ * composite food, the basic foods it is ultimately made of and how many servings
+ * of each one serving of the composite contains. Nested recipes are resolved once,
+ * so questions about ingredients become scans over a short sorted array instead of
+ * recursive lookups through the components of components.
+ *
+ * Key features:
+ * - One (basic food handle, servings) array per composite, sorted by handle, all
+ *   stored back to back in one pool
+ * - Expansions computed on first use, components before the composites using them
+ * - A new composite is expanded on its own; adding a food that existing
+ *   composites already refer to rebuilds every expansion
+ * - Cleared together with the calorie dependency graph when the database reloads
+ *
+ * Components missing from the database contribute nothing, and a component that
+ * closes a dependency cycle is skipped.
+ */
+
+#ifndef INGREDIENT_EXPANSION_H
+#define INGREDIENT_EXPANSION_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include "food_store.h"
+
+using namespace std;
+
+/**
+ * IngredientExpansion Class
+ * This class caches the flattened basic ingredients of composite foods.
+ */
+class IngredientExpansion {
+public:
+    explicit IngredientExpansion(const FoodStore& store);
+
+    // Maintenance; the caller holds the database's writer lock
+    void clear();
+    void addFood(FoodHandle handle, bool hasDependents);
+
+    // Queries; concurrent readers wait for the one computing pending expansions
+    ConstSpan<FoodServings> getIngredients(FoodHandle composite) const;
+
+private:
+    enum State : uint8_t { PENDING = 0, EXPANDING = 1, EXPANDED = 2 };
+
+    const FoodStore& store;
+
+    // Per-handle position and length in the pool, and expansion state
+    mutable vector<uint32_t> begin;
+    mutable vector<uint32_t> count;
+    mutable vector<uint8_t> states;
+    mutable vector<FoodServings> pool;
+
+    // Composites added since the last expansion, or all of them after a rebuild request
+    mutable vector<FoodHandle> pending;
+    mutable bool rebuildAll = false;
+    mutable atomic<bool> valid{true};
+    mutable std::mutex expandMutex;
+
+    void expandPending() const;
+    void expand(FoodHandle composite) const;
+};
+
+#endif // INGREDIENT_EXPANSION_H
@@ -0,0 +1,301 @@
+/**
+ * @file meal_planner.cpp
+ * @brief Meal Plans Hitting a Calorie Target Implementation
+ *
+ * This file implements the MealPlanner class defined in meal_planner.h. The
+ * foods are sorted by calories, highest first, and a plan picks them in that
+ * order. After a food with c calories, every food still to be picked has at
+ * most c calories, so a branch is cut as soon as even the maximum servings of
+ * c-calorie foods cannot reach the target, and the foods too large for the
+ * remaining room are skipped with a binary search. The room around the target
+ * starts at the tolerance and shrinks to the deviation of the worst plan a
+ * worker would return, so every plan found narrows the rest of the search.
+ *
+ * Key implementations:
+ * - Validation of the search bounds
+ * - Per-worker depth-first search keeping its own best plans, so workers share
+ *   nothing but the branch cursor, the bound and the cancellation flags
+ * - Cancellation checks between combinations, with the clock read every
+ *   thousand combinations
+ * - Merging of the workers' plans, closest to the target first
+ */
+
+#include "meal_planner.h"
+#include "../utils/thread_pool.h"
+#include "../utils/metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Combinations between two reads of the clock
+const uint64_t DEADLINE_CHECK_INTERVAL = 1024;
+
+/**
+ * Search struct
+ * The state shared by the workers of one search
+ */
+struct Search {
+    const std::vector<FoodCalories>& foods;   // Sorted by calories, highest first
+    const MealPlanOptions& options;
+    size_t rootEnd;                           // Foods after it cannot reach the target
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<size_t> nextRoot{0};
+    // Deviation of the worst plan a worker could return; only plans closer than it
+    // are still searched
+    std::atomic<float> bound;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> timedOut{false};
+
+    Search(const std::vector<FoodCalories>& foods, const MealPlanOptions& options,
+           std::chrono::steady_clock::time_point start)
+        : foods(foods), options(options), rootEnd(0), deadline(start + options.timeLimit),
+          bound(options.tolerance) {
+    }
+
+    /**
+     * tighten Method
+     * @param deviation The deviation of a worker's worst plan, with as many plans as requested
+     */
+    void tighten(float deviation) {
+        float current = bound.load(std::memory_order_relaxed);
+        while (deviation < current && !bound.compare_exchange_weak(current, deviation, std::memory_order_relaxed)) {
+        }
+        if (deviation <= options.goodEnough) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * deviation Function
+ * @return How far a plan's calories are from the target
+ */
+float deviation(const MealPlan& plan, float target) {
+    return std::fabs(plan.calories - target);
+}
+
+/**
+ * Worker Class
+ * One thread's share of a search
+ */
+class Worker {
+public:
+    explicit Worker(Search& search) : combinations(0), search(search) {
+    }
+
+    /**
+     * run Method
+     * Explores the plans starting with each food taken from the shared cursor.
+     */
+    void run() {
+        while (!search.stop.load(std::memory_order_relaxed)) {
+            size_t root = search.nextRoot.fetch_add(1, std::memory_order_relaxed);
+            if (root >= search.rootEnd) {
+                break;
+            }
+            exploreFood(root, search.options.maxFoods, 0.0f);
+        }
+    }
+
+    std::vector<MealPlan> best;   // Closest to the target first
+    uint64_t combinations;
+
+private:
+    Search& search;
+    std::vector<FoodServings> picks;
+
+    /**
+     * explore Method
+     * @param first The first food that may be picked next
+     * @param picksLeft How many more foods may be picked
+     * @param total The calories picked so far
+     */
+    void explore(size_t first, size_t picksLeft, float total) {
+        const std::vector<FoodCalories>& foods = search.foods;
+        float room = search.options.targetCalories + search.bound.load(std::memory_order_relaxed) - total;
+        auto fits = std::partition_point(foods.begin() + static_cast<std::ptrdiff_t>(first), foods.end(),
+                                         [room](const FoodCalories& food) { return food.calories > room; });
+        for (size_t j = static_cast<size_t>(fits - foods.begin()); j < foods.size(); j++) {
+            if (!exploreFood(j, picksLeft, total)) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * exploreFood Method
+     * @param index The food to pick
+     * @param picksLeft How many more foods may be picked, including this one
+     * @param total The calories picked so far
+     * @return False if the search stopped, or if neither this food nor any smaller
+     *         one can reach the target any more
+     */
+    bool exploreFood(size_t index, size_t picksLeft, float total) {
+        const FoodCalories& food = search.foods[index];
+        float maxServings = static_cast<float>(search.options.maxServings);
+        float bound = search.bound.load(std::memory_order_relaxed);
+        // No food after this one has more calories
+        if (total + maxServings * static_cast<float>(picksLeft) * food.calories < search.options.targetCalories - bound) {
+            return false;
+        }
+        for (size_t servings = 1; servings <= search.options.maxServings; servings++) {
+            float calories = total + static_cast<float>(servings) * food.calories;
+            if (calories > search.options.targetCalories + bound) {
+                break;
+            }
+            if (stopRequested()) {
+                return false;
+            }
+            picks.emplace_back(food.handle, static_cast<float>(servings));
+            record(calories);
+            if (picksLeft > 1 && index + 1 < search.foods.size()) {
+                explore(index + 1, picksLeft - 1, calories);
+            }
+            picks.pop_back();
+        }
+        return true;
+    }
+
+    /**
+     * record Method
+     * @param calories The calories of the current picks
+     * Keeps the current picks if they are among the worker's best plans, and
+     * tightens the bound once the worker has enough plans within the tolerance.
+     */
+    void record(float calories) {
+        float target = search.options.targetCalories;
+        float distance = std::fabs(calories - target);
+        if (best.size() == search.options.plans && distance >= deviation(best.back(), target)) {
+            return;
+        }
+        auto position = std::upper_bound(best.begin(), best.end(), distance,
+                                         [target](float d, const MealPlan& plan) { return d < deviation(plan, target); });
+        best.insert(position, MealPlan{picks, calories});
+        if (best.size() > search.options.plans) {
+            best.pop_back();
+        }
+        if (best.size() == search.options.plans) {
+            search.tighten(deviation(best.back(), target));
+        }
+    }
+
+    /**
+     * stopRequested Method
+     * @return Whether the search was cancelled or ran out of time
+     */
+    bool stopRequested() {
+        combinations++;
+        if (search.stop.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        if (combinations % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= search.deadline) {
+            search.timedOut.store(true, std::memory_order_relaxed);
+            search.stop.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+/**
+ * plan Method
+ * @param foods The foods that plans may use, with their calories per serving
+ * @param options The target and the bounds of the search
+ * @return The plans closest to the target, at most options.plans of them
+ * @throws invalid_argument if the options are out of range
+ */
+MealPlanResult MealPlanner::plan(const std::vector<FoodCalories>& foods, const MealPlanOptions& options) {
+    METRICS_TIMER("MealPlanner::plan");
+    if (!(options.targetCalories > 0.0f) || !std::isfinite(options.targetCalories)) {
+        throw std::invalid_argument("The calorie target must be a positive number");
+    }
+    if (!(options.tolerance >= 0.0f) || !std::isfinite(options.tolerance)) {
+        throw std::invalid_argument("The tolerance must be a non-negative number");
+    }
+    if (!(options.goodEnough >= 0.0f)) {
+        throw std::invalid_argument("The good-enough deviation must be a non-negative number");
+    }
+    if (options.maxFoods < 1 || options.maxFoods > MAX_FOODS) {
+        throw std::invalid_argument("Plans can have 1 to " + std::to_string(MAX_FOODS) + " foods");
+    }
+    if (options.maxServings < 1 || options.maxServings > MAX_SERVINGS) {
+        throw std::invalid_argument("Foods can have 1 to " + std::to_string(MAX_SERVINGS) + " servings");
+    }
+    if (options.plans < 1 || options.plans > MAX_PLANS) {
+        throw std::invalid_argument("Up to " + std::to_string(MAX_PLANS) + " plans can be requested");
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // Foods without calories add nothing to a plan, and foods over the target never fit
+    float low = options.targetCalories - options.tolerance;
+    float high = options.targetCalories + options.tolerance;
+    std::vector<FoodCalories> sorted;
+    sorted.reserve(foods.size());
+    for (const FoodCalories& food : foods) {
+        if (food.calories > 0.0f && food.calories <= high) {
+            sorted.push_back(food);
+        }
+    }
+    // Equal calories keep the order of the input
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const FoodCalories& a, const FoodCalories& b) { return a.calories > b.calories; });
+
+    Search search(sorted, options, start);
+    float reach = static_cast<float>(options.maxServings * options.maxFoods);
+    search.rootEnd = static_cast<size_t>(
+        std::partition_point(sorted.begin(), sorted.end(),
+                             [low, reach](const FoodCalories& food) { return reach * food.calories >= low; }) -
+        sorted.begin());
+
+    size_t threads = options.threads > 0 ? options.threads : ThreadPool::defaultThreadCount();
+    threads = std::max<size_t>(1, std::min(threads, search.rootEnd));
+    std::vector<Worker> workers(threads, Worker(search));
+    {
+        // The calling thread is one of the workers
+        std::unique_ptr<ThreadPool> pool;
+        std::vector<std::future<void>> running;
+        if (threads > 1) {
+            pool = std::make_unique<ThreadPool>(threads - 1);
+            for (size_t i = 1; i < threads; i++) {
+                running.push_back(pool->submit([&worker = workers[i]]() { worker.run(); }));
+            }
+        }
+        workers[0].run();
+        for (auto& worker : running) {
+            worker.get();
+        }
+    }
+
+    MealPlanResult result;
+    result.candidates = sorted.size();
+    for (Worker& worker : workers) {
+        result.combinations += worker.combinations;
+        result.plans.insert(result.plans.end(), worker.best.begin(), worker.best.end());
+    }
+    float target = options.targetCalories;
+    std::sort(result.plans.begin(), result.plans.end(), [target](const MealPlan& a, const MealPlan& b) {
+        float da = deviation(a, target);
+        float db = deviation(b, target);
+        if (da != db) {
+            return da < db;
+        }
+        if (a.foods.size() != b.foods.size()) {
+            return a.foods.size() < b.foods.size();
+        }
+        return a.foods < b.foods;
+    });
+    if (result.plans.size() > options.plans) {
+        result.plans.resize(options.plans);
+    }
+    result.complete = !search.stop.load();
+    result.timedOut = search.timedOut.load();
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
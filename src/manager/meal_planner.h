@@ -0,0 +1,88 @@
+/**
+ * @file meal_planner.h
+ * @brief Meal Plans Hitting a Calorie Target
+ *
+ * This file defines the MealPlanner class which searches combinations of foods
+ * whose calories add up to a target, so a day can be planned in one command
+ * instead of searching and adding foods until the calorie summary is close.
+ * A plan is a set of distinct foods, each with a whole number of servings.
+ *
+ * Key features:
+ * - Depth-first branch-and-bound over the foods sorted by calories, pruning
+ *   every branch that can no longer beat the plans found so far, or reach the
+ *   target within the tolerance
+ * - Parallel search: workers take the next unexplored top-level branch from a
+ *   shared cursor, so an idle worker always finds work while others are busy
+ *   with large subtrees
+ * - Early cancellation of all workers once enough good-enough plans (within
+ *   half a calorie by default) are found, or when the time limit runs out
+ * - The closest plans found are returned even if none is within the tolerance
+ *
+ * With early cancellation, which of several equally good plans are found can
+ * depend on the scheduling of the workers.
+ */
+
+#ifndef MEAL_PLANNER_H
+#define MEAL_PLANNER_H
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "food_database.h"
+#include "../utils/food_ids.h"
+
+using namespace std;
+
+/**
+ * MealPlanOptions struct
+ * The target of a meal plan search and its bounds
+ */
+struct MealPlanOptions {
+    float targetCalories = 0.0f;
+    float tolerance = 50.0f;            // Plans within target ± tolerance are acceptable
+    float goodEnough = 0.5f;            // The search stops once all plans are this close
+    size_t maxFoods = 4;                // Distinct foods per plan
+    size_t maxServings = 3;             // Servings of each food
+    size_t plans = 3;                   // Plans to return
+    size_t threads = 0;                 // 0 for one per core
+    chrono::milliseconds timeLimit{50}; // From the start of the call
+};
+
+/**
+ * MealPlan struct
+ * Foods with their servings, and the calories they add up to
+ */
+struct MealPlan {
+    vector<FoodServings> foods;
+    float calories = 0.0f;
+};
+
+/**
+ * MealPlanResult struct
+ * The best plans of a search, closest to the target first, and how it ended
+ */
+struct MealPlanResult {
+    vector<MealPlan> plans;
+    size_t candidates = 0;      // Foods with calories that could be used
+    uint64_t combinations = 0;  // Combinations tried
+    bool complete = false;      // Whether every combination was tried or pruned
+    bool timedOut = false;
+    double milliseconds = 0.0;
+};
+
+/**
+ * MealPlanner Class
+ * This class finds combinations of foods adding up to a calorie target.
+ */
+class MealPlanner {
+public:
+    static const size_t MAX_FOODS = 8;
+    static const size_t MAX_SERVINGS = 10;
+    static const size_t MAX_PLANS = 20;
+
+    // @throws invalid_argument if the options are out of range
+    static MealPlanResult plan(const vector<FoodCalories>& foods, const MealPlanOptions& options);
+};
+
+#endif // MEAL_PLANNER_H
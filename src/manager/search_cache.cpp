@@ -0,0 +1,146 @@
+/**
+ * @file search_cache.cpp
+ * @brief LRU Cache of Food Search Results Implementation
+ *
+ * This file implements the SearchCache class defined in search_cache.h. Cached
+ * queries are kept in a list ordered by last use, with a hash index into it, so
+ * lookups, promotion and eviction take O(1).
+ *
+ * Key implementations:
+ * - Query normalization into cache keys
+ * - Version check of cached results
+ * - Eviction of the least recently used queries
+ */
+
+#include "search_cache.h"
+#include "search_index.h"
+#include <algorithm>
+
+/**
+ * SearchCache Constructor
+ * @param capacity The maximum number of cached queries (0 disables the cache)
+ */
+SearchCache::SearchCache(size_t capacity)
+    : capacity(capacity), hits(0), misses(0), evictions(0) {
+}
+
+/**
+ * makeKey Method
+ * @param keywords The keywords of a search
+ * @param matchAll Whether all keywords must match (AND) or at least one (OR)
+ * @return The cache key of the search
+ * Keyword order, case and repetitions do not change the results of a search, so
+ * they do not change the key either.
+ */
+std::string SearchCache::makeKey(const std::vector<std::string>& keywords, bool matchAll) {
+    std::vector<std::string> normalized;
+    normalized.reserve(keywords.size());
+    for (const auto& keyword : keywords) {
+        normalized.push_back(SearchIndex::normalize(keyword));
+    }
+    std::sort(normalized.begin(), normalized.end());
+    normalized.erase(std::unique(normalized.begin(), normalized.end()), normalized.end());
+
+    std::string key = matchAll ? "all" : "any";
+    for (const auto& keyword : normalized) {
+        // Length-prefixed, so no keyword can pass for two
+        key += ' ' + std::to_string(keyword.size()) + ':' + keyword;
+    }
+    return key;
+}
+
+/**
+ * find Method
+ * @param key The cache key of a search
+ * @param version The current database version
+ * @param handles Receives the cached results
+ * @param byId Receives whether the results are sorted by ID
+ * @return Whether results computed at this version were cached
+ */
+bool SearchCache::find(const std::string& key, uint64_t version, std::vector<FoodHandle>& handles, bool& byId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return false;
+    }
+    if (it->second->version != version) {
+        // The database changed since; the results would have to be recomputed anyway
+        recent.erase(it->second);
+        index.erase(it);
+        misses++;
+        return false;
+    }
+    hits++;
+    recent.splice(recent.begin(), recent, it->second);
+    handles = recent.front().handles;
+    byId = recent.front().byId;
+    return true;
+}
+
+/**
+ * insert Method
+ * @param key The cache key of a search
+ * @param version The database version the results were computed at
+ * @param handles The results
+ * @param byId Whether the results are sorted by ID
+ */
+void SearchCache::insert(const std::string& key, uint64_t version, const std::vector<FoodHandle>& handles, bool byId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) {
+        return;
+    }
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another search computed the same results first, or they are now sorted by ID
+        it->second->version = version;
+        it->second->handles = handles;
+        it->second->byId = byId;
+        recent.splice(recent.begin(), recent, it->second);
+        return;
+    }
+    recent.push_front({key, version, handles, byId});
+    index[key] = recent.begin();
+    evictLocked();
+}
+
+/**
+ * clear Method
+ * Drops all cached queries. The counters are kept.
+ */
+void SearchCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recent.clear();
+    index.clear();
+}
+
+/**
+ * setCapacity Method
+ * @param queries The maximum number of cached queries (0 disables the cache)
+ */
+void SearchCache::setCapacity(size_t queries) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = queries;
+    evictLocked();
+}
+
+/**
+ * getStats Method
+ * @return The cache counters
+ */
+SearchCacheStats SearchCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {recent.size(), capacity, hits, misses, evictions};
+}
+
+/**
+ * evictLocked Method
+ * Drops least recently used queries until the cache fits its capacity.
+ */
+void SearchCache::evictLocked() {
+    while (recent.size() > capacity) {
+        index.erase(recent.back().key);
+        recent.pop_back();
+        evictions++;
+    }
+}
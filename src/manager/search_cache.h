@@ -0,0 +1,97 @@
+/**
+ * @file search_cache.h
+ * @brief LRU Cache of Food Search Results
+ *
+ * This file defines the SearchCache class which FoodDatabase puts in front of its
+ * keyword index. Clients tend to repeat the same few searches, and a cached result
+ * saves the posting-list merge and the sort by ID.
+ *
+ * Key features:
+ * - Queries keyed on their normalized, sorted and deduplicated keywords plus the
+ *   AND/OR flag, so "Apple fruit" and "fruit apple apple" share an entry
+ * - Bounded number of entries, the least recently used evicted first
+ * - Entries tagged with the database version they were computed at; an entry of
+ *   an older version is dropped on lookup instead of being returned
+ * - Hit, miss and eviction counters for sizing the cache
+ * - Thread-safe: lookups from concurrent searches serialize on a mutex of its own
+ *
+ * Results are stored as food handles, sorted by ID unless only ranked searches,
+ * which need no ID order, have used them so far. Food objects are built from
+ * them on every search, so they always show the current calories.
+ */
+
+#ifndef SEARCH_CACHE_H
+#define SEARCH_CACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "../utils/food_ids.h"
+
+using namespace std;
+
+/**
+ * SearchCacheStats struct
+ * Counters of the search result cache
+ */
+struct SearchCacheStats {
+    size_t entries;
+    size_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+/**
+ * SearchCache Class
+ * This class keeps the results of recent food searches.
+ */
+class SearchCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 128;
+
+    explicit SearchCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // The key shared by all spellings of a query
+    static string makeKey(const vector<string>& keywords, bool matchAll);
+
+    // Lookup and insertion of the results computed at a database version
+    bool find(const string& key, uint64_t version, vector<FoodHandle>& handles, bool& byId);
+    void insert(const string& key, uint64_t version, const vector<FoodHandle>& handles, bool byId);
+    void clear();
+
+    // Cache size, in queries (0 disables the cache)
+    void setCapacity(size_t queries);
+    SearchCacheStats getStats() const;
+
+private:
+    /**
+     * Entry struct
+     * The results of one query
+     */
+    struct Entry {
+        string key;
+        uint64_t version;
+        vector<FoodHandle> handles;
+        bool byId;
+    };
+
+    mutable std::mutex mutex;
+    size_t capacity;
+
+    // Cached queries, most recently used first
+    list<Entry> recent;
+    unordered_map<string, list<Entry>::iterator> index;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+
+    void evictLocked();
+};
+
+#endif // SEARCH_CACHE_H
@@ -0,0 +1,346 @@
+/**
+ * @file search_index.cpp
+ * @brief Inverted Keyword Index Implementation
+ *
+ * This file implements the SearchIndex class defined in search_index.h.
+ * It keeps a dictionary of normalized keywords with posting lists of documents,
+ * plus an n-gram index over the dictionary so that substring queries only have to
+ * look at candidate terms instead of every food.
+ *
+ * Key implementations:
+ * - Keyword normalization and term interning
+ * - N-gram extraction for substring lookups
+ * - Candidate term lookup with verification for long queries
+ * - Sorted posting-list intersection (AND) and union (OR)
+ * - Relevance scoring of matches
+ *
+ * Posting lists are kept sorted. Terms receive increasing ids and documents are
+ * usually added in increasing handle order, so new entries are almost always
+ * appended at the end.
+ */
+
+#include "search_index.h"
+#include "../utils/load_arena.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+/**
+ * SearchIndex Constructor
+ * @param resource The memory resource of the dictionary and the posting lists
+ */
+SearchIndex::SearchIndex(std::pmr::memory_resource* resource)
+    : documents(resource), termText(resource), termIds(resource), terms(resource),
+      termPostings(resource), gramPostings(resource) {
+}
+
+/**
+ * clear Method
+ * Removes all documents and terms from the index, freeing the memory of the
+ * dictionary and the posting lists.
+ */
+void SearchIndex::clear() {
+    LoadArena::reset(documents);
+    LoadArena::reset(termIds);
+    LoadArena::reset(terms);
+    termText.release();
+    LoadArena::reset(termPostings);
+    LoadArena::reset(gramPostings);
+}
+
+/**
+ * size Method
+ * @return The number of indexed documents
+ */
+size_t SearchIndex::size() const {
+    return documents.size();
+}
+
+/**
+ * normalize Method
+ * @param keyword The keyword to normalize
+ * @return The keyword converted to lowercase
+ */
+std::string SearchIndex::normalize(const std::string& keyword) {
+    std::string result = keyword;
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+namespace {
+
+/**
+ * lowerAscii Function
+ * @param c A character
+ * @return The character in lowercase, as std::tolower converts it in the "C" locale
+ */
+inline char lowerAscii(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * matchQuality Function
+ * @param query A normalized query keyword
+ * @param keyword A food keyword, in any case
+ * @return 3 if the keyword equals the query, 2 if it starts with it, 1 if it
+ *         contains it and 0 otherwise (all ignoring case)
+ */
+int matchQuality(const std::string& query, std::string_view keyword) {
+    if (query.size() > keyword.size()) {
+        return 0;
+    }
+    // std::equal passes (query char, keyword char), std::search (keyword char, query char)
+    auto queryEqualLower = [](char q, char k) { return lowerAscii(k) == q; };
+    auto keywordEqualLower = [](char k, char q) { return lowerAscii(k) == q; };
+    if (std::equal(query.begin(), query.end(), keyword.begin(), queryEqualLower)) {
+        return query.size() == keyword.size() ? 3 : 2;
+    }
+    return std::search(keyword.begin() + 1, keyword.end(), query.begin(), query.end(), keywordEqualLower) != keyword.end() ? 1 : 0;
+}
+
+/**
+ * spanOf Function
+ * @param list A list of ids
+ * @return A view of the list
+ */
+template <typename List>
+ConstSpan<uint32_t> spanOf(const List& list) {
+    return {list.data(), list.data() + list.size()};
+}
+
+} // namespace
+
+/**
+ * score Method
+ * @param normalizedQueries The normalized query keywords
+ * @param keywords The keywords of a food
+ * @return The sum over the query keywords of their best match quality (see
+ *         matchQuality) plus the fraction of the food's keywords matched by any
+ *         query keyword, so of two equally good matches the food with fewer
+ *         unrelated keywords ranks first
+ */
+float SearchIndex::score(const std::vector<std::string>& normalizedQueries, ConstSpan<std::string_view> keywords) {
+    if (keywords.empty()) {
+        return 0.0f;
+    }
+    int quality = 0;
+    // Keywords matched by any query: the first 64 in a mask, the rest counted separately
+    uint64_t matched = 0;
+    for (const auto& query : normalizedQueries) {
+        int best = 0;
+        for (size_t i = 0; i < keywords.size(); i++) {
+            int match = matchQuality(query, keywords[i]);
+            best = std::max(best, match);
+            if (match > 0 && i < 64) {
+                matched |= uint64_t(1) << i;
+            }
+        }
+        quality += best;
+    }
+    size_t covered = static_cast<size_t>(__builtin_popcountll(matched));
+    for (size_t i = 64; i < keywords.size(); i++) {
+        if (std::any_of(normalizedQueries.begin(), normalizedQueries.end(),
+                        [&](const std::string& query) { return matchQuality(query, keywords[i]) > 0; })) {
+            covered++;
+        }
+    }
+    return static_cast<float>(quality) + static_cast<float>(covered) / keywords.size();
+}
+
+/**
+ * addDocument Method
+ * @param doc The handle of the food being indexed
+ * @param keywords The keywords of the food
+ * Adds a food to the index. Each food must only be added once.
+ */
+void SearchIndex::addDocument(DocId doc, ConstSpan<std::string_view> keywords) {
+    insertSorted(documents, doc);
+
+    for (std::string_view keyword : keywords) {
+        // Like normalize, but reusing the buffer's capacity
+        normalizedKeyword.assign(keyword.begin(), keyword.end());
+        for (char& c : normalizedKeyword) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        // A food may repeat a keyword; insertSorted keeps the list free of duplicates
+        insertSorted(termPostings[internTerm(normalizedKeyword)], doc);
+    }
+}
+
+/**
+ * insertSorted Method
+ * @param list A sorted list of ids
+ * @param id The id to insert
+ * Inserts the id at its sorted position unless it is already present.
+ */
+void SearchIndex::insertSorted(std::pmr::vector<DocId>& list, DocId id) {
+    if (list.empty() || list.back() < id) {
+        list.push_back(id);
+        return;
+    }
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it == list.end() || *it != id) {
+        list.insert(it, id);
+    }
+}
+
+/**
+ * internTerm Method
+ * @param term The normalized term
+ * @return The id of the term, registering it and its n-grams if it is new
+ */
+SearchIndex::TermId SearchIndex::internTerm(std::string_view term) {
+    auto it = termIds.find(term);
+    if (it != termIds.end()) {
+        return it->second;
+    }
+
+    char* text = static_cast<char*>(termText.allocate(term.size(), 1));
+    std::copy(term.begin(), term.end(), text);
+    std::string_view stored(text, term.size());
+
+    TermId id = static_cast<TermId>(terms.size());
+    termIds.emplace(stored, id);
+    terms.push_back(stored);
+    termPostings.emplace_back();
+
+    // Register every n-gram of the new term
+    for (size_t len = 1; len <= MAX_GRAM; len++) {
+        for (size_t pos = 0; pos + len <= term.size(); pos++) {
+            auto& postings = gramPostings[std::string(term.substr(pos, len))];
+            if (postings.empty() || postings.back() != id) {
+                postings.push_back(id);
+            }
+        }
+    }
+
+    return id;
+}
+
+/**
+ * findTerms Method
+ * @param normalizedQuery The normalized query keyword
+ * @return Sorted ids of all terms containing the query as a substring
+ */
+std::vector<SearchIndex::TermId> SearchIndex::findTerms(const std::string& normalizedQuery) const {
+    if (normalizedQuery.empty()) {
+        // An empty keyword is a substring of every term
+        std::vector<TermId> all(terms.size());
+        for (TermId t = 0; t < all.size(); t++) {
+            all[t] = t;
+        }
+        return all;
+    }
+
+    // Short queries are n-grams themselves, so their posting list is exact
+    if (normalizedQuery.size() <= MAX_GRAM) {
+        auto it = gramPostings.find(normalizedQuery);
+        return it != gramPostings.end() ? std::vector<TermId>(it->second.begin(), it->second.end()) : std::vector<TermId>();
+    }
+
+    // Longer queries: intersect the posting lists of all their trigrams,
+    // starting from the rarest one, then verify the remaining candidates
+    std::vector<const std::pmr::vector<TermId>*> lists;
+    for (size_t pos = 0; pos + MAX_GRAM <= normalizedQuery.size(); pos++) {
+        auto it = gramPostings.find(normalizedQuery.substr(pos, MAX_GRAM));
+        if (it == gramPostings.end()) {
+            return {};
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    std::vector<TermId> candidates(lists.front()->begin(), lists.front()->end());
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+        candidates = intersect(spanOf(candidates), spanOf(*lists[i]));
+    }
+
+    std::vector<TermId> result;
+    for (TermId t : candidates) {
+        if (terms[t].find(normalizedQuery) != std::string_view::npos) {
+            result.push_back(t);
+        }
+    }
+    return result;
+}
+
+/**
+ * matchKeyword Method
+ * @param normalizedQuery The normalized query keyword
+ * @return Sorted ids of all documents with a keyword containing the query
+ */
+std::vector<SearchIndex::DocId> SearchIndex::matchKeyword(const std::string& normalizedQuery) const {
+    std::vector<TermId> matchingTerms = findTerms(normalizedQuery);
+    if (matchingTerms.size() == 1) {
+        const std::pmr::vector<DocId>& postings = termPostings[matchingTerms.front()];
+        return std::vector<DocId>(postings.begin(), postings.end());
+    }
+
+    // Merge the posting lists of all matching terms
+    std::vector<DocId> result;
+    for (TermId t : matchingTerms) {
+        result.insert(result.end(), termPostings[t].begin(), termPostings[t].end());
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+/**
+ * search Method
+ * @param keywords The keywords to search for
+ * @param matchAll Whether all keywords must match (AND) or at least one (OR)
+ * @return The handles of the matching foods, sorted by handle
+ */
+std::vector<SearchIndex::DocId> SearchIndex::search(const std::vector<std::string>& keywords, bool matchAll) const {
+    if (keywords.empty()) {
+        return std::vector<DocId>(documents.begin(), documents.end());
+    }
+
+    std::vector<DocId> docs;
+    bool first = true;
+    for (const auto& keyword : keywords) {
+        std::vector<DocId> matches = matchKeyword(normalize(keyword));
+        if (first) {
+            docs = std::move(matches);
+            first = false;
+        } else if (matchAll) {
+            docs = intersect(spanOf(docs), spanOf(matches));
+        } else {
+            docs = unite(spanOf(docs), spanOf(matches));
+        }
+
+        if (matchAll && docs.empty()) {
+            break;
+        }
+    }
+    return docs;
+}
+
+/**
+ * intersect Method
+ * @param a A sorted list of ids
+ * @param b A sorted list of ids
+ * @return The sorted ids present in both lists
+ */
+std::vector<SearchIndex::DocId> SearchIndex::intersect(ConstSpan<DocId> a, ConstSpan<DocId> b) {
+    std::vector<DocId> result;
+    result.reserve(std::min(a.size(), b.size()));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+/**
+ * unite Method
+ * @param a A sorted list of ids
+ * @param b A sorted list of ids
+ * @return The sorted ids present in either list
+ */
+std::vector<SearchIndex::DocId> SearchIndex::unite(ConstSpan<DocId> a, ConstSpan<DocId> b) {
+    std::vector<DocId> result;
+    result.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file search_index.h
+ * @brief Inverted Keyword Index for Food Searches
+ *
+ * This file defines the SearchIndex class which FoodDatabase uses to answer keyword
+ * searches without scanning every food. Keywords are normalized once when a food is
+ * indexed, and each distinct keyword (term) keeps a sorted posting list of the foods
+ * that carry it.
+ *
+ * Key features:
+ * - Normalized (lowercase) term dictionary with per-term posting lists
+ * - N-gram (1 to 3 characters) index over terms for substring matching
+ * - AND/OR queries evaluated as sorted posting-list intersection and union
+ * - Incremental updates as foods are added to the database
+ * - Relevance scores for ranking matches: exact keyword > prefix > substring,
+ *   plus the share of the food's keywords that matched
+ *
+ * The index preserves the original search semantics: a query keyword matches a food
+ * when it is a case-insensitive substring of any of the food's keywords.
+ *
+ * The dictionary and the posting lists allocate from a memory resource given at
+ * construction, such as the database's LoadArena, so that the many small lists
+ * built while loading share a few large blocks. The characters of the terms are
+ * bump-allocated from it as well. clear() frees all of their memory.
+ */
+
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory_resource>
+#include <cstdint>
+#include "../utils/const_span.h"
+
+using namespace std;
+
+/**
+ * SearchIndex Class
+ * This class maintains an inverted index from keywords to food handles.
+ */
+class SearchIndex {
+public:
+    using DocId = uint32_t;
+    using TermId = uint32_t;
+
+    explicit SearchIndex(pmr::memory_resource* resource = pmr::get_default_resource());
+
+    // Index maintenance
+    void clear();
+    void addDocument(DocId doc, ConstSpan<string_view> keywords);
+    size_t size() const;
+
+    // Queries (results are sorted by DocId)
+    vector<DocId> search(const vector<string>& keywords, bool matchAll = true) const;
+
+    // Normalization shared with callers that need to compare keywords
+    static string normalize(const string& keyword);
+    
+    // Relevance of a food's keywords to normalized query keywords (0 if none match)
+    static float score(const vector<string>& normalizedQueries, ConstSpan<string_view> keywords);
+
+private:
+    // Indexed documents (food handles), sorted
+    pmr::vector<DocId> documents;
+
+    // Term dictionary and per-term sorted posting lists of DocIds; the terms
+    // view characters in termText
+    pmr::monotonic_buffer_resource termText;
+    pmr::unordered_map<string_view, TermId> termIds;
+    pmr::vector<string_view> terms;
+    pmr::vector<pmr::vector<DocId>> termPostings;
+    
+    // Buffer for normalizing keywords as they are indexed
+    string normalizedKeyword;
+
+    // N-grams (length 1 to MAX_GRAM) of every term -> sorted TermIds
+    static const size_t MAX_GRAM = 3;
+    pmr::unordered_map<string, pmr::vector<TermId>> gramPostings;
+
+    // Helper methods
+    TermId internTerm(string_view term);
+    vector<TermId> findTerms(const string& normalizedQuery) const;
+    vector<DocId> matchKeyword(const string& normalizedQuery) const;
+
+    static void insertSorted(pmr::vector<DocId>& list, DocId id);
+
+    static vector<DocId> intersect(ConstSpan<DocId> a, ConstSpan<DocId> b);
+    static vector<DocId> unite(ConstSpan<DocId> a, ConstSpan<DocId> b);
+};
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,315 @@
+/**
+ * @file tenant_manager.cpp
+ * @brief Per-User Data Management Implementation
+ *
+ * This file implements the Tenant struct and the TenantManager class defined in
+ * tenant_manager.h. Loaded users are kept in a list ordered by last use, with a
+ * hash index into it, so lookups, promotion and eviction take O(1).
+ *
+ * Key implementations:
+ * - Loading a user: profile, monthly log files and replay of the user's journal
+ * - Saving a user: the journal is synced, or the changed log files are rewritten
+ * - Eviction of the least recently used users that nobody holds
+ * - Creation of new users in their own directories
+ */
+
+#include "tenant_manager.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Tenant Constructor
+ * @param userId The user's ID
+ * @param directory The directory holding the user's files
+ */
+Tenant::Tenant(const std::string& userId, const std::string& directory)
+    : userId(userId),
+      directory(directory),
+      profile(directory + "/user.json"),
+      logHistory(directory + "/logs", directory + "/logs.json"),
+      journal(directory + "/journal.log") {
+    // Nobody can answer a prompt for another user's profile
+    profile.setInteractive(false);
+    logHistory.setLazyLoading(true);
+}
+
+/**
+ * load Method
+ * @param foodDb The shared food database, used to count the logged calories
+ * @throws runtime_error if the user has no valid profile or the files are invalid
+ */
+void Tenant::load(FoodDatabase& foodDb) {
+    // Stop journaling while the files and the journal are read back
+    logHistory.setJournal(nullptr);
+    journal.close();
+
+    profile.loadUser();
+    profile.getUser();
+
+    logHistory.setCalorieSource(
+        [&foodDb](ConstSpan<FoodServings> servings) { return foodDb.calculateTotalCalories(servings); },
+        [&foodDb]() { return foodDb.getCalorieVersion(); });
+    logHistory.loadFromFiles();
+
+    // The user's journal only holds log changes; food changes are journaled globally
+    journal.replay([this](const json& record) { logHistory.applyJournalRecord(record); });
+    journal.open();
+    logHistory.setJournal(&journal);
+}
+
+/**
+ * flush Method
+ * Saves the user's changes, like the save command does for the default user.
+ */
+void Tenant::flush() {
+    if (profile.isDirty()) {
+        profile.saveUser();
+    }
+    if (journal.needsCompaction()) {
+        logHistory.saveToFiles();
+        journal.reset();
+    } else {
+        journal.commit();
+    }
+}
+
+/**
+ * discardUncommitted Method
+ * Drops the profile and log changes made since the user was last saved.
+ */
+void Tenant::discardUncommitted() {
+    profile.discardChanges();
+    journal.discardUncommitted();
+}
+
+/**
+ * TenantManager Constructor
+ * @param foodDb The food database shared by all users
+ * @param rootDirectory The directory holding one subdirectory per user
+ * @param capacity The maximum number of users kept loaded
+ */
+TenantManager::TenantManager(FoodDatabase& foodDb, const std::string& rootDirectory, size_t capacity)
+    : foodDb(foodDb), rootDirectory(rootDirectory), capacity(capacity == 0 ? 1 : capacity),
+      hits(0), misses(0), evictions(0) {
+}
+
+/**
+ * acquire Method
+ * @param userId A user's ID
+ * @return The user's data, loaded from disk if it was not in the cache
+ * @throws invalid_argument if the user does not exist
+ * @throws runtime_error if the user's files cannot be loaded
+ */
+std::shared_ptr<Tenant> TenantManager::acquire(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(userId);
+    if (it != index.end()) {
+        hits++;
+        recent.splice(recent.begin(), recent, it->second);
+        return recent.front();
+    }
+
+    misses++;
+    if (!isValidUserId(userId) || !std::filesystem::exists(userDirectory(userId) + "/user.json")) {
+        throw std::invalid_argument("Unknown user: " + userId);
+    }
+    auto tenant = std::make_shared<Tenant>(userId, userDirectory(userId));
+    tenant->load(foodDb);
+    return insertLocked(std::move(tenant));
+}
+
+/**
+ * create Method
+ * @param userId The new user's ID
+ * @param user The new user's profile
+ * @return The new user's data
+ * @throws invalid_argument if the ID is invalid or already taken
+ */
+std::shared_ptr<Tenant> TenantManager::create(const std::string& userId, const User& user) {
+    if (!isValidUserId(userId)) {
+        throw std::invalid_argument("Invalid user ID '" + userId +
+                                    "': use up to 64 letters, digits, '-', '_' or '.', not starting with '.'");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string directory = userDirectory(userId);
+    if (index.count(userId) || std::filesystem::exists(directory + "/user.json")) {
+        throw std::invalid_argument("User already exists: " + userId);
+    }
+    std::filesystem::create_directories(directory);
+
+    auto tenant = std::make_shared<Tenant>(userId, directory);
+    tenant->profile.setUser(user);
+    tenant->profile.saveUser();
+    tenant->load(foodDb);
+    return insertLocked(std::move(tenant));
+}
+
+/**
+ * exists Method
+ * @param userId A user's ID
+ * @return Whether the user exists, loaded or not
+ */
+bool TenantManager::exists(const std::string& userId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.count(userId) > 0 ||
+           (isValidUserId(userId) && std::filesystem::exists(userDirectory(userId) + "/user.json"));
+}
+
+/**
+ * listUsers Method
+ * @return The IDs of all users with a profile, sorted
+ */
+std::vector<std::string> TenantManager::listUsers() const {
+    std::vector<std::string> users;
+    if (std::filesystem::is_directory(rootDirectory)) {
+        for (const auto& entry : std::filesystem::directory_iterator(rootDirectory)) {
+            std::string userId = entry.path().filename().string();
+            if (entry.is_directory() && isValidUserId(userId) &&
+                std::filesystem::exists(entry.path() / "user.json")) {
+                users.push_back(userId);
+            }
+        }
+    }
+    std::sort(users.begin(), users.end());
+    return users;
+}
+
+/**
+ * isLoaded Method
+ * @param userId A user's ID
+ * @return Whether the user's data is in the cache
+ */
+bool TenantManager::isLoaded(const std::string& userId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.count(userId) > 0;
+}
+
+/**
+ * flushAll Method
+ * Saves the changes of every loaded user.
+ * @throws runtime_error with the first failure, after trying every user
+ */
+void TenantManager::flushAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string error;
+    for (const auto& tenant : recent) {
+        try {
+            tenant->flush();
+        } catch (const std::exception& e) {
+            if (error.empty()) {
+                error = "Error saving user " + tenant->userId + ": " + e.what();
+            }
+        }
+    }
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+/**
+ * discardUncommitted Method
+ * Drops the unsaved profile and log changes of every loaded user. Users evicted since their
+ * last save have already been written back.
+ */
+void TenantManager::discardUncommitted() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& tenant : recent) {
+        tenant->discardUncommitted();
+    }
+}
+
+/**
+ * closeUndoSpills Method
+ * Removes the undo spill files of the loaded users, for exits that skip destructors.
+ */
+void TenantManager::closeUndoSpills() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& tenant : recent) {
+        tenant->logHistory.setUndoSpillPath("");
+    }
+}
+
+/**
+ * setCapacity Method
+ * @param users The maximum number of users kept loaded (at least 1)
+ */
+void TenantManager::setCapacity(size_t users) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = users == 0 ? 1 : users;
+    evictLocked();
+}
+
+/**
+ * getStats Method
+ * @return The cache counters
+ */
+TenantCacheStats TenantManager::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {recent.size(), capacity, hits, misses, evictions};
+}
+
+/**
+ * isValidUserId Method
+ * @param userId A candidate user ID
+ * @return Whether the ID is usable as a directory name
+ */
+bool TenantManager::isValidUserId(const std::string& userId) {
+    if (userId.empty() || userId.size() > 64 || userId[0] == '.') {
+        return false;
+    }
+    return std::all_of(userId.begin(), userId.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.';
+    });
+}
+
+/**
+ * userDirectory Method
+ * @param userId A valid user ID
+ * @return The directory holding the user's files
+ */
+std::string TenantManager::userDirectory(const std::string& userId) const {
+    return rootDirectory + "/" + userId;
+}
+
+/**
+ * insertLocked Method
+ * @param tenant A newly loaded user
+ * @return The user, now the most recently used one
+ */
+std::shared_ptr<Tenant> TenantManager::insertLocked(std::shared_ptr<Tenant> tenant) {
+    recent.push_front(std::move(tenant));
+    index[recent.front()->userId] = recent.begin();
+    // Held by the caller from here on, so it cannot be evicted itself
+    std::shared_ptr<Tenant> result = recent.front();
+    evictLocked();
+    return result;
+}
+
+/**
+ * evictLocked Method
+ * Saves and drops least recently used users until the cache fits its capacity.
+ * Users held outside the cache are skipped, so the cache may stay over capacity
+ * while they are in use.
+ */
+void TenantManager::evictLocked() {
+    auto it = recent.end();
+    while (recent.size() > capacity && it != recent.begin()) {
+        --it;
+        if (it->use_count() > 1) {
+            continue;
+        }
+        try {
+            (*it)->flush();
+        } catch (const std::exception& e) {
+            // Keep the changes in memory rather than losing them
+            std::cerr << "Error saving user " << (*it)->userId << ": " << e.what() << std::endl;
+            continue;
+        }
+        index.erase((*it)->userId);
+        it = recent.erase(it);
+        evictions++;
+    }
+}
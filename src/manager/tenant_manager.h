@@ -0,0 +1,115 @@
+/**
+ * @file tenant_manager.h
+ * @brief Per-User Data Management for Additional Users
+ *
+ * This file defines the TenantManager class which lets one process manage the
+ * profiles and logs of many users. Every additional user has a directory of its
+ * own (<root>/<user_id>/) holding user.json, the monthly log files and a journal
+ * of log changes. The food database is not part of a tenant: all users share the
+ * single FoodDatabase instance.
+ *
+ * Key features:
+ * - Lazy loading of a user's profile and logs on first access
+ * - Bounded LRU cache of loaded users
+ * - Write-back on eviction: the evicted user's changes are saved before it is dropped
+ * - Users in use (referenced outside the cache) are never evicted
+ * - Thread-safe access to the cache
+ */
+
+#ifndef TENANT_MANAGER_H
+#define TENANT_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "user_profile.h"
+#include "food_database.h"
+#include "../models/log_entry.h"
+#include "../utils/journal.h"
+
+using namespace std;
+
+/**
+ * Tenant struct
+ * The loaded data of one additional user
+ */
+struct Tenant {
+    Tenant(const string& userId, const string& directory);
+
+    string userId;
+    string directory;
+    UserProfile profile;
+    LogHistory logHistory;
+    Journal journal;
+
+    void load(FoodDatabase& foodDb);
+    void flush();
+    void discardUncommitted();
+};
+
+/**
+ * TenantCacheStats struct
+ * Counters of the tenant cache
+ */
+struct TenantCacheStats {
+    size_t loaded;
+    size_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+/**
+ * TenantManager Class
+ * This class loads, caches and saves the data of additional users.
+ */
+class TenantManager {
+public:
+    static const size_t DEFAULT_CAPACITY = 256;
+
+    explicit TenantManager(FoodDatabase& foodDb, const string& rootDirectory = "data/users",
+                           size_t capacity = DEFAULT_CAPACITY);
+
+    // Access; the returned tenant stays loaded while the caller holds it
+    shared_ptr<Tenant> acquire(const string& userId);
+    shared_ptr<Tenant> create(const string& userId, const User& user);
+    bool exists(const string& userId) const;
+    vector<string> listUsers() const;
+    bool isLoaded(const string& userId) const;
+
+    // Saving the loaded users
+    void flushAll();
+    void discardUncommitted();
+    void closeUndoSpills();
+
+    // Cache size, in users
+    void setCapacity(size_t users);
+    TenantCacheStats getStats() const;
+
+    static bool isValidUserId(const string& userId);
+
+private:
+    FoodDatabase& foodDb;
+    string rootDirectory;
+    size_t capacity;
+
+    // Loaded users, most recently used first
+    mutable std::mutex mutex;
+    list<shared_ptr<Tenant>> recent;
+    unordered_map<string, list<shared_ptr<Tenant>>::iterator> index;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+
+    string userDirectory(const string& userId) const;
+    shared_ptr<Tenant> insertLocked(shared_ptr<Tenant> tenant);
+    void evictLocked();
+};
+
+#endif // TENANT_MANAGER_H
@@ -21,7 +21,27 @@
 #include "user_profile.h"
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include "../utils/terminal_colors.h"
+#include "../utils/atomic_file.h"
+
+namespace {
+
+/**
+ * metricsPath Function
+ * @param profilePath The path of a profile file
+ * @return The path of the file holding the profile's daily metrics (user.json -> user.metrics)
+ */
+std::string metricsPath(const std::string& profilePath) {
+    const std::string extension = ".json";
+    if (profilePath.size() >= extension.size() &&
+        profilePath.compare(profilePath.size() - extension.size(), extension.size(), extension) == 0) {
+        return profilePath.substr(0, profilePath.size() - extension.size()) + ".metrics";
+    }
+    return profilePath + ".metrics";
+}
+
+} // namespace
 
 /**
  * UserProfile getInstance Method
@@ -29,39 +49,59 @@
  * This method implements the singleton pattern.
  */
 UserProfile& UserProfile::getInstance() {
-    static UserProfile instance;
+    static UserProfile instance("data/user.json");
     return instance;
 }
 
 /**
  * UserProfile Constructor
+ * @param filepath The file the profile is loaded from and saved to
  * Initializes the UserProfile with default values.
  */
-UserProfile::UserProfile() : defaultFilepath("data/user.json") {
+UserProfile::UserProfile(const std::string& filepath) : defaultFilepath(filepath) {
     // Create empty user - will be initialized on first load if needed
     user = User("", 0, User::Gender::OTHER, 0.0f, 0.0f, 
                 User::ActivityLevel::MODERATE, User::Goal::MAINTAIN,
                 User::CalorieCalculationMethod::MIFFLIN_ST_JEOR);
     isInitialized = false;
+    interactive = true;
+    discarded = false;
+    savedState = user.toJson();
 }
 
 /**
  * UserProfile Destructor
+ * Saves the profile if it changed, unless the changes were discarded.
  */
 UserProfile::~UserProfile() {
     try {
-        saveUser();
+        if (!discarded && isDirty()) {
+            saveUser();
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error saving user profile: " << e.what() << std::endl;
     }
 }
 
+/**
+ * setInteractive Method
+ * @param interactive Whether a missing profile may be created by prompting the user
+ */
+void UserProfile::setInteractive(bool interactive) {
+    this->interactive = interactive;
+}
+
 /**
  * initializeUserProfile Method
  * Prompts the user to enter their profile information
  * This is called when no user profile exists on disk
+ * @throws runtime_error if prompting is disabled
  */
 void UserProfile::initializeUserProfile() {
+    if (!interactive) {
+        throw std::runtime_error("No valid user profile in " + defaultFilepath +
+                                 "; run the program interactively once to create one");
+    }
     std::cout << TerminalColors::bold("\nWelcome to Diet Manager!\n");
     std::cout << "Please set up your user profile:\n\n"
               << TerminalColors::info("Note: You can change these settings later with the profile command.\n\n");
@@ -194,6 +234,23 @@ User& UserProfile::getUser() {
     return user;
 }
 
+/**
+ * setUser Method
+ * @param user The new profile, replacing the current one without prompting
+ */
+void UserProfile::setUser(const User& user) {
+    this->user = user;
+    isInitialized = true;
+}
+
+/**
+ * getFilepath Method
+ * @return The file the profile is loaded from and saved to
+ */
+const std::string& UserProfile::getFilepath() const {
+    return defaultFilepath;
+}
+
 /**
  * saveUser Method
  * @param filepath Optional filepath to save to (uses default if empty)
@@ -203,14 +260,17 @@ void UserProfile::saveUser(const std::string& filepath) {
     std::string path = filepath.empty() ? defaultFilepath : filepath;
     
     try {
-        std::ofstream file(path);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open file for writing: " + path);
-        }
+        // The metrics first: a profile file never refers to metrics that were not written
+        user.saveDailyMetrics(metricsPath(path));
         
         json userJson = user.toJson();
-        file << std::setw(4) << userJson << std::endl;
-        file.close();
+        AtomicFile::write(path, [&userJson](std::ostream& out) {
+            out << std::setw(4) << userJson << std::endl;
+        });
+        if (filepath.empty()) {
+            savedState = std::move(userJson);
+            discarded = false;
+        }
     } catch (const std::exception& e) {
         throw std::runtime_error("Error saving user profile: " + std::string(e.what()));
     }
@@ -236,12 +296,35 @@ void UserProfile::loadUser(const std::string& filepath) {
         file.close();
         
         user = User::fromJson(userJson);
+        // The metrics file supersedes a dailyMetrics array left in older profile files
+        user.loadDailyMetrics(metricsPath(path));
         isInitialized = !user.getName().empty();
+        if (filepath.empty()) {
+            savedState = user.toJson();
+        }
     } catch (const std::exception& e) {
         throw std::runtime_error("Error loading user profile: " + std::string(e.what()));
     }
 }
 
+/**
+ * isDirty Method
+ * @return True if the profile differs from the default file as last written or read
+ */
+bool UserProfile::isDirty() const {
+    return user.hasUnsavedDailyMetrics() || user.toJson() != savedState;
+}
+
+/**
+ * discardChanges Method
+ * Drops the changes made since the profile was last saved, including daily
+ * records and migrations done on load: the destructor no longer writes them.
+ * Saving the profile again ends this.
+ */
+void UserProfile::discardChanges() {
+    discarded = true;
+}
+
 /**
  * setUserAttribute Method
  * @param attribute The attribute to set
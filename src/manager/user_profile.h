@@ -7,10 +7,12 @@
  * gender, and activity level, which are used for calorie calculations.
  * 
  * Key features:
- * - Singleton pattern implementation for global access
+ * - Singleton pattern implementation for global access to the default profile
+ * - Independent profiles stored elsewhere, one per additional user (see TenantManager)
  * - Access to user attributes and settings
  * - Calculation of target calorie intake based on user characteristics
- * - Persistence of user data to/from JSON files
+ * - Persistence of user data to/from JSON files, skipped when nothing changed, with
+ *   the daily metrics history appended to a binary file next to them (user.metrics)
  * - Methods to update user attributes and settings
  * 
  * The UserProfile class serves as the central repository for all user-specific
@@ -35,21 +37,27 @@ class UserProfile {
 public:
     static UserProfile& getInstance();
     
+    // A profile stored in the given file; the default profile is data/user.json
+    explicit UserProfile(const string& filepath);
+    ~UserProfile();
+    UserProfile(const UserProfile&) = delete;
+    UserProfile& operator=(const UserProfile&) = delete;
+    
     // User profile methods
     User& getUser();
+    void setUser(const User& user);
+    const string& getFilepath() const;
     void saveUser(const string& filepath = "");
     void loadUser(const string& filepath = "");
+    bool isDirty() const;
+    void discardChanges();
+    void setInteractive(bool interactive);
     void setUserAttribute(const string& attribute, const string& value);
     
     // Calorie calculation
     float calculateTargetCalories() const;
     
 private:
-    UserProfile();
-    ~UserProfile();
-    UserProfile(const UserProfile&) = delete;
-    UserProfile& operator=(const UserProfile&) = delete;
-    
     // Methods for profile initialization
     void initializeUserProfile();
     void ensureInitialized();
@@ -57,6 +65,16 @@ private:
     User user;
     string defaultFilepath;
     bool isInitialized;
+    
+    // Whether a missing profile may be created by prompting on the terminal
+    bool interactive;
+    
+    // The profile as last written to or read from the default file. getUser hands
+    // out a mutable reference, so changes are detected by comparing against it.
+    json savedState;
+    
+    // Set by discardChanges: the destructor leaves the file as it is
+    bool discarded;
 };
 
 #endif // USER_PROFILE_H
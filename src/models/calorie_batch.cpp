@@ -0,0 +1,238 @@
+/**
+ * @file calorie_batch.cpp
+ * @brief Batch BMR and Target Calorie Evaluation Implementation
+ *
+ * This file implements the CalorieBatch functions declared in calorie_batch.h.
+ * Rows are processed in blocks. A column with a single value is expanded once
+ * into a block-sized buffer, so the kernels only ever see full columns. For each
+ * block the genders are checked once, and a kernel specialized at compile time
+ * for the calculation method and that gender mix computes the BMR. A second
+ * kernel applies the activity multipliers and goal adjustments.
+ *
+ * The kernels evaluate the formulas of the User class in the same order, so the
+ * results match its scalar methods exactly.
+ *
+ * Key implementations:
+ * - Validation and broadcasting of the input columns
+ * - Linear BMR kernels (Mifflin-St Jeor, Harris-Benedict)
+ * - WHO kernel with the age bracket counted from comparisons
+ * - Target kernel over the activity levels and goals
+ */
+
+#include "calorie_batch.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const size_t BLOCK_SIZE = 512;
+
+const uint8_t MALE = static_cast<uint8_t>(User::Gender::MALE);
+
+// WHO weight factors and constants per age bracket (<3, <10, <18, <30, <60, 60+),
+// male then female
+const float WHO_FACTORS[12] = {60.9f, 22.7f, 17.5f, 15.3f, 11.6f, 13.5f,
+                               61.0f, 22.5f, 12.2f, 14.7f, 8.7f, 10.5f};
+const float WHO_CONSTANTS[12] = {-54, 495, 651, 679, 879, 487,
+                                 -51, 499, 746, 496, 829, 596};
+
+// Activity multipliers indexed by ActivityLevel, then the one of unknown levels
+const float MULTIPLIERS[6] = {1.2f, 1.375f, 1.55f, 1.725f, 1.9f, 1.55f};
+
+// Calorie adjustments indexed by Goal, then the one of unknown goals
+const float GOAL_ADJUSTMENTS[4] = {-500.0f, 0.0f, 500.0f, 0.0f};
+
+/**
+ * GenderMix enum
+ * The genders of one block of rows
+ */
+enum class GenderMix { MALE_ONLY, NOT_MALE, MIXED };
+
+/**
+ * Columns struct
+ * Pointers to one block of every column
+ */
+struct Columns {
+    const float* weights;
+    const float* heights;
+    const uint16_t* ages;
+    const uint8_t* genders;
+    const uint8_t* activityLevels;
+    const uint8_t* goals;
+};
+
+/**
+ * select Function
+ * @return maleValue for a male row, femaleValue otherwise; constant unless the mix is MIXED
+ */
+template <GenderMix MIX, typename T>
+inline T select(uint8_t gender, T maleValue, T femaleValue) {
+    if constexpr (MIX == GenderMix::MALE_ONLY) {
+        return maleValue;
+    } else if constexpr (MIX == GenderMix::NOT_MALE) {
+        return femaleValue;
+    } else {
+        return gender == MALE ? maleValue : femaleValue;
+    }
+}
+
+/**
+ * bmrKernel Function
+ * @param columns One block of the input
+ * @param count The rows in the block
+ * @param bmr Receives the BMR of every row
+ * The formulas of User::calculateBMR for one method, with the coefficients
+ * of both genders selected per row only for mixed blocks.
+ */
+template <User::CalorieCalculationMethod METHOD, GenderMix MIX>
+void bmrKernel(const Columns& columns, size_t count, float* bmr) {
+    const float* weights = columns.weights;
+    const float* heights = columns.heights;
+    const uint16_t* ages = columns.ages;
+    const uint8_t* genders = columns.genders;
+    
+    for (size_t i = 0; i < count; i++) {
+        float age = static_cast<float>(ages[i]);
+        uint8_t gender = genders[i];
+        if constexpr (METHOD == User::CalorieCalculationMethod::HARRIS_BENEDICT) {
+            bmr[i] = select<MIX>(gender, 88.362f, 447.593f) + (select<MIX>(gender, 13.397f, 9.247f) * weights[i]) +
+                     (select<MIX>(gender, 4.799f, 3.098f) * heights[i]) - (select<MIX>(gender, 5.677f, 4.330f) * age);
+        } else if constexpr (METHOD == User::CalorieCalculationMethod::WHO_EQUATION) {
+            int bracket = (ages[i] >= 3) + (ages[i] >= 10) + (ages[i] >= 18) + (ages[i] >= 30) + (ages[i] >= 60);
+            int row = bracket + select<MIX>(gender, 0, 6);
+            bmr[i] = (WHO_FACTORS[row] * weights[i]) + WHO_CONSTANTS[row];
+        } else {
+            bmr[i] = (10.0f * weights[i]) + (6.25f * heights[i]) - (5.0f * age) + select<MIX>(gender, 5.0f, -161.0f);
+        }
+    }
+}
+
+/**
+ * targetKernel Function
+ * @param columns One block of the input
+ * @param count The rows in the block
+ * @param bmr The BMR of every row
+ * @param targetCalories Receives the target calories of every row
+ * The activity multipliers and goal adjustments of the User class, looked up in
+ * tables instead of a switch.
+ */
+void targetKernel(const Columns& columns, size_t count, const float* bmr, float* targetCalories) {
+    const uint8_t* activityLevels = columns.activityLevels;
+    const uint8_t* goals = columns.goals;
+    for (size_t i = 0; i < count; i++) {
+        float multiplier = MULTIPLIERS[std::min<int>(activityLevels[i], 5)];
+        float adjustment = GOAL_ADJUSTMENTS[std::min<int>(goals[i], 3)];
+        targetCalories[i] = bmr[i] * multiplier + adjustment;
+    }
+}
+
+/**
+ * genderMix Function
+ * @param genders The genders of a block
+ * @param count The rows in the block
+ * @return Whether the block is all male, has no male or is mixed
+ */
+GenderMix genderMix(const uint8_t* genders, size_t count) {
+    size_t males = static_cast<size_t>(std::count(genders, genders + count, MALE));
+    return males == count ? GenderMix::MALE_ONLY : males == 0 ? GenderMix::NOT_MALE : GenderMix::MIXED;
+}
+
+/**
+ * runBmrKernel Function
+ * Calls the BMR kernel of one method for the gender mix of the block.
+ */
+template <User::CalorieCalculationMethod METHOD>
+void runBmrKernel(const Columns& columns, size_t count, float* bmr) {
+    switch (genderMix(columns.genders, count)) {
+        case GenderMix::MALE_ONLY:
+            bmrKernel<METHOD, GenderMix::MALE_ONLY>(columns, count, bmr);
+            break;
+        case GenderMix::NOT_MALE:
+            bmrKernel<METHOD, GenderMix::NOT_MALE>(columns, count, bmr);
+            break;
+        case GenderMix::MIXED:
+            bmrKernel<METHOD, GenderMix::MIXED>(columns, count, bmr);
+            break;
+    }
+}
+
+/**
+ * Column struct
+ * One input column, expanded to a block-sized buffer if it holds a single value
+ */
+template <typename T>
+struct Column {
+    const T* values;
+    bool single;
+    T buffer[BLOCK_SIZE];
+    
+    explicit Column(ConstSpan<T> span) : values(span.begin()), single(span.size() == 1) {
+        if (single) {
+            std::fill(buffer, buffer + BLOCK_SIZE, span[0]);
+            values = buffer;
+        }
+    }
+    
+    const T* at(size_t row) const {
+        return single ? values : values + row;
+    }
+};
+
+} // namespace
+
+/**
+ * rowCount Function
+ * @param input The columns of a batch
+ * @return The number of rows: the length of the longest column
+ * @throws invalid_argument if a column has neither one value nor one per row
+ */
+size_t CalorieBatch::rowCount(const CalorieBatchInput& input) {
+    size_t sizes[] = {input.weights.size(), input.heights.size(), input.ages.size(),
+                      input.genders.size(), input.activityLevels.size(), input.goals.size()};
+    size_t rows = *std::max_element(std::begin(sizes), std::end(sizes));
+    for (size_t size : sizes) {
+        if (size != rows && size != 1) {
+            throw std::invalid_argument("Every calorie batch column needs one value or one per row (" +
+                                        std::to_string(rows) + ")");
+        }
+    }
+    return rows;
+}
+
+/**
+ * evaluate Function
+ * @param method The BMR formula
+ * @param input The columns of the batch
+ * @param bmr Receives the BMR of every row
+ * @param targetCalories Receives the target calories of every row
+ * @throws invalid_argument if the columns do not have matching lengths
+ */
+void CalorieBatch::evaluate(User::CalorieCalculationMethod method, const CalorieBatchInput& input,
+                            float* bmr, float* targetCalories) {
+    size_t rows = rowCount(input);
+    Column<float> weights(input.weights);
+    Column<float> heights(input.heights);
+    Column<uint16_t> ages(input.ages);
+    Column<uint8_t> genders(input.genders);
+    Column<uint8_t> activityLevels(input.activityLevels);
+    Column<uint8_t> goals(input.goals);
+    
+    for (size_t start = 0; start < rows; start += BLOCK_SIZE) {
+        size_t count = std::min(BLOCK_SIZE, rows - start);
+        Columns columns = {weights.at(start), heights.at(start), ages.at(start),
+                           genders.at(start), activityLevels.at(start), goals.at(start)};
+        switch (method) {
+            case User::CalorieCalculationMethod::HARRIS_BENEDICT:
+                runBmrKernel<User::CalorieCalculationMethod::HARRIS_BENEDICT>(columns, count, bmr + start);
+                break;
+            case User::CalorieCalculationMethod::WHO_EQUATION:
+                runBmrKernel<User::CalorieCalculationMethod::WHO_EQUATION>(columns, count, bmr + start);
+                break;
+            case User::CalorieCalculationMethod::MIFFLIN_ST_JEOR:
+            default:
+                runBmrKernel<User::CalorieCalculationMethod::MIFFLIN_ST_JEOR>(columns, count, bmr + start);
+                break;
+        }
+        targetKernel(columns, count, bmr + start, targetCalories + start);
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file calorie_batch.h
+ * @brief Batch BMR and Target Calorie Evaluation
+ *
+ * This file declares the CalorieBatch functions which compute the BMR and the
+ * target calories of many (weight, height, age, gender, activity level, goal)
+ * tuples at once, for population reports and replays of daily metrics
+ * histories. They give the same results as User::calculateBMR and
+ * User::calculateTargetCalories for every tuple.
+ *
+ * Key features:
+ * - Structure-of-arrays input; a column with a single value applies to every row
+ * - One kernel per calculation method and gender (male, not male or mixed),
+ *   chosen once per block of rows instead of branching on every row
+ * - Branch-free kernels: coefficients, age brackets, activity multipliers and
+ *   goal adjustments are chosen by comparisons and table lookups, so the compiler
+ *   can vectorize the loops for the target's SIMD instruction set
+ */
+
+#ifndef CALORIE_BATCH_H
+#define CALORIE_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "user.h"
+#include "../utils/const_span.h"
+
+using namespace std;
+
+/**
+ * CalorieBatchInput struct
+ * The columns of a batch; each one holds a value per row or a single value
+ */
+struct CalorieBatchInput {
+    ConstSpan<float> weights;          // kg
+    ConstSpan<float> heights;          // cm
+    ConstSpan<uint16_t> ages;          // years
+    ConstSpan<uint8_t> genders;        // User::Gender values
+    ConstSpan<uint8_t> activityLevels; // User::ActivityLevel values
+    ConstSpan<uint8_t> goals;          // User::Goal values
+};
+
+namespace CalorieBatch {
+    // The number of rows of a batch
+    // @throws invalid_argument if a column has neither one value nor one per row
+    size_t rowCount(const CalorieBatchInput& input);
+
+    // Fills bmr and targetCalories, each with rowCount(input) values
+    void evaluate(User::CalorieCalculationMethod method, const CalorieBatchInput& input,
+                  float* bmr, float* targetCalories);
+}
+
+#endif // CALORIE_BATCH_H
@@ -0,0 +1,93 @@
+/**
+ * @file calorie_totals.cpp
+ * @brief Daily Calorie Totals Implementation
+ *
+ * This file implements the CalorieTotals class defined in calorie_totals.h.
+ * The covered range at least doubles whenever a day outside it is set, so the
+ * O(n) rebuilds of the tree add up to amortized constant time per day.
+ */
+
+#include "calorie_totals.h"
+#include <algorithm>
+
+/**
+ * clear Method
+ * Removes all days.
+ */
+void CalorieTotals::clear() {
+    days.clear();
+    tree.assign(days);
+}
+
+/**
+ * setDay Method
+ * @param date The day to set
+ * @param calories The total calories consumed on the day
+ */
+void CalorieTotals::setDay(Date date, double calories) {
+    cover(date);
+    size_t index = static_cast<size_t>(date - base);
+    tree.add(index, calories - days[index]);
+    days[index] = calories;
+}
+
+/**
+ * getDay Method
+ * @param date A day
+ * @return The calories consumed on the day
+ */
+double CalorieTotals::getDay(Date date) const {
+    return contains(date) ? days[static_cast<size_t>(date - base)] : 0.0;
+}
+
+/**
+ * getTotal Method
+ * @param from The first day of the range
+ * @param to The last day of the range (inclusive)
+ * @return The calories consumed on the days of the range
+ */
+double CalorieTotals::getTotal(Date from, Date to) const {
+    if (days.empty() || to < from) {
+        return 0.0;
+    }
+    Date last = base + static_cast<int32_t>(days.size()) - 1;
+    from = std::max(from, base);
+    to = std::min(to, last);
+    if (to < from) {
+        return 0.0;
+    }
+    return tree.rangeSum(static_cast<size_t>(from - base), static_cast<size_t>(to - base) + 1);
+}
+
+/**
+ * contains Method
+ * @param date A day
+ * @return True if the day lies within the covered range
+ */
+bool CalorieTotals::contains(Date date) const {
+    return !days.empty() && date >= base && date - base < static_cast<int32_t>(days.size());
+}
+
+/**
+ * cover Method
+ * @param date A day that must lie within the covered range
+ * Grows the range towards the day and rebuilds the tree if needed.
+ */
+void CalorieTotals::cover(Date date) {
+    if (contains(date)) {
+        return;
+    }
+    if (days.empty()) {
+        base = date;
+        days.assign(1, 0.0);
+    } else if (date < base) {
+        size_t missing = static_cast<size_t>(base - date);
+        size_t grow = std::max(missing, days.size());
+        days.insert(days.begin(), grow, 0.0);
+        base = base - static_cast<int32_t>(grow);
+    } else {
+        size_t needed = static_cast<size_t>(date - base) + 1;
+        days.resize(std::max(needed, days.size() * 2), 0.0);
+    }
+    tree.assign(days);
+}
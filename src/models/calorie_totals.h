@@ -0,0 +1,46 @@
+/**
+ * @file calorie_totals.h
+ * @brief Daily Calorie Totals with Range Queries
+ *
+ * This file defines the CalorieTotals class which LogHistory uses to answer
+ * calorie totals over arbitrary date ranges. Every day in the covered range has
+ * a slot (days without a log count as zero), and a Fenwick tree over the slots
+ * turns any range total into two prefix sums.
+ *
+ * Key features:
+ * - O(log n) update of one day's total
+ * - O(log n) total over any range of dates
+ * - Automatic growth of the covered date range in both directions
+ */
+
+#ifndef CALORIE_TOTALS_H
+#define CALORIE_TOTALS_H
+
+#include <vector>
+#include "../utils/date.h"
+#include "../utils/fenwick_tree.h"
+
+using namespace std;
+
+/**
+ * CalorieTotals Class
+ * This class stores the calories of each day and sums them over date ranges.
+ */
+class CalorieTotals {
+public:
+    void clear();
+    void setDay(Date date, double calories);
+    double getDay(Date date) const;
+    double getTotal(Date from, Date to) const;
+
+private:
+    // Calories per day, position 0 being the day base
+    Date base;
+    vector<double> days;
+    FenwickTree<double> tree;
+
+    void cover(Date date);
+    bool contains(Date date) const;
+};
+
+#endif // CALORIE_TOTALS_H
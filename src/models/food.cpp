@@ -18,15 +18,17 @@
  */
 
 #include "food.h"
+#include <utility>
 
 /**
  * Food Class Constructor
  * @param id The unique identifier for the food item
  * @param keywords A vector of keywords associated with the food item
  * This constructor initializes the Food object with a unique id and a list of keywords using initializer list syntax.
+ * Both arguments are taken by value and moved into place, so callers passing temporaries do not copy.
  */
-Food::Food(const std::string& id, const std::vector<std::string>& keywords)
-    : id(id), keywords(keywords) { 
+Food::Food(std::string id, std::vector<std::string> keywords)
+    : id(std::move(id)), keywords(std::move(keywords)) { 
 }
 
 /**
@@ -34,16 +36,16 @@ Food::Food(const std::string& id, const std::vector<std::string>& keywords)
  * @return The unique identifier for the food item
  * This method returns the unique identifier of the food item.
  */
-string Food::getId() const {
+const string& Food::getId() const {
     return id;
 }
 
 /**
  * getKeywords Method
- * @return A vector of keywords associated with the food item
- * This method returns the keywords associated with the food item.
+ * @return A reference to the keywords associated with the food item
+ * This method returns the keywords associated with the food item without copying them.
  */
-vector<string> Food::getKeywords() const {
+const vector<string>& Food::getKeywords() const {
     return keywords;
 }
 
@@ -54,8 +56,17 @@ vector<string> Food::getKeywords() const {
  * @param calories The number of calories per serving of the food item
  * This constructor initializes the BasicFood object with a unique id, a list of keywords, and the number of calories.
  */
-BasicFood::BasicFood(const std::string& id, const std::vector<std::string>& keywords, float calories)
-    : Food(id, keywords), calories(calories) { 
+BasicFood::BasicFood(std::string id, std::vector<std::string> keywords, float calories)
+    : Food(std::move(id), std::move(keywords)), calories(calories) { 
+}
+
+/**
+ * setCalories Method
+ * @param calories The new number of calories per serving of the food item
+ * This method updates the number of calories per serving of the food item.
+ */
+void BasicFood::setCalories(float calories) {
+    this->calories = calories;
 }
 
 /**
@@ -82,8 +93,8 @@ bool BasicFood::isComposite() const {
  * @param keywords A vector of keywords associated with the food item
  * This constructor initializes the CompositeFood object with a unique id and a list of keywords.
  */
-CompositeFood::CompositeFood(const std::string& id, const std::vector<std::string>& keywords)
-    : Food(id, keywords), totalCalories(0) {
+CompositeFood::CompositeFood(std::string id, std::vector<std::string> keywords)
+    : Food(std::move(id), std::move(keywords)), totalCalories(0) {
 }
 
 /**
@@ -98,10 +109,10 @@ void CompositeFood::addComponent(const std::string& foodId, float servings) {
 
 /**
  * getComponents Method
- * @return A map of component food items and their servings
- * This method returns a map of component food items and their servings.
+ * @return A reference to the map of component food items and their servings
+ * This method returns the components of the composite food item without copying them.
  */
-map<string, float> CompositeFood::getComponents() const {
+const map<string, float>& CompositeFood::getComponents() const {
     return components;
 }
 
@@ -13,6 +13,8 @@
  * 
  * The Food hierarchy allows for uniform treatment of both simple and complex foods
  * throughout the application, simplifying calorie calculations and food management.
+ * Accessors return const references so reading a food never copies its data, and
+ * constructors take their strings by value so callers can move them in.
  */
 
 #ifndef FOOD_H
@@ -29,10 +31,11 @@ using namespace std;
  */
 class Food{
     public:
-        Food(const std::string& id, const std::vector<std::string>& keywords);
+        Food(string id, vector<string> keywords);
+        virtual ~Food() = default;
 
-        string getId() const;
-        vector<string> getKeywords() const;
+        const string& getId() const;
+        const vector<string>& getKeywords() const;
         virtual float getCaloriesPerServing() const = 0;
         virtual bool isComposite() const = 0;
 
@@ -47,8 +50,9 @@ class Food{
  */
 class BasicFood:public Food{
     public:
-        BasicFood(const std::string& id, const std::vector<std::string>& keywords, float calories);
+        BasicFood(string id, vector<string> keywords, float calories);
 
+        void setCalories(float calories);
         float getCaloriesPerServing() const override;
         bool isComposite() const override;
 
@@ -62,10 +66,10 @@ class BasicFood:public Food{
  */
 class CompositeFood:public Food{
     public:
-        CompositeFood(const std::string& id, const std::vector<std::string>& keywords);
+        CompositeFood(string id, vector<string> keywords);
 
         void addComponent(const std::string& foodId, float servings);
-        map<string, float> getComponents() const;
+        const map<string, float>& getComponents() const;
         void setTotalCalories(float calories);
         float getCaloriesPerServing() const override;
         bool isComposite() const override;
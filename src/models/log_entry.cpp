@@ -7,35 +7,71 @@
  * of dietary records with undo/redo capabilities.
  * 
  * Key implementations:
- * - Adding and removing foods from daily logs
- * - Command pattern for log operations (add, remove)
- * - Undo and redo functionality for log commands
- * - Log retrieval and management across multiple dates
+ * - Adding and removing foods from daily logs, kept as sorted (handle, servings) pairs
+ * - Log operations (add, remove) recorded as compact servings deltas
+ * - Undo and redo by applying the recorded deltas backwards or forwards
+ * - Batches of operations kept as one command, journaled in a single write
+ * - Log retrieval across multiple dates by binary search over a sorted vector
  * - JSON serialization and deserialization
+ * - Monthly log files rewritten only when one of their dates changed
+ * - Lazy loading by month: a month is read on first access and unloaded again
+ *   when it is the least recently used one without unsaved changes
+ * - Journal records holding the resulting servings of each change
+ * - Range totals of daily calories, updated per changed day
+ * - Servings of all loaded entries in one arena, released when the history is
+ *   loaded again, or on the heap while months are loaded lazily
  * 
- * The implementation uses the Command design pattern to provide a flexible and
- * powerful history management system with full undo/redo capabilities.
+ * Each command is stored as a group of fixed-size records in a bounded ring
+ * buffer (UndoBuffer), so the undo history neither grows without limit nor
+ * allocates per command, and it refers to logs by date rather than by pointer.
  */
 
 #include "log_entry.h"
-#include <chrono>
-#include <ctime>
+#include "../utils/metrics.h"
+#include "../utils/atomic_file.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
-#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Servings left over by rounding when deltas are undone count as removed
+const float SERVINGS_EPSILON = 1e-4f;
+
+// Days before today whose months lazy loading reads up front
+const int32_t EAGER_DAYS = 7;
+
+// First block of the servings arena, enough for about a year of logs
+const size_t LOG_ARENA_FIRST_BLOCK = 16 * 1024;
+
+/**
+ * dayBit Function
+ * @param date A date
+ * @return The bit of the date's day in the day mask of its month
+ */
+uint32_t dayBit(Date date) {
+    return 1u << (date - date.firstOfMonth());
+}
+
+} // namespace
 
 /**
  * LogEntry Constructor
- * @param date The date for this log entry (YYYY-MM-DD format)
+ * @param date The date for this log entry (defaults to today)
+ * @param resource The memory resource of the servings
  */
-LogEntry::LogEntry(const std::string& date) : date(date) {
-    if (this->date.empty()) {
-        // Use current date if none provided
-        auto now = std::chrono::system_clock::now();
-        auto in_time_t = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d");
-        this->date = ss.str();
-    }
+LogEntry::LogEntry(Date date, std::pmr::memory_resource* resource) : date(date), foods(resource) {
+}
+
+/**
+ * LogEntry Constructor
+ * @param other The log entry to copy
+ * @param resource The memory resource of the copy's servings
+ */
+LogEntry::LogEntry(const LogEntry& other, std::pmr::memory_resource* resource)
+    : date(other.date), foods(other.foods, resource) {
 }
 
 /**
@@ -44,10 +80,8 @@ LogEntry::LogEntry(const std::string& date) : date(date) {
  * @param servings The number of servings
  */
 void LogEntry::addFood(const std::string& foodId, float servings) {
-    foods[foodId] += servings;
-    if (foods[foodId] <= 0) {
-        foods.erase(foodId);
-    }
+    FoodHandle food = FoodIds::getInstance().intern(foodId);
+    setServings(food, getServings(food) + servings);
 }
 
 /**
@@ -55,24 +89,76 @@ void LogEntry::addFood(const std::string& foodId, float servings) {
  * @param foodId The ID of the food to remove
  */
 void LogEntry::removeFood(const std::string& foodId) {
-    if (foods.find(foodId) != foods.end()) {
-        foods.erase(foodId);
+    setServings(foodId, 0.0f);
+}
+
+/**
+ * setServings Method
+ * @param foodId The ID of the food
+ * @param servings The number of servings; zero or less removes the food
+ */
+void LogEntry::setServings(const std::string& foodId, float servings) {
+    FoodIds& ids = FoodIds::getInstance();
+    FoodHandle food = servings > 0 ? ids.intern(foodId) : ids.find(foodId);
+    if (food != INVALID_FOOD) {
+        setServings(food, servings);
     }
 }
 
+/**
+ * setServings Method
+ * @param food The handle of the food
+ * @param servings The number of servings; zero or less removes the food
+ */
+void LogEntry::setServings(FoodHandle food, float servings) {
+    auto it = std::lower_bound(foods.begin(), foods.end(), food,
+                               [](const FoodServings& entry, FoodHandle h) { return entry.first < h; });
+    bool found = it != foods.end() && it->first == food;
+    if (servings <= 0) {
+        if (found) {
+            foods.erase(it);
+        }
+    } else if (found) {
+        it->second = servings;
+    } else {
+        foods.emplace(it, food, servings);
+    }
+}
+
+/**
+ * getServings Method
+ * @param foodId The ID of a food
+ * @return The servings of the food, zero if it is not in the log
+ */
+float LogEntry::getServings(const std::string& foodId) const {
+    FoodHandle food = FoodIds::getInstance().find(foodId);
+    return food == INVALID_FOOD ? 0.0f : getServings(food);
+}
+
+/**
+ * getServings Method
+ * @param food The handle of a food
+ * @return The servings of the food, zero if it is not in the log
+ */
+float LogEntry::getServings(FoodHandle food) const {
+    auto it = std::lower_bound(foods.begin(), foods.end(), food,
+                               [](const FoodServings& entry, FoodHandle h) { return entry.first < h; });
+    return it != foods.end() && it->first == food ? it->second : 0.0f;
+}
+
 /**
  * getFoods Method
- * @return A map of food IDs to servings
+ * @return The foods of the log and their servings, ordered by handle
  */
-std::map<std::string, float> LogEntry::getFoods() const {
-    return foods;
+ConstSpan<FoodServings> LogEntry::getFoods() const {
+    return {foods.data(), foods.data() + foods.size()};
 }
 
 /**
  * getDate Method
  * @return The date of this log entry
  */
-std::string LogEntry::getDate() const {
+Date LogEntry::getDate() const {
     return date;
 }
 
@@ -80,7 +166,7 @@ std::string LogEntry::getDate() const {
  * setDate Method
  * @param date The new date for this log entry
  */
-void LogEntry::setDate(const std::string& date) {
+void LogEntry::setDate(Date date) {
     this->date = date;
 }
 
@@ -90,35 +176,50 @@ void LogEntry::setDate(const std::string& date) {
  */
 json LogEntry::toJson() const {
     json j;
-    j["date"] = date;
-    j["foods"] = foods;
+    j["date"] = date.toString();
+    json::object_t byName;
+    const FoodIds& ids = FoodIds::getInstance();
+    for (const auto& [food, servings] : foods) {
+        byName.emplace(ids.name(food), servings);
+    }
+    j["foods"] = std::move(byName);
     return j;
 }
 
 /**
  * fromJson Method
  * @param j The JSON to parse
+ * @param resource The memory resource of the entry's servings
  * @return A LogEntry object
+ * @throws invalid_argument if the date is not in YYYY-MM-DD format
  */
-LogEntry LogEntry::fromJson(const json& j) {
-    LogEntry entry;
-    if (j.contains("date")) {
-        entry.date = j["date"].get<std::string>();
-    }
+LogEntry LogEntry::fromJson(const json& j, std::pmr::memory_resource* resource) {
+    LogEntry entry(j.contains("date") ? Date::fromString(j["date"].get<std::string>()) : Date::today(), resource);
     if (j.contains("foods") && j["foods"].is_object()) {
+        FoodIds& ids = FoodIds::getInstance();
+        entry.foods.reserve(j["foods"].size());
         for (auto& [key, value] : j["foods"].items()) {
-            entry.foods[key] = value.get<float>();
+            float servings = value.get<float>();
+            if (servings > 0) {
+                entry.foods.emplace_back(ids.intern(key), servings);
+            }
         }
+        std::sort(entry.foods.begin(), entry.foods.end());
     }
     return entry;
 }
 
 /**
  * LogHistory Constructor
+ * @param logDirectory The directory holding one log file per month
+ * @param legacyLogPath The single log file used by earlier versions, migrated on the first save
  */
-LogHistory::LogHistory() : currentCommandIndex(0) {
-    currentDate = getCurrentDateString();
-    logs[currentDate] = LogEntry(currentDate);
+LogHistory::LogHistory(const std::string& logDirectory, const std::string& legacyLogPath)
+    : logArena(LOG_ARENA_FIRST_BLOCK), arenaLoading(true), lazyLoading(false), loadedDaysBudget(DEFAULT_LOADED_DAYS), useClock(0), monthFaults(0), monthEvictions(0),
+      logDirectory(logDirectory), legacyLogPath(legacyLogPath), legacyLoaded(false),
+      journal(nullptr), totalsValid(false), totalsVersion(0) {
+    currentDate = Date::today();
+    getLog(currentDate);
 }
 
 /**
@@ -126,51 +227,105 @@ LogHistory::LogHistory() : currentCommandIndex(0) {
  * @return Pointer to the current log entry
  */
 LogEntry* LogHistory::getCurrentLog() {
-    if (logs.find(currentDate) == logs.end()) {
-        logs[currentDate] = LogEntry(currentDate);
-    }
-    return &logs[currentDate];
+    return getLog(currentDate);
 }
 
 /**
  * getLog Method
  * @param date The date to get the log for
- * @return Pointer to the log entry for the specified date
+ * @return Pointer to the log entry for the specified date, created if needed
+ * A single binary search finds the entry or the position to insert it at.
  */
-LogEntry* LogHistory::getLog(const std::string& date) {
-    if (logs.find(date) == logs.end()) {
-        logs[date] = LogEntry(date);
+LogEntry* LogHistory::getLog(Date date) {
+    useMonths(date, date);
+    auto it = std::lower_bound(logs.begin(), logs.end(), date,
+                               [](const LogEntry& log, Date d) { return log.getDate() < d; });
+    if (it == logs.end() || it->getDate() != date) {
+        it = logs.emplace(it, date, &logArena);
+        monthOf(date).dayMask |= dayBit(date);
     }
-    return &logs[date];
+    return &*it;
+}
+
+/**
+ * findLog Method
+ * @param date The date to look up
+ * @return Pointer to the log entry for the date, or nullptr if there is none
+ */
+const LogEntry* LogHistory::findLog(Date date) const {
+    useMonths(date, date);
+    auto it = std::lower_bound(logs.begin(), logs.end(), date,
+                               [](const LogEntry& log, Date d) { return log.getDate() < d; });
+    return it != logs.end() && it->getDate() == date ? &*it : nullptr;
+}
+
+/**
+ * getLogs Method
+ * @param from The first date of the range
+ * @param to The last date of the range (inclusive)
+ * @return The log entries within the range, in date order
+ * All months of the range are loaded, regardless of the budget of loaded days.
+ */
+ConstSpan<LogEntry> LogHistory::getLogs(Date from, Date to) const {
+    useMonths(from, to);
+    auto byDate = [](const LogEntry& log, Date d) { return log.getDate() < d; };
+    auto first = std::lower_bound(logs.begin(), logs.end(), from, byDate);
+    auto last = std::lower_bound(first, logs.end(), to + 1, byDate);
+    return {logs.data() + (first - logs.begin()), logs.data() + (last - logs.begin())};
 }
 
 /**
  * setCurrentDate Method
  * @param date The new current date
  */
-void LogHistory::setCurrentDate(const std::string& date) {
+void LogHistory::setCurrentDate(Date date) {
     currentDate = date;
-    if (logs.find(currentDate) == logs.end()) {
-        logs[currentDate] = LogEntry(currentDate);
-    }
+    getLog(currentDate);
 }
 
 /**
  * getCurrentDate Method
  * @return The current date
  */
-std::string LogHistory::getCurrentDate() const {
+Date LogHistory::getCurrentDate() const {
     return currentDate;
 }
 
 /**
  * getAvailableDates Method
- * @return A vector of dates that have log entries
+ * @return The dates that have log entries, in order
  */
-std::vector<std::string> LogHistory::getAvailableDates() const {
-    std::vector<std::string> dates;
-    for (const auto& [date, _] : logs) {
-        dates.push_back(date);
+std::vector<Date> LogHistory::getAvailableDates() const {
+    if (months.empty()) {
+        return {};
+    }
+    return getAvailableDates(months.begin()->first, months.rbegin()->first.firstOfNextMonth() - 1);
+}
+
+/**
+ * getAvailableDates Method
+ * @param from The first date of the range
+ * @param to The last date of the range (inclusive)
+ * @return The dates within the range that have log entries, in order
+ * The dates come from the day masks of the months, so a month is only read if
+ * it has never been loaded.
+ */
+std::vector<Date> LogHistory::getAvailableDates(Date from, Date to) const {
+    std::vector<Date> dates;
+    for (auto it = months.lower_bound(from.firstOfMonth()); it != months.end() && it->first <= to; ++it) {
+        Month& month = it->second;
+        if (!month.daysKnown) {
+            month.lastUse = ++useClock;
+            loadMonth(it->first, month);
+            monthFaults++;
+            evictColdMonths(currentDate, currentDate);
+        }
+        for (uint32_t mask = month.dayMask; mask != 0; mask &= mask - 1) {
+            Date date = it->first + static_cast<int32_t>(__builtin_ctz(mask));
+            if (date >= from && date <= to) {
+                dates.push_back(date);
+            }
+        }
     }
     return dates;
 }
@@ -182,17 +337,67 @@ std::vector<std::string> LogHistory::getAvailableDates() const {
  * Executes a command and adds it to the history
  */
 void LogHistory::executeCommand(const std::string& command, const std::map<std::string, std::string>& params) {
+    UndoRecord record;
     if (command == "add-food") {
-        std::string foodId = params.at("food_id");
         float servings = std::stof(params.at("servings"));
-        auto cmd = std::make_unique<AddFoodCommand>(getCurrentLog(), foodId, servings);
-        addCommand(std::move(cmd));
+        record = makeRecord(UndoRecord::ADD, currentDate, params.at("food_id"), servings);
     } else if (command == "remove-food") {
-        std::string foodId = params.at("food_id");
-        float servings = getCurrentLog()->getFoods().at(foodId);
-        auto cmd = std::make_unique<RemoveFoodCommand>(getCurrentLog(), foodId, servings);
-        addCommand(std::move(cmd));
+        const std::string& foodId = params.at("food_id");
+        float servings = getCurrentLog()->getServings(foodId);
+        if (servings <= 0) {
+            throw std::invalid_argument("Food not in log: " + foodId);
+        }
+        record = makeRecord(UndoRecord::REMOVE, currentDate, foodId, -servings);
+    } else {
+        return;
     }
+    ConstSpan<UndoRecord> group{&record, &record + 1};
+    applyRecords(group, false);
+    recordChanges(group);
+    undoBuffer.push(group);
+}
+
+/**
+ * executeBatch Method
+ * @param operations The log operations to apply, in order
+ * @return The number of operations applied
+ * @throws invalid_argument if a food to remove is not in the log of its date;
+ *         none of the operations are applied then
+ * The operations form a single command, so one undo or redo reverts or reapplies
+ * all of them. Every changed food and date is journaled and totaled only once.
+ * A batch larger than the undo limit cannot be undone and clears the undo history.
+ */
+size_t LogHistory::executeBatch(const std::vector<LogOperation>& operations) {
+    std::vector<UndoRecord> records;
+    records.reserve(operations.size());
+    
+    LogEntry* log = nullptr;
+    try {
+        for (const LogOperation& op : operations) {
+            // Operations on the same date as the previous one reuse its entry
+            if (!log || log->getDate() != op.date) {
+                log = getLog(op.date);
+            }
+            float delta = op.servings;
+            if (op.type == LogOperation::REMOVE) {
+                delta = -log->getServings(op.foodId);
+                if (delta >= 0) {
+                    throw std::invalid_argument("Food not in log of " + op.date.toString() + ": " + op.foodId);
+                }
+            }
+            records.push_back(makeRecord(op.type == LogOperation::ADD ? UndoRecord::ADD : UndoRecord::REMOVE,
+                                         op.date, op.foodId, delta));
+            applyRecord(*log, records.back(), false);
+        }
+    } catch (...) {
+        applyRecords({records.data(), records.data() + records.size()}, true);
+        throw;
+    }
+    
+    ConstSpan<UndoRecord> group{records.data(), records.data() + records.size()};
+    recordChanges(group);
+    undoBuffer.push(group);
+    return operations.size();
 }
 
 /**
@@ -200,7 +405,7 @@ void LogHistory::executeCommand(const std::string& command, const std::map<std::
  * @return Whether undo is possible
  */
 bool LogHistory::canUndo() const {
-    return currentCommandIndex > 0;
+    return undoBuffer.canUndo();
 }
 
 /**
@@ -208,7 +413,7 @@ bool LogHistory::canUndo() const {
  * @return Whether redo is possible
  */
 bool LogHistory::canRedo() const {
-    return currentCommandIndex < commandHistory.size();
+    return undoBuffer.canRedo();
 }
 
 /**
@@ -216,9 +421,10 @@ bool LogHistory::canRedo() const {
  * Undoes the last command
  */
 void LogHistory::undo() {
-    if (canUndo()) {
-        currentCommandIndex--;
-        commandHistory[currentCommandIndex]->unexecute();
+    if (undoBuffer.undo(undoScratch)) {
+        ConstSpan<UndoRecord> group{undoScratch.data(), undoScratch.data() + undoScratch.size()};
+        applyRecords(group, true);
+        recordChanges(group);
     }
 }
 
@@ -227,20 +433,59 @@ void LogHistory::undo() {
  * Redoes the last undone command
  */
 void LogHistory::redo() {
-    if (canRedo()) {
-        commandHistory[currentCommandIndex]->execute();
-        currentCommandIndex++;
+    if (undoBuffer.redo(undoScratch)) {
+        ConstSpan<UndoRecord> group{undoScratch.data(), undoScratch.data() + undoScratch.size()};
+        applyRecords(group, false);
+        recordChanges(group);
     }
 }
 
+/**
+ * setUndoLimit Method
+ * @param changes The number of changes kept for undo; a batch counts one change per entry
+ */
+void LogHistory::setUndoLimit(size_t changes) {
+    undoBuffer.setCapacity(changes);
+}
+
+/**
+ * getUndoLimit Method
+ * @return The number of changes kept for undo
+ */
+size_t LogHistory::getUndoLimit() const {
+    return undoBuffer.getCapacity();
+}
+
+/**
+ * setUndoSpillPath Method
+ * @param path The file receiving changes evicted from the undo history, or an empty string to drop them
+ */
+void LogHistory::setUndoSpillPath(const std::string& path) {
+    undoBuffer.setSpillPath(path);
+}
+
+/**
+ * getUndoSpillPath Method
+ * @return The file receiving evicted changes, empty if they are dropped
+ */
+const std::string& LogHistory::getUndoSpillPath() const {
+    return undoBuffer.getSpillPath();
+}
+
 /**
  * toJson Method
  * @return A JSON representation of the log history
  */
 json LogHistory::toJson() const {
+    METRICS_TIMER("LogHistory::toJson");
     json j = json::array();
-    for (const auto& [date, log] : logs) {
-        j.push_back(log.toJson());
+    for (const auto& entry : months) {
+        Date first = entry.first;
+        for (const LogEntry& log : getLogs(first, first.firstOfNextMonth() - 1)) {
+            j.push_back(log.toJson());
+        }
+        // Keep at most the budget loaded while going through all months
+        evictColdMonths(currentDate, currentDate);
     }
     return j;
 }
@@ -251,99 +496,646 @@ json LogHistory::toJson() const {
  * Loads log history from JSON
  */
 void LogHistory::fromJson(const json& j) {
-    logs.clear();
+    METRICS_TIMER("LogHistory::fromJson");
+    clearLogs();
     if (j.is_array()) {
+        logs.reserve(j.size() + 1);
         for (const auto& logJson : j) {
-            LogEntry log = LogEntry::fromJson(logJson);
-            logs[log.getDate()] = log;
+            LogEntry& log = storeLog(LogEntry::fromJson(logJson, &logArena));
+            dirtyDates.insert(log.getDate());
         }
     }
     // If there's no log for current date, create one
-    std::string today = getCurrentDateString();
-    if (logs.find(today) == logs.end()) {
-        logs[today] = LogEntry(today);
+    setCurrentDate(Date::today());
+}
+
+/**
+ * saveToFiles Method
+ * Rewrites the monthly log files that contain a changed date. Each file is
+ * replaced atomically. After a migration the legacy single file is removed.
+ */
+void LogHistory::saveToFiles() {
+    METRICS_TIMER("LogHistory::saveToFiles");
+    if (std::function<void()> job = prepareSave()) {
+        job();
     }
-    currentDate = today;
+    collectSaves();
+    
+    // The saved months can be unloaded now
+    evictColdMonths(currentDate, currentDate);
 }
 
 /**
- * getCurrentDateString Method
- * @return The current date as a string (YYYY-MM-DD)
+ * prepareSave Method
+ * @return A job rewriting the monthly log files that contain a changed date, or
+ *         nullptr if none did
+ * The logs of those months are copied now, so the history can keep changing while
+ * the job serializes and writes the copies. Until the job is known to have
+ * finished, the months stay loaded: unloading one and reading its file back would
+ * lose the changes not written yet.
  */
-std::string LogHistory::getCurrentDateString() const {
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d");
-    return ss.str();
+std::function<void()> LogHistory::prepareSave() {
+    METRICS_TIMER("LogHistory::prepareSave");
+    collectSaves();
+    if (!isDirty()) {
+        return nullptr;
+    }
+    
+    std::set<Date> firstDays;
+    for (Date date : dirtyDates) {
+        firstDays.insert(date.firstOfMonth());
+    }
+    auto files = std::make_shared<std::vector<std::pair<std::string, std::vector<LogEntry>>>>();
+    for (Date month : firstDays) {
+        ConstSpan<LogEntry> monthLogs = getLogs(month, month.firstOfNextMonth() - 1);
+        files->emplace_back(monthFilePath(month), std::vector<LogEntry>(monthLogs.begin(), monthLogs.end()));
+    }
+    
+    auto state = std::make_shared<std::atomic<int>>(SAVE_RUNNING);
+    std::string removedPath = legacyLoaded ? legacyLogPath : "";
+    pendingSaves.push_back({state, std::move(dirtyDates), legacyLoaded});
+    dirtyDates.clear();
+    legacyLoaded = false;
+    
+    return [files, state, directory = logDirectory, removedPath]() {
+        METRICS_TIMER("LogHistory::writeMonths");
+        try {
+            std::filesystem::create_directories(directory);
+            for (const auto& [path, monthLogs] : *files) {
+                AtomicFile::write(path, [&monthLogs](std::ostream& out) {
+                    json j = json::array();
+                    for (const LogEntry& log : monthLogs) {
+                        j.push_back(log.toJson());
+                    }
+                    out << std::setw(4) << j << std::endl;
+                });
+            }
+            if (!removedPath.empty()) {
+                std::filesystem::remove(removedPath);
+            }
+            state->store(SAVE_DONE, std::memory_order_release);
+        } catch (...) {
+            state->store(SAVE_FAILED, std::memory_order_release);
+            throw;
+        }
+    };
+}
+
+/**
+ * collectSaves Method
+ * Forgets the save jobs that have finished. The dates of failed jobs are marked
+ * as changed again, so that the next save writes them.
+ */
+void LogHistory::collectSaves() {
+    auto finished = [this](PendingSave& pending) {
+        int state = pending.state->load(std::memory_order_acquire);
+        if (state == SAVE_FAILED) {
+            dirtyDates.insert(pending.dates.begin(), pending.dates.end());
+            legacyLoaded = legacyLoaded || pending.legacy;
+        }
+        return state != SAVE_RUNNING;
+    };
+    pendingSaves.erase(std::remove_if(pendingSaves.begin(), pendingSaves.end(), finished), pendingSaves.end());
 }
 
 /**
- * addCommand Method
- * @param command The command to add to history
+ * loadFromFiles Method
+ * Replaces the history with the contents of the monthly log files. A legacy
+ * single log file is read first and all of its dates are marked as changed, so
+ * that the next save moves them into monthly files; monthly files take precedence.
+ * With lazy loading, the files of months before the last week are only listed;
+ * all files are read while a legacy file still has to be migrated.
  */
-void LogHistory::addCommand(std::unique_ptr<Command> command) {
-    // If we're not at the end of history, remove everything after currentCommandIndex
-    if (currentCommandIndex < commandHistory.size()) {
-        commandHistory.resize(currentCommandIndex);
+void LogHistory::loadFromFiles() {
+    METRICS_TIMER("LogHistory::loadFromFiles");
+    clearLogs();
+    dirtyDates.clear();
+    pendingSaves.clear();
+    legacyLoaded = false;
+    
+    if (std::filesystem::exists(legacyLogPath)) {
+        for (Date date : readLogFile(legacyLogPath)) {
+            dirtyDates.insert(date);
+        }
+        legacyLoaded = true;
     }
     
-    // Execute the command and add it to history
-    command->execute();
-    commandHistory.push_back(std::move(command));
-    currentCommandIndex++;
+    if (std::filesystem::is_directory(logDirectory)) {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& file : std::filesystem::directory_iterator(logDirectory)) {
+            if (file.path().extension() == ".json") {
+                paths.push_back(file.path());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        
+        Date recent = (Date::today() - EAGER_DAYS).firstOfMonth();
+        Date current = Date::today().firstOfMonth();
+        for (const auto& path : paths) {
+            Date first;
+            std::string name = path.stem().string();
+            if (lazyLoading && !legacyLoaded && Date::tryParse(name + "-01", first) &&
+                first.toString().substr(0, 7) == name && (first < recent || first > current) &&
+                months.try_emplace(first, Month{false, false, false, 0, 0}).second) {
+                continue;
+            }
+            for (Date date : readLogFile(path.string())) {
+                dirtyDates.erase(date);
+            }
+        }
+    }
+    
+    // If there's no log for current date, create one
+    setCurrentDate(Date::today());
 }
 
 /**
- * AddFoodCommand Constructor
+ * isDirty Method
+ * @return True if some log files have to be rewritten
  */
-LogHistory::AddFoodCommand::AddFoodCommand(LogEntry* log, const std::string& foodId, float servings) 
-    : log(log), foodId(foodId), servings(servings) {}
+bool LogHistory::isDirty() const {
+    auto failed = [](const PendingSave& pending) { return pending.state->load() == SAVE_FAILED; };
+    return !dirtyDates.empty() || legacyLoaded || std::any_of(pendingSaves.begin(), pendingSaves.end(), failed);
+}
 
 /**
- * execute Method for AddFoodCommand
+ * setLazyLoading Method
+ * @param enabled Whether older months are read on first access instead of by loadFromFiles
+ * @param loadedDays The number of loaded days beyond which unused months are unloaded
+ * Turning lazy loading off reads all months that are not loaded.
  */
-void LogHistory::AddFoodCommand::execute() {
-    log->addFood(foodId, servings);
+void LogHistory::setLazyLoading(bool enabled, size_t loadedDays) {
+    if (enabled && logArena.isEnabled()) {
+        // Unloaded months would leave their servings in the arena until the next
+        // load, so the loaded entries move to the heap
+        std::vector<LogEntry> copies(logs.begin(), logs.end());
+        logs.clear();
+        logArena.setEnabled(false);
+        logArena.release();
+        for (const LogEntry& log : copies) {
+            logs.emplace_back(log, &logArena);
+        }
+    }
+    lazyLoading = enabled;
+    loadedDaysBudget = std::max<size_t>(loadedDays, 1);
+    if (enabled) {
+        evictColdMonths(currentDate, currentDate);
+        return;
+    }
+    for (auto& [first, month] : months) {
+        loadMonth(first, month);
+    }
 }
 
 /**
- * unexecute Method for AddFoodCommand
+ * isLazyLoading Method
+ * @return Whether older months are read on first access
  */
-void LogHistory::AddFoodCommand::unexecute() {
-    log->addFood(foodId, -servings);
+bool LogHistory::isLazyLoading() const {
+    return lazyLoading;
 }
 
 /**
- * toString Method for AddFoodCommand
+ * setArenaLoading Method
+ * @param enabled True to keep the servings of loaded logs in an arena, false to
+ *                allocate them from the heap
+ * The mode applies from the next fromJson or loadFromFiles.
  */
-std::string LogHistory::AddFoodCommand::toString() const {
-    return "AddFood: " + foodId + ", " + std::to_string(servings) + " servings";
+void LogHistory::setArenaLoading(bool enabled) {
+    arenaLoading = enabled;
 }
 
 /**
- * RemoveFoodCommand Constructor
+ * isArenaLoading Method
+ * @return Whether the servings of the loaded logs are kept in an arena
  */
-LogHistory::RemoveFoodCommand::RemoveFoodCommand(LogEntry* log, const std::string& foodId, float servings) 
-    : log(log), foodId(foodId), servings(servings) {}
+bool LogHistory::isArenaLoading() const {
+    return logArena.isEnabled();
+}
 
 /**
- * execute Method for RemoveFoodCommand
+ * getCacheStats Method
+ * @return The counters of the loaded months
  */
-void LogHistory::RemoveFoodCommand::execute() {
-    log->removeFood(foodId);
+LogCacheStats LogHistory::getCacheStats() const {
+    LogCacheStats stats{months.size(), 0, logs.size(), loadedDaysBudget, monthFaults, monthEvictions};
+    for (const auto& entry : months) {
+        stats.loadedMonths += entry.second.loaded ? 1 : 0;
+    }
+    return stats;
 }
 
 /**
- * unexecute Method for RemoveFoodCommand
+ * readLogFile Method
+ * @param path The log file to read
+ * @return The dates read, which replace any entries for the same dates
+ * @throws runtime_error if the file is not valid JSON
  */
-void LogHistory::RemoveFoodCommand::unexecute() {
-    log->addFood(foodId, servings);
+std::vector<Date> LogHistory::readLogFile(const std::string& path) const {
+    std::vector<Date> dates;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return dates;
+    }
+    
+    json j;
+    try {
+        file >> j;
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Invalid log file " + path + ": " + e.what());
+    }
+    if (!j.is_array()) {
+        return dates;
+    }
+    
+    dates.reserve(j.size());
+    for (const auto& logJson : j) {
+        dates.push_back(storeLog(LogEntry::fromJson(logJson, &logArena)).getDate());
+    }
+    return dates;
+}
+
+/**
+ * clearLogs Method
+ * Drops every entry and month, and releases the arena of their servings in the
+ * mode for the logs loaded next.
+ */
+void LogHistory::clearLogs() {
+    logs.clear();
+    months.clear();
+    totalsValid = false;
+    logArena.setEnabled(arenaLoading && !lazyLoading);
+    logArena.release();
+}
+
+/**
+ * storeLog Method
+ * @param log A log entry read from a file
+ * @return The stored entry, replacing any entry for the same date
+ * Files list their dates in order, so entries are usually appended at the end.
+ */
+LogEntry& LogHistory::storeLog(LogEntry&& log) const {
+    Date date = log.getDate();
+    monthOf(date).dayMask |= dayBit(date);
+    if (logs.empty() || logs.back().getDate() < date) {
+        logs.push_back(std::move(log));
+        return logs.back();
+    }
+    auto it = std::lower_bound(logs.begin(), logs.end(), date,
+                               [](const LogEntry& entry, Date d) { return entry.getDate() < d; });
+    if (it == logs.end() || it->getDate() != date) {
+        return *logs.insert(it, std::move(log));
+    }
+    *it = std::move(log);
+    return *it;
+}
+
+/**
+ * monthOf Method
+ * @param date A date
+ * @return The state of the date's month, added as a loaded month if it had no logs
+ */
+LogHistory::Month& LogHistory::monthOf(Date date) const {
+    Date first = date.firstOfMonth();
+    if (!months.empty() && months.rbegin()->first == first) {
+        return months.rbegin()->second;
+    }
+    return months.try_emplace(first, Month{true, true, true, 0, 0}).first->second;
+}
+
+/**
+ * useMonths Method
+ * @param from The first date of a range about to be accessed
+ * @param to The last date of the range (inclusive)
+ * Loads the months of the range that are not loaded, then unloads cold months
+ * outside the range if that exceeded the budget of loaded days.
+ */
+void LogHistory::useMonths(Date from, Date to) const {
+    bool faulted = false;
+    for (auto it = months.lower_bound(from.firstOfMonth()); it != months.end() && it->first <= to; ++it) {
+        it->second.lastUse = ++useClock;
+        if (!it->second.loaded) {
+            loadMonth(it->first, it->second);
+            monthFaults++;
+            faulted = true;
+        }
+    }
+    if (faulted) {
+        evictColdMonths(from, to);
+    }
+}
+
+/**
+ * loadMonth Method
+ * @param first The first day of the month
+ * @param month The state of the month
+ * Reads the month's file if the month is not loaded, and adds its days to the
+ * calorie totals if they are being kept.
+ */
+void LogHistory::loadMonth(Date first, Month& month) const {
+    if (month.loaded) {
+        return;
+    }
+    readLogFile(monthFilePath(first));
+    month.loaded = true;
+    month.daysKnown = true;
+    
+    if (totalsValid && !month.totalled) {
+        auto byDate = [](const LogEntry& log, Date d) { return log.getDate() < d; };
+        auto it = std::lower_bound(logs.begin(), logs.end(), first, byDate);
+        for (; it != logs.end() && it->getDate() < first.firstOfNextMonth(); ++it) {
+            if (!it->getFoods().empty()) {
+                calorieTotals.setDay(it->getDate(), calorieCounter(it->getFoods()));
+            }
+        }
+        month.totalled = true;
+    }
+}
+
+/**
+ * totalMonths Method
+ * @param from The first date of a range about to be totalled
+ * @param to The last date of the range (inclusive)
+ * Adds the days of the range that are missing from the calorie totals. Months
+ * read for that may be unloaded again right away; their totals are kept.
+ */
+void LogHistory::totalMonths(Date from, Date to) const {
+    for (auto it = months.lower_bound(from.firstOfMonth()); it != months.end() && it->first <= to; ++it) {
+        if (!it->second.totalled) {
+            it->second.lastUse = ++useClock;
+            loadMonth(it->first, it->second);
+            monthFaults++;
+            evictColdMonths(currentDate, currentDate);
+        }
+    }
+}
+
+/**
+ * evictColdMonths Method
+ * @param keepFrom The first date of a range whose months stay loaded
+ * @param keepTo The last date of the range (inclusive)
+ * With lazy loading, unloads the least recently used months until no more days
+ * than the budget are loaded. The current month and months with unsaved changes
+ * stay loaded.
+ */
+void LogHistory::evictColdMonths(Date keepFrom, Date keepTo) const {
+    if (!lazyLoading) {
+        return;
+    }
+    Date current = currentDate.firstOfMonth();
+    while (logs.size() > loadedDaysBudget) {
+        std::map<Date, Month>::iterator coldest = months.end();
+        for (auto it = months.begin(); it != months.end(); ++it) {
+            Date first = it->first;
+            if (!it->second.loaded || first == current || (first <= keepTo && first.firstOfNextMonth() > keepFrom) ||
+                hasDirtyDates(first)) {
+                continue;
+            }
+            if (coldest == months.end() || it->second.lastUse < coldest->second.lastUse) {
+                coldest = it;
+            }
+        }
+        if (coldest == months.end()) {
+            return;
+        }
+        
+        auto byDate = [](const LogEntry& log, Date d) { return log.getDate() < d; };
+        auto begin = std::lower_bound(logs.begin(), logs.end(), coldest->first, byDate);
+        auto end = std::lower_bound(begin, logs.end(), coldest->first.firstOfNextMonth(), byDate);
+        logs.erase(begin, end);
+        coldest->second.loaded = false;
+        monthEvictions++;
+    }
+}
+
+/**
+ * hasDirtyDates Method
+ * @param first The first day of a month
+ * @return Whether the month has changes that are not written to its file
+ */
+bool LogHistory::hasDirtyDates(Date first) const {
+    auto inMonth = [first](const std::set<Date>& dates) {
+        auto it = dates.lower_bound(first);
+        return it != dates.end() && *it < first.firstOfNextMonth();
+    };
+    if (legacyLoaded || inMonth(dirtyDates)) {
+        return true;
+    }
+    // Months still being written by a save job count as changed
+    return std::any_of(pendingSaves.begin(), pendingSaves.end(),
+                       [&inMonth](const PendingSave& pending) { return pending.legacy || inMonth(pending.dates); });
+}
+
+/**
+ * monthFilePath Method
+ * @param month A day of the month
+ * @return The path of the log file for the month (<directory>/YYYY-MM.json)
+ */
+std::string LogHistory::monthFilePath(Date month) const {
+    return logDirectory + "/" + month.toString().substr(0, 7) + ".json";
+}
+
+/**
+ * makeRecord Method
+ * @param op The kind of change
+ * @param date The date of the changed log
+ * @param foodId The food whose servings change
+ * @param delta The servings added by the change
+ * @return The undo record of the change
+ */
+UndoRecord LogHistory::makeRecord(UndoRecord::Op op, Date date, const std::string& foodId, float delta) {
+    UndoRecord record{};
+    record.op = op;
+    record.food = FoodIds::getInstance().intern(foodId);
+    record.day = date.daysSinceEpoch();
+    record.delta = delta;
+    return record;
 }
 
 /**
- * toString Method for RemoveFoodCommand
+ * applyRecord Method
+ * @param log The log of the record's date
+ * @param record A change record
+ * @param reverse Whether to revert the change instead of applying it
  */
-std::string LogHistory::RemoveFoodCommand::toString() const {
-    return "RemoveFood: " + foodId;
+void LogHistory::applyRecord(LogEntry& log, const UndoRecord& record, bool reverse) {
+    // Marked right away, so that loading the next record's month cannot unload this one
+    dirtyDates.insert(log.getDate());
+    if (record.op == UndoRecord::REMOVE && !reverse) {
+        log.setServings(record.food, 0.0f);
+        return;
+    }
+    float servings = log.getServings(record.food) + (reverse ? -record.delta : record.delta);
+    log.setServings(record.food, servings > SERVINGS_EPSILON ? servings : 0.0f);
+}
+
+/**
+ * applyRecords Method
+ * @param records The records of a command, in execution order
+ * @param reverse Whether to revert the changes, last change first
+ * Only sets the servings and marks the dates; recordChanges does the other bookkeeping.
+ */
+void LogHistory::applyRecords(ConstSpan<UndoRecord> records, bool reverse) {
+    LogEntry* log = nullptr;
+    for (size_t i = 0; i < records.size(); i++) {
+        const UndoRecord& record = records[reverse ? records.size() - 1 - i : i];
+        if (!log || log->getDate().daysSinceEpoch() != record.day) {
+            log = getLog(Date(record.day));
+        }
+        applyRecord(*log, record, reverse);
+    }
+}
+
+/**
+ * recordChange Method
+ * @param log The log entry that changed
+ * @param food The food whose servings changed
+ * Marks the date as changed and appends the resulting servings of the food
+ * (zero if removed) to the journal, if one is attached.
+ */
+void LogHistory::recordChange(const LogEntry& log, FoodHandle food) {
+    dirtyDates.insert(log.getDate());
+    if (totalsValid) {
+        calorieTotals.setDay(log.getDate(), calorieCounter(log.getFoods()));
+    }
+    if (journal) {
+        journal->append(servingsRecord(log, food));
+    }
+}
+
+/**
+ * recordChanges Method
+ * @param records The records of a command that was just applied or reverted
+ * Like recordChange for every record, but each changed food and date is
+ * handled once and all journal records are appended in a single write.
+ */
+void LogHistory::recordChanges(ConstSpan<UndoRecord> records) {
+    if (records.size() == 1) {
+        recordChange(*findLog(Date(records[0].day)), records[0].food);
+        return;
+    }
+    
+    std::vector<std::pair<int32_t, uint32_t>> keys;
+    keys.reserve(records.size());
+    for (const UndoRecord& record : records) {
+        keys.emplace_back(record.day, record.food);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    
+    std::vector<json> entries;
+    const LogEntry* log = nullptr;
+    for (const auto& [day, food] : keys) {
+        if (!log || log->getDate().daysSinceEpoch() != day) {
+            log = findLog(Date(day));
+            dirtyDates.insert(dirtyDates.end(), log->getDate());
+            if (totalsValid) {
+                calorieTotals.setDay(log->getDate(), calorieCounter(log->getFoods()));
+            }
+        }
+        if (journal) {
+            entries.push_back(servingsRecord(*log, food));
+        }
+    }
+    if (journal) {
+        journal->append(entries);
+    }
+}
+
+/**
+ * servingsRecord Method
+ * @param log A log entry
+ * @param food A food of the entry, which may have been removed
+ * @return The journal record of the servings of the food (zero if removed)
+ */
+json LogHistory::servingsRecord(const LogEntry& log, FoodHandle food) {
+    return json{{"op", "log-set"}, {"date", log.getDate().toString()}, {"food", FoodIds::getInstance().name(food)},
+                {"servings", log.getServings(food)}};
+}
+
+/**
+ * setJournal Method
+ * @param journal The journal to append changes to, or nullptr to stop journaling
+ */
+void LogHistory::setJournal(Journal* journal) {
+    this->journal = journal;
+}
+
+/**
+ * applyJournalRecord Method
+ * @param record A record written by this class to the journal
+ * Sets the servings the record holds; records of other kinds are ignored.
+ */
+void LogHistory::applyJournalRecord(const json& record) {
+    if (record.value("op", "") != "log-set") {
+        return;
+    }
+    Date date = Date::fromString(record.at("date").get<std::string>());
+    LogEntry* log = getLog(date);
+    log->setServings(record.at("food").get<std::string>(), record.at("servings").get<float>());
+    dirtyDates.insert(date);
+    if (totalsValid) {
+        calorieTotals.setDay(date, calorieCounter(log->getFoods()));
+    }
+}
+
+/**
+ * setCalorieSource Method
+ * @param counter Returns the total calories of a day's food handles and servings
+ * @param version Returns a value that changes whenever food calories may have changed
+ */
+void LogHistory::setCalorieSource(CalorieCounter counter, std::function<uint64_t()> version) {
+    calorieCounter = std::move(counter);
+    calorieVersion = std::move(version);
+    totalsValid = false;
+}
+
+/**
+ * getDayCalories Method
+ * @param date A day
+ * @return The calories logged on the day
+ */
+double LogHistory::getDayCalories(Date date) const {
+    const CalorieTotals& totals = currentTotals();
+    totalMonths(date, date);
+    return totals.getDay(date);
+}
+
+/**
+ * getTotalCalories Method
+ * @param from The first day of the range
+ * @param to The last day of the range (inclusive)
+ * @return The calories logged on the days of the range
+ */
+double LogHistory::getTotalCalories(Date from, Date to) const {
+    const CalorieTotals& totals = currentTotals();
+    totalMonths(from, to);
+    return totals.getTotal(from, to);
+}
+
+/**
+ * currentTotals Method
+ * @return The daily calorie totals, rebuilt if the logs were reloaded or food calories changed
+ * @throws logic_error if no calorie source was set
+ */
+const CalorieTotals& LogHistory::currentTotals() const {
+    if (!calorieCounter) {
+        throw std::logic_error("No calorie source set for the log history");
+    }
+    uint64_t version = calorieVersion ? calorieVersion() : 0;
+    if (!totalsValid || version != totalsVersion) {
+        calorieTotals.clear();
+        for (const LogEntry& log : logs) {
+            if (!log.getFoods().empty()) {
+                calorieTotals.setDay(log.getDate(), calorieCounter(log.getFoods()));
+            }
+        }
+        // Months that are not loaded are added when a total needs them
+        for (auto& entry : months) {
+            entry.second.totalled = entry.second.loaded;
+        }
+        totalsValid = true;
+        totalsVersion = version;
+    }
+    return calorieTotals;
 }
@@ -7,10 +7,21 @@
  * management system with undo/redo capabilities.
  * 
  * Key components:
- * - LogEntry class representing a single day's food consumption record
+ * - LogEntry class representing a single day's food consumption record, holding
+ *   process-wide food handles (see FoodIds) in a small vector sorted by handle
  * - LogHistory class managing a collection of log entries with undo/redo functionality
- * - Command pattern implementation for log operations
+ * - Date-ordered, contiguous storage of log entries keyed by compact dates
+ * - Calorie totals over date ranges, maintained incrementally (see CalorieTotals)
+ * - Bounded undo/redo history of compact change records (see UndoBuffer)
+ * - Batches of log operations applied, undone and redone as a single command
  * - Serialization and deserialization to/from JSON
+ * - Monthly log files, of which only those with modified dates are rewritten
+ * - Saving in the background from copies of the modified months
+ * - Optional lazy loading of older months on first access, with the least
+ *   recently used unmodified months unloaded beyond a budget of loaded days
+ * - Journaling of log changes and replay of journal records
+ * - Servings of fully loaded histories kept in an arena released on reload
+ *   (see LoadArena)
  * 
  * The logging system tracks food consumption over time, allowing users to monitor
  * their dietary habits and calorie intake across multiple days.
@@ -21,9 +32,21 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
-#include <chrono>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <atomic>
+#include <cstdint>
 #include <nlohmann/json.hpp>
+#include "../utils/journal.h"
+#include "../utils/date.h"
+#include "../utils/const_span.h"
+#include "../utils/food_ids.h"
+#include "../utils/load_arena.h"
+#include "calorie_totals.h"
+#include "undo_buffer.h"
 
 using namespace std;
 using json = nlohmann::json;
@@ -34,23 +57,55 @@ using json = nlohmann::json;
  */
 class LogEntry {
 public:
-    // Constructor
-    LogEntry(const string& date = "");
+    // Constructors; the servings are allocated from the given memory resource, and
+    // copies made without one allocate from the default resource
+    explicit LogEntry(Date date = Date::today(), pmr::memory_resource* resource = pmr::get_default_resource());
+    LogEntry(const LogEntry& other, pmr::memory_resource* resource);
     
     // Methods
     void addFood(const string& foodId, float servings);
     void removeFood(const string& foodId);
-    map<string, float> getFoods() const;
-    string getDate() const;
-    void setDate(const string& date);
+    void setServings(const string& foodId, float servings);
+    void setServings(FoodHandle food, float servings);
+    float getServings(const string& foodId) const;
+    float getServings(FoodHandle food) const;
+    ConstSpan<FoodServings> getFoods() const;
+    Date getDate() const;
+    void setDate(Date date);
     
-    // Serialization
+    // Serialization (food IDs are resolved from their handles)
     json toJson() const;
-    static LogEntry fromJson(const json& j);
+    static LogEntry fromJson(const json& j, pmr::memory_resource* resource = pmr::get_default_resource());
 
 private:
-    string date;
-    map<string, float> foods; // foodId -> servings
+    Date date;
+    pmr::vector<FoodServings> foods; // Sorted by handle, servings always positive
+};
+
+/**
+ * LogOperation struct
+ * One change to the logs, applied as part of a batch (see LogHistory::executeBatch)
+ */
+struct LogOperation {
+    enum Type { ADD, REMOVE };
+    
+    Type type;
+    Date date;
+    string foodId;
+    float servings; // Servings added; ignored for REMOVE
+};
+
+/**
+ * LogCacheStats struct
+ * Counters of the months of logs kept in memory (see LogHistory::setLazyLoading)
+ */
+struct LogCacheStats {
+    size_t months;       // Months with logs, loaded or not
+    size_t loadedMonths;
+    size_t loadedDays;
+    size_t budgetDays;
+    uint64_t faults;     // Months read on first access
+    uint64_t evictions;  // Months unloaded to stay within the budget
 };
 
 /**
@@ -60,68 +115,156 @@ private:
 class LogHistory {
 public:
     // Constructor
-    LogHistory();
+    LogHistory(const string& logDirectory = "data/logs", const string& legacyLogPath = "data/logs.json");
     
-    // Log entry methods
+    // Log entry methods (pointers stay valid until a log for a new date is created
+    // or another month is loaded)
     LogEntry* getCurrentLog();
-    LogEntry* getLog(const string& date);
-    void setCurrentDate(const string& date);
-    string getCurrentDate() const;
-    vector<string> getAvailableDates() const;
+    LogEntry* getLog(Date date);
+    const LogEntry* findLog(Date date) const;
+    ConstSpan<LogEntry> getLogs(Date from, Date to) const;
+    void setCurrentDate(Date date);
+    Date getCurrentDate() const;
+    vector<Date> getAvailableDates() const;
+    vector<Date> getAvailableDates(Date from, Date to) const;
     
     // Command methods
     void executeCommand(const string& command, const map<string, string>& params);
+    size_t executeBatch(const vector<LogOperation>& operations);
     bool canUndo() const;
     bool canRedo() const;
     void undo();
     void redo();
     
+    // Undo history limit, in changes; evicted changes spill to a file if a path is set
+    void setUndoLimit(size_t changes);
+    size_t getUndoLimit() const;
+    void setUndoSpillPath(const string& path);
+    const string& getUndoSpillPath() const;
+    
     // Serialization
     json toJson() const;
     void fromJson(const json& j);
+    
+    // Persistence in one file per month (<directory>/YYYY-MM.json)
+    void saveToFiles();
+    void loadFromFiles();
+    bool isDirty() const;
+    
+    // Background saving: the returned job writes the modified months from copies
+    // taken now (nullptr if nothing changed). Jobs may run on another thread, one
+    // at a time in the order they were prepared, and must finish before the next
+    // loadFromFiles.
+    function<void()> prepareSave();
+    
+    // Lazy loading: loadFromFiles only reads the months of the last week, older
+    // months are read when first accessed, and the least recently used months
+    // without unsaved changes are unloaded while more days than the budget are loaded
+    static const size_t DEFAULT_LOADED_DAYS = 366;
+    void setLazyLoading(bool enabled, size_t loadedDays = DEFAULT_LOADED_DAYS);
+    bool isLazyLoading() const;
+    LogCacheStats getCacheStats() const;
+    
+    // Arena for the servings of the logs read by fromJson and loadFromFiles
+    // (default), or the heap; applies from the next load. Lazily loaded
+    // histories, whose months come and go, always use the heap.
+    void setArenaLoading(bool enabled);
+    bool isArenaLoading() const;
+    
+    // Write-ahead journal (changes are appended while one is attached)
+    void setJournal(Journal* journal);
+    void applyJournalRecord(const json& record);
+    
+    // Calorie totals. The counter returns the calories of a day's servings; the
+    // version changes whenever food calories may have changed, which invalidates
+    // the cached totals.
+    using CalorieCounter = function<float(ConstSpan<FoodServings> servings)>;
+    void setCalorieSource(CalorieCounter counter, function<uint64_t()> version);
+    double getDayCalories(Date date) const;
+    double getTotalCalories(Date from, Date to) const;
 
 private:
-    map<string, LogEntry> logs;
-    string currentDate;
-    
-    // Command history for undo/redo
-    class Command {
-    public:
-        virtual ~Command() = default;
-        virtual void execute() = 0;
-        virtual void unexecute() = 0;
-        virtual string toString() const = 0;
+    /**
+     * Month struct
+     * The state of one month of logs, stored in <directory>/YYYY-MM.json once saved
+     */
+    struct Month {
+        bool loaded;       // Its entries are in logs
+        bool totalled;     // Its days are in calorieTotals
+        bool daysKnown;    // dayMask lists its dates
+        uint32_t dayMask;  // Bit d - 1 is set if there is a log for day d
+        uint64_t lastUse;
     };
     
-    class AddFoodCommand : public Command {
-    public:
-        AddFoodCommand(LogEntry* log, const string& foodId, float servings);
-        void execute() override;
-        void unexecute() override;
-        string toString() const override;
-    private:
-        LogEntry* log;
-        string foodId;
-        float servings;
-    };
+    // Memory of the entries' servings; every entry in logs allocates from it, so
+    // moving entries around never copies their servings
+    mutable LoadArena logArena;
+    bool arenaLoading;
+    
+    // Log entries of the loaded months sorted by date, at most one per date.
+    // Reading a month on first access changes them even in const methods.
+    mutable vector<LogEntry> logs;
+    Date currentDate;
+    
+    // Every month with logs, keyed by its first day
+    mutable map<Date, Month> months;
+    bool lazyLoading;
+    size_t loadedDaysBudget;
+    mutable uint64_t useClock;
+    mutable uint64_t monthFaults;
+    mutable uint64_t monthEvictions;
     
-    class RemoveFoodCommand : public Command {
-    public:
-        RemoveFoodCommand(LogEntry* log, const string& foodId, float servings);
-        void execute() override;
-        void unexecute() override;
-        string toString() const override;
-    private:
-        LogEntry* log;
-        string foodId;
-        float servings;
+    // Dates changed since the log files were last written or read
+    set<Date> dirtyDates;
+    
+    /**
+     * PendingSave struct
+     * A prepared save job whose months stay loaded until it has written them. The
+     * job sets the state; a failed job's dates become dirty again.
+     */
+    enum SaveState : int { SAVE_RUNNING = 0, SAVE_DONE = 1, SAVE_FAILED = 2 };
+    struct PendingSave {
+        shared_ptr<atomic<int>> state;
+        set<Date> dates;
+        bool legacy;
     };
+    vector<PendingSave> pendingSaves;
+    string logDirectory;
+    string legacyLogPath;
+    bool legacyLoaded;
+    
+    // Journal receiving log changes; not owned
+    Journal* journal;
+    
+    // Daily calorie totals, rebuilt on first use after being invalidated
+    CalorieCounter calorieCounter;
+    function<uint64_t()> calorieVersion;
+    mutable CalorieTotals calorieTotals;
+    mutable bool totalsValid;
+    mutable uint64_t totalsVersion;
     
-    vector<unique_ptr<Command>> commandHistory;
-    size_t currentCommandIndex;
+    // Bounded undo/redo history of change records
+    UndoBuffer undoBuffer;
+    vector<UndoRecord> undoScratch;
     
-    string getCurrentDateString() const;
-    void addCommand(unique_ptr<Command> command);
+    UndoRecord makeRecord(UndoRecord::Op op, Date date, const string& foodId, float delta);
+    void applyRecord(LogEntry& log, const UndoRecord& record, bool reverse);
+    void applyRecords(ConstSpan<UndoRecord> records, bool reverse);
+    void recordChange(const LogEntry& log, FoodHandle food);
+    void recordChanges(ConstSpan<UndoRecord> records);
+    static json servingsRecord(const LogEntry& log, FoodHandle food);
+    vector<Date> readLogFile(const string& path) const;
+    void clearLogs();
+    LogEntry& storeLog(LogEntry&& log) const;
+    Month& monthOf(Date date) const;
+    void useMonths(Date from, Date to) const;
+    void loadMonth(Date first, Month& month) const;
+    void totalMonths(Date from, Date to) const;
+    void evictColdMonths(Date keepFrom, Date keepTo) const;
+    bool hasDirtyDates(Date first) const;
+    void collectSaves();
+    const CalorieTotals& currentTotals() const;
+    string monthFilePath(Date month) const;
 };
 
 #endif // LOG_ENTRY_H
@@ -0,0 +1,419 @@
+/**
+ * @file metric_series.cpp
+ * @brief Columnar Time Series Implementation
+ *
+ * This file implements the MetricSeries class defined in metric_series.h.
+ * Saving appends the rows added since the previous save to the file, rewriting
+ * only the last saved row if it was replaced since. The file is rewritten as a
+ * whole only when it is new or the series was cleared.
+ *
+ * Key implementations:
+ * - Frame-of-reference encoding and decoding of timestamps
+ * - Delta encoding of timestamps in the file
+ * - Positional writes of new rows, followed by a sync
+ */
+
+#include "metric_series.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../utils/atomic_file.h"
+
+namespace {
+
+const char FILE_MAGIC[4] = {'D', 'M', 'T', 'S'};
+const uint32_t FILE_VERSION = 1;
+
+/**
+ * FileHeader struct
+ * The first bytes of a metrics file
+ */
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t firstTimestamp;
+};
+
+/**
+ * FileRow struct
+ * One row of a metrics file
+ */
+struct FileRow {
+    uint32_t delta; // Seconds since the previous row (0 for the first row)
+    float weight;
+    uint16_t age;
+    uint8_t activityLevel;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader must stay 16 bytes");
+static_assert(sizeof(FileRow) == 12, "FileRow must stay 12 bytes");
+
+/**
+ * writeAt Function
+ * @param fd The file
+ * @param path The path of the file, for error messages
+ * @param data The bytes to write
+ * @param size The number of bytes
+ * @param position The position in the file
+ */
+void writeAt(int fd, const std::string& path, const void* data, size_t size, off_t position) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, bytes, size, position);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write " + path + ": " + std::strerror(errno));
+        }
+        bytes += written;
+        position += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+/**
+ * MetricSeries Constructor
+ */
+MetricSeries::MetricSeries() : savedRows(0), lastRowChanged(false) {
+}
+
+/**
+ * size Method
+ * @return The number of rows
+ */
+size_t MetricSeries::size() const {
+    return offsets.size();
+}
+
+/**
+ * empty Method
+ * @return Whether the series has no rows
+ */
+bool MetricSeries::empty() const {
+    return offsets.empty();
+}
+
+/**
+ * at Method
+ * @param row A row index
+ * @return The metrics of the row
+ */
+DailyMetric MetricSeries::at(size_t row) const {
+    DailyMetric metric;
+    metric.timestamp = timestampAt(row);
+    metric.weight = weightColumn[row];
+    metric.age = ageColumn[row];
+    metric.activityLevel = activityColumn[row];
+    return metric;
+}
+
+/**
+ * back Method
+ * @return The metrics of the last row; the series must not be empty
+ */
+DailyMetric MetricSeries::back() const {
+    return at(size() - 1);
+}
+
+/**
+ * timestampAt Method
+ * @param row A row index
+ * @return The timestamp of the row
+ */
+time_t MetricSeries::timestampAt(size_t row) const {
+    return static_cast<time_t>(blockBases[row / BLOCK_SIZE] + offsets[row]);
+}
+
+/**
+ * lowerBound Method
+ * @param timestamp A timestamp
+ * @return The index of the first row at or after the timestamp (size() if none)
+ */
+size_t MetricSeries::lowerBound(time_t timestamp) const {
+    // The answer lies in the last block starting before the timestamp, or starts the next one
+    auto block = std::lower_bound(blockBases.begin(), blockBases.end(), static_cast<int64_t>(timestamp));
+    if (block == blockBases.begin()) {
+        return 0;
+    }
+    size_t low = static_cast<size_t>(block - blockBases.begin() - 1) * BLOCK_SIZE;
+    size_t high = std::min(size(), low + BLOCK_SIZE);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (timestampAt(middle) < timestamp) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * weights Method
+ * @return The weight of every row, in kg
+ */
+ConstSpan<float> MetricSeries::weights() const {
+    return {weightColumn.data(), weightColumn.data() + weightColumn.size()};
+}
+
+/**
+ * ages Method
+ * @return The age of every row, in years
+ */
+ConstSpan<uint16_t> MetricSeries::ages() const {
+    return {ageColumn.data(), ageColumn.data() + ageColumn.size()};
+}
+
+/**
+ * activityLevels Method
+ * @return The activity level of every row, as an integer equivalent of ActivityLevel
+ */
+ConstSpan<uint8_t> MetricSeries::activityLevels() const {
+    return {activityColumn.data(), activityColumn.data() + activityColumn.size()};
+}
+
+/**
+ * append Method
+ * @param metric The metrics of a new last row
+ * @throws invalid_argument if the row is more than 136 years after the rows before it
+ */
+void MetricSeries::append(const DailyMetric& metric) {
+    store(size(), metric);
+}
+
+/**
+ * replaceLast Method
+ * @param metric The new metrics of the last row; appended if the series is empty
+ */
+void MetricSeries::replaceLast(const DailyMetric& metric) {
+    if (empty()) {
+        append(metric);
+        return;
+    }
+    size_t row = size() - 1;
+    store(row, metric);
+    if (row < savedRows) {
+        lastRowChanged = true;
+    }
+}
+
+/**
+ * clear Method
+ * Removes all rows; the next save rewrites the file.
+ */
+void MetricSeries::clear() {
+    blockBases.clear();
+    offsets.clear();
+    weightColumn.clear();
+    ageColumn.clear();
+    activityColumn.clear();
+    savedPath.clear();
+    savedRows = 0;
+    lastRowChanged = false;
+}
+
+/**
+ * load Method
+ * @param path A metrics file
+ * @return False if the file does not exist, in which case the series is unchanged
+ * @throws runtime_error if the file is not a metrics file
+ */
+bool MetricSeries::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    FileHeader header;
+    if (bytes.size() < sizeof(header)) {
+        throw std::runtime_error("Invalid metrics file " + path + ": too short");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION) {
+        throw std::runtime_error("Invalid metrics file " + path + ": unknown format");
+    }
+
+    clear();
+    size_t rows = (bytes.size() - sizeof(header)) / sizeof(FileRow);
+    blockBases.reserve(rows / BLOCK_SIZE + 1);
+    offsets.reserve(rows);
+    weightColumn.reserve(rows);
+    ageColumn.reserve(rows);
+    activityColumn.reserve(rows);
+
+    int64_t timestamp = header.firstTimestamp;
+    const char* data = bytes.data() + sizeof(header);
+    for (size_t row = 0; row < rows; row++) {
+        FileRow fileRow;
+        std::memcpy(&fileRow, data + row * sizeof(FileRow), sizeof(FileRow));
+        timestamp += fileRow.delta;
+        store(row, {static_cast<time_t>(timestamp), fileRow.weight, fileRow.age, fileRow.activityLevel});
+    }
+
+    savedPath = path;
+    savedRows = rows;
+    return true;
+}
+
+/**
+ * save Method
+ * @param path The metrics file
+ * Writes the rows added (or replaced) since the series was last saved to or
+ * loaded from the file, and syncs it.
+ */
+void MetricSeries::save(const std::string& path) {
+    if (path != savedPath || !std::filesystem::exists(path)) {
+        rewrite(path);
+        return;
+    }
+    if (!isDirty()) {
+        return;
+    }
+
+    // Rows are delta encoded, so rewriting the last saved row only needs the one before it
+    size_t first = lastRowChanged ? savedRows - 1 : savedRows;
+    std::vector<FileRow> rows;
+    rows.reserve(size() - first);
+    for (size_t row = first; row < size(); row++) {
+        uint32_t delta = row == 0 ? 0 : static_cast<uint32_t>(timestampAt(row) - timestampAt(row - 1));
+        rows.push_back({delta, weightColumn[row], ageColumn[row], activityColumn[row], 0});
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+    try {
+        if (first == 0) {
+            FileHeader header;
+            std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+            header.version = FILE_VERSION;
+            header.firstTimestamp = static_cast<int64_t>(timestampAt(0));
+            writeAt(fd, path, &header, sizeof(header), 0);
+        }
+        off_t position = static_cast<off_t>(sizeof(FileHeader) + first * sizeof(FileRow));
+        writeAt(fd, path, rows.data(), rows.size() * sizeof(FileRow), position);
+        // Drops a torn row left behind by an interrupted save
+        off_t length = static_cast<off_t>(sizeof(FileHeader) + size() * sizeof(FileRow));
+        if (::ftruncate(fd, length) != 0 || ::fsync(fd) != 0) {
+            throw std::runtime_error("Failed to sync " + path + ": " + std::strerror(errno));
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+
+    savedRows = size();
+    lastRowChanged = false;
+}
+
+/**
+ * isDirty Method
+ * @return Whether rows were added or replaced since the last save or load
+ */
+bool MetricSeries::isDirty() const {
+    return savedRows != size() || lastRowChanged;
+}
+
+/**
+ * toJson Method
+ * @return The rows as an array of JSON objects
+ */
+json MetricSeries::toJson() const {
+    json metrics = json::array();
+    for (size_t row = 0; row < size(); row++) {
+        metrics.push_back(at(row).toJson());
+    }
+    return metrics;
+}
+
+/**
+ * fromJson Method
+ * @param metrics An array of JSON objects, replacing the rows; the next save rewrites the file
+ */
+void MetricSeries::fromJson(const json& metrics) {
+    clear();
+    for (const auto& metricJson : metrics) {
+        append(DailyMetric::fromJson(metricJson));
+    }
+}
+
+/**
+ * store Method
+ * @param row The index of the last row, or size() to append one
+ * @param metric The metrics to store in the row
+ */
+void MetricSeries::store(size_t row, const DailyMetric& metric) {
+    const int64_t maxGap = static_cast<int64_t>(std::numeric_limits<uint32_t>::max());
+    int64_t timestamp = static_cast<int64_t>(metric.timestamp);
+    if (row > 0) {
+        int64_t previous = static_cast<int64_t>(timestampAt(row - 1));
+        timestamp = std::max(timestamp, previous);
+        if (timestamp - previous > maxGap) {
+            throw std::invalid_argument("Daily metrics are too far apart to be stored");
+        }
+    }
+
+    size_t block = row / BLOCK_SIZE;
+    if (row % BLOCK_SIZE == 0) {
+        if (block == blockBases.size()) {
+            blockBases.push_back(timestamp);
+        } else {
+            blockBases[block] = timestamp;
+        }
+    }
+    int64_t offset = timestamp - blockBases[block];
+    if (offset > maxGap) {
+        throw std::invalid_argument("Daily metrics are too far apart to be stored");
+    }
+
+    uint16_t age = static_cast<uint16_t>(std::clamp(metric.age, 0, 0xFFFF));
+    uint8_t activityLevel = static_cast<uint8_t>(std::clamp(metric.activityLevel, 0, 0xFF));
+    if (row == size()) {
+        offsets.push_back(static_cast<uint32_t>(offset));
+        weightColumn.push_back(metric.weight);
+        ageColumn.push_back(age);
+        activityColumn.push_back(activityLevel);
+    } else {
+        offsets[row] = static_cast<uint32_t>(offset);
+        weightColumn[row] = metric.weight;
+        ageColumn[row] = age;
+        activityColumn[row] = activityLevel;
+    }
+}
+
+/**
+ * rewrite Method
+ * @param path The metrics file, replaced with all rows
+ */
+void MetricSeries::rewrite(const std::string& path) {
+    AtomicFile::write(path, [this](std::ostream& out) {
+        FileHeader header;
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.firstTimestamp = empty() ? 0 : static_cast<int64_t>(timestampAt(0));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (size_t row = 0; row < size(); row++) {
+            uint32_t delta = row == 0 ? 0 : static_cast<uint32_t>(timestampAt(row) - timestampAt(row - 1));
+            FileRow fileRow{delta, weightColumn[row], ageColumn[row], activityColumn[row], 0};
+            out.write(reinterpret_cast<const char*>(&fileRow), sizeof(fileRow));
+        }
+    });
+    savedPath = path;
+    savedRows = size();
+    lastRowChanged = false;
+}
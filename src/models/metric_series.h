@@ -0,0 +1,124 @@
+/**
+ * @file metric_series.h
+ * @brief Columnar Time Series of Daily User Metrics
+ *
+ * This file defines the MetricSeries class which stores the history of a user's
+ * daily metrics (timestamp, weight, age, activity level) as one column per field
+ * instead of a vector of structs. Calculations over the history then stream over
+ * contiguous arrays of a single type, and every row takes 11 bytes in memory.
+ *
+ * Timestamps are frame-of-reference encoded: rows are grouped into blocks of
+ * BLOCK_SIZE, each block keeps the timestamp of its first row, and every row
+ * keeps a 32-bit offset from it. Random access stays O(1).
+ *
+ * Key features:
+ * - Append-only storage with the last row replaceable (today's record); a
+ *   timestamp earlier than the previous row's is raised to it
+ * - Binary search by timestamp, since timestamps never decrease
+ * - Read-only views of the weight, age and activity level columns
+ * - Append-only persistence: saving writes only the rows added since the last save
+ * - Conversion from and to the JSON array used by earlier versions of user.json
+ *
+ * File format: a 16-byte header ("DMTS", version, timestamp of the first row)
+ * followed by 12-byte rows holding the timestamp delta to the previous row, the
+ * weight, the age and the activity level. A torn row at the end is ignored.
+ */
+
+#ifndef METRIC_SERIES_H
+#define METRIC_SERIES_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <nlohmann/json.hpp>
+#include "../utils/const_span.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * DailyMetric struct
+ * Represents a daily record of user metrics
+ */
+struct DailyMetric {
+    time_t timestamp;
+    float weight;
+    int age;
+    int activityLevel; // Stored as an integer equivalent of ActivityLevel enum
+
+    json toJson() const {
+        json j;
+        j["timestamp"] = timestamp;
+        j["weight"] = weight;
+        j["age"] = age;
+        j["activityLevel"] = activityLevel;
+        return j;
+    }
+
+    static DailyMetric fromJson(const json& j) {
+        DailyMetric metric;
+        metric.timestamp = j.value("timestamp", time(nullptr));
+        metric.weight = j.value("weight", 0.0f);
+        metric.age = j.value("age", 0);
+        metric.activityLevel = j.value("activityLevel", 2); // Default to MODERATE
+        return metric;
+    }
+};
+
+/**
+ * MetricSeries Class
+ * This class stores daily metrics in columns and persists them append-only.
+ */
+class MetricSeries {
+public:
+    static const size_t BLOCK_SIZE = 256;
+
+    MetricSeries();
+
+    // Rows
+    size_t size() const;
+    bool empty() const;
+    DailyMetric at(size_t row) const;
+    DailyMetric back() const;
+    time_t timestampAt(size_t row) const;
+    size_t lowerBound(time_t timestamp) const;
+
+    // Columns
+    ConstSpan<float> weights() const;
+    ConstSpan<uint16_t> ages() const;
+    ConstSpan<uint8_t> activityLevels() const;
+
+    // Changes (a timestamp earlier than the previous row's is raised to it)
+    void append(const DailyMetric& metric);
+    void replaceLast(const DailyMetric& metric);
+    void clear();
+
+    // Persistence
+    bool load(const string& path);
+    void save(const string& path);
+    bool isDirty() const;
+
+    // The JSON array of earlier user.json files
+    json toJson() const;
+    void fromJson(const json& metrics);
+
+private:
+    // Timestamp of the first row of every block, and of every row relative to it
+    vector<int64_t> blockBases;
+    vector<uint32_t> offsets;
+    vector<float> weightColumn;
+    vector<uint16_t> ageColumn;
+    vector<uint8_t> activityColumn;
+
+    // Rows in the file last saved to or loaded from, and whether the last of them changed since
+    string savedPath;
+    size_t savedRows;
+    bool lastRowChanged;
+
+    void store(size_t row, const DailyMetric& metric);
+    void rewrite(const string& path);
+};
+
+#endif // METRIC_SERIES_H
@@ -0,0 +1,403 @@
+/**
+ * @file undo_buffer.cpp
+ * @brief Bounded Undo/Redo History Implementation
+ *
+ * This file implements the UndoBuffer class defined in undo_buffer.h.
+ * Records live in a ring of fixed capacity that is allocated on first use. The
+ * first record of each command carries the GROUP_START flag, so command
+ * boundaries need no separate index; eviction always removes whole commands.
+ *
+ * Key implementations:
+ * - Recording a command, which discards the commands that could be redone
+ * - Eviction of the oldest commands, appended to the spill file if one is set
+ * - Reading spilled commands back, most recent first, once undo reaches them
+ * - Resizing, which keeps the most recent commands that fit
+ */
+
+#include "undo_buffer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * writeRecords Function
+ * @param fd The spill file
+ * @param path The path of the spill file, for error messages
+ * @param records The records to write
+ * @param count The number of records
+ * @param offset The position in the file, in records
+ */
+void writeRecords(int fd, const std::string& path, const UndoRecord* records, size_t count, uint64_t offset) {
+    const char* data = reinterpret_cast<const char*>(records);
+    size_t remaining = count * sizeof(UndoRecord);
+    off_t position = static_cast<off_t>(offset * sizeof(UndoRecord));
+    while (remaining > 0) {
+        ssize_t written = ::pwrite(fd, data, remaining, position);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write undo spill file " + path + ": " + std::strerror(errno));
+        }
+        data += written;
+        position += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * readRecords Function
+ * @param fd The spill file
+ * @param path The path of the spill file, for error messages
+ * @param records Receives the records read
+ * @param count The number of records
+ * @param offset The position in the file, in records
+ */
+void readRecords(int fd, const std::string& path, UndoRecord* records, size_t count, uint64_t offset) {
+    char* data = reinterpret_cast<char*>(records);
+    size_t remaining = count * sizeof(UndoRecord);
+    off_t position = static_cast<off_t>(offset * sizeof(UndoRecord));
+    while (remaining > 0) {
+        ssize_t read = ::pread(fd, data, remaining, position);
+        if (read <= 0) {
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to read undo spill file " + path + ": " +
+                                     (read < 0 ? std::strerror(errno) : "unexpected end of file"));
+        }
+        data += read;
+        position += read;
+        remaining -= static_cast<size_t>(read);
+    }
+}
+
+} // namespace
+
+static_assert(sizeof(UndoRecord) == 16, "UndoRecord must stay a compact 16-byte record");
+
+/**
+ * UndoBuffer Constructor
+ * @param capacity The maximum number of records kept in memory
+ */
+UndoBuffer::UndoBuffer(size_t capacity)
+    : capacity(capacity), head(0), count(0), cursor(0), spillFd(-1), spillRecords(0) {
+}
+
+/**
+ * UndoBuffer Destructor
+ * Removes the spill file.
+ */
+UndoBuffer::~UndoBuffer() {
+    closeSpill();
+}
+
+/**
+ * setCapacity Method
+ * @param records The maximum number of records kept in memory (0 disables undo)
+ * Commands that no longer fit are evicted oldest first; if only commands that
+ * could be redone are left, the most recent of them are dropped instead.
+ */
+void UndoBuffer::setCapacity(size_t records) {
+    if (records == capacity) {
+        return;
+    }
+    linearize(count);
+    while (count > records) {
+        if (cursor > 0) {
+            evictOldest();
+        } else {
+            dropNewest();
+        }
+    }
+    capacity = records;
+    linearize(count > 0 ? capacity : 0);
+}
+
+/**
+ * getCapacity Method
+ * @return The maximum number of records kept in memory
+ */
+size_t UndoBuffer::getCapacity() const {
+    return capacity;
+}
+
+/**
+ * setSpillPath Method
+ * @param path The file receiving evicted commands, or an empty string to discard them
+ * Commands spilled to a previous path are discarded.
+ */
+void UndoBuffer::setSpillPath(const std::string& path) {
+    if (path == spillPath) {
+        return;
+    }
+    closeSpill();
+    spillPath = path;
+}
+
+/**
+ * getSpillPath Method
+ * @return The file receiving evicted commands, empty if spilling is disabled
+ */
+const std::string& UndoBuffer::getSpillPath() const {
+    return spillPath;
+}
+
+/**
+ * push Method
+ * @param group The records of an executed command, in execution order
+ * @return False if the command is larger than the capacity; the whole history
+ *         is cleared then, since older commands can no longer be undone past it
+ */
+bool UndoBuffer::push(ConstSpan<UndoRecord> group) {
+    if (group.empty()) {
+        return true;
+    }
+    count = cursor;
+    if (group.size() > capacity) {
+        clear();
+        return false;
+    }
+    if (ring.size() != capacity) {
+        linearize(capacity);
+    }
+    while (capacity - count < group.size()) {
+        evictOldest();
+    }
+    for (size_t i = 0; i < group.size(); i++) {
+        UndoRecord& record = at(count + i);
+        record = group[i];
+        record.flags = i == 0 ? UndoRecord::GROUP_START : 0;
+    }
+    count += group.size();
+    cursor = count;
+    return true;
+}
+
+/**
+ * canUndo Method
+ * @return Whether a command can be undone
+ */
+bool UndoBuffer::canUndo() const {
+    return cursor > 0 || !spillGroups.empty();
+}
+
+/**
+ * canRedo Method
+ * @return Whether a command can be redone
+ */
+bool UndoBuffer::canRedo() const {
+    return cursor < count;
+}
+
+/**
+ * undo Method
+ * @param group Receives the records of the last done command, in execution order
+ * @return False if there is no command to undo
+ */
+bool UndoBuffer::undo(std::vector<UndoRecord>& group) {
+    if (cursor == 0 && !refill()) {
+        return false;
+    }
+    size_t start = cursor - 1;
+    while (start > 0 && !(at(start).flags & UndoRecord::GROUP_START)) {
+        start--;
+    }
+    group.clear();
+    for (size_t i = start; i < cursor; i++) {
+        group.push_back(at(i));
+    }
+    cursor = start;
+    return true;
+}
+
+/**
+ * redo Method
+ * @param group Receives the records of the next undone command, in execution order
+ * @return False if there is no command to redo
+ */
+bool UndoBuffer::redo(std::vector<UndoRecord>& group) {
+    if (cursor == count) {
+        return false;
+    }
+    size_t end = cursor + 1;
+    while (end < count && !(at(end).flags & UndoRecord::GROUP_START)) {
+        end++;
+    }
+    group.clear();
+    for (size_t i = cursor; i < end; i++) {
+        group.push_back(at(i));
+    }
+    cursor = end;
+    return true;
+}
+
+/**
+ * clear Method
+ * Removes all commands, including spilled ones.
+ */
+void UndoBuffer::clear() {
+    head = 0;
+    count = 0;
+    cursor = 0;
+    closeSpill();
+}
+
+/**
+ * size Method
+ * @return The number of records held in memory
+ */
+size_t UndoBuffer::size() const {
+    return count;
+}
+
+/**
+ * spilledCommands Method
+ * @return The number of commands in the spill file
+ */
+size_t UndoBuffer::spilledCommands() const {
+    return spillGroups.size();
+}
+
+/**
+ * at Method
+ * @param index A position counted from the oldest record in memory
+ * @return The record at the position
+ */
+UndoRecord& UndoBuffer::at(size_t index) {
+    return ring[(head + index) % ring.size()];
+}
+
+/**
+ * at Method
+ * @param index A position counted from the oldest record in memory
+ * @return The record at the position
+ */
+const UndoRecord& UndoBuffer::at(size_t index) const {
+    return ring[(head + index) % ring.size()];
+}
+
+/**
+ * groupLength Method
+ * @param first The position of the first record of a command
+ * @return The number of records of the command
+ */
+size_t UndoBuffer::groupLength(size_t first) const {
+    size_t end = first + 1;
+    while (end < count && !(at(end).flags & UndoRecord::GROUP_START)) {
+        end++;
+    }
+    return end - first;
+}
+
+/**
+ * linearize Method
+ * @param ringSize The new size of the ring, at least the number of records held
+ * Moves the records to the front of a ring of the given size.
+ */
+void UndoBuffer::linearize(size_t ringSize) {
+    std::vector<UndoRecord> linear(ringSize);
+    for (size_t i = 0; i < count; i++) {
+        linear[i] = at(i);
+    }
+    ring.swap(linear);
+    head = 0;
+}
+
+/**
+ * evictOldest Method
+ * Removes the oldest command from memory, appending it to the spill file if one is set.
+ */
+void UndoBuffer::evictOldest() {
+    size_t length = groupLength(0);
+    if (!spillPath.empty()) {
+        if (spillFd < 0) {
+            spillFd = ::open(spillPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (spillFd < 0) {
+                throw std::runtime_error("Failed to open undo spill file " + spillPath + ": " + std::strerror(errno));
+            }
+        }
+        // The command may wrap around the end of the ring
+        size_t contiguous = std::min(length, ring.size() - head);
+        writeRecords(spillFd, spillPath, &ring[head], contiguous, spillRecords);
+        writeRecords(spillFd, spillPath, ring.data(), length - contiguous, spillRecords + contiguous);
+        spillGroups.push_back(spillRecords);
+        spillRecords += length;
+    }
+    head = (head + length) % ring.size();
+    count -= length;
+    cursor -= length;
+}
+
+/**
+ * dropNewest Method
+ * Discards the most recent command, which must be one that could be redone.
+ */
+void UndoBuffer::dropNewest() {
+    size_t start = count - 1;
+    while (start > 0 && !(at(start).flags & UndoRecord::GROUP_START)) {
+        start--;
+    }
+    count = start;
+    cursor = std::min(cursor, count);
+}
+
+/**
+ * refill Method
+ * @return True if the most recent spilled command was read back into memory
+ * Called once every command in memory has been undone. Commands that could be
+ * redone are dropped, most recent first, to make room.
+ */
+bool UndoBuffer::refill() {
+    if (spillGroups.empty()) {
+        return false;
+    }
+    uint64_t first = spillGroups.back();
+    size_t length = static_cast<size_t>(spillRecords - first);
+    if (length > capacity) {
+        // Spilled before the capacity was reduced; it cannot be undone any more
+        closeSpill();
+        return false;
+    }
+    if (ring.size() != capacity) {
+        linearize(capacity);
+    }
+    while (capacity - count < length) {
+        dropNewest();
+    }
+
+    std::vector<UndoRecord> records(length);
+    readRecords(spillFd, spillPath, records.data(), length, first);
+    if (::ftruncate(spillFd, static_cast<off_t>(first * sizeof(UndoRecord))) != 0) {
+        throw std::runtime_error("Failed to truncate undo spill file " + spillPath + ": " + std::strerror(errno));
+    }
+    spillGroups.pop_back();
+    spillRecords = first;
+
+    head = (head + ring.size() - length) % ring.size();
+    for (size_t i = 0; i < length; i++) {
+        at(i) = records[i];
+    }
+    count += length;
+    cursor = length;
+    return true;
+}
+
+/**
+ * closeSpill Method
+ * Closes and removes the spill file, discarding the commands in it.
+ */
+void UndoBuffer::closeSpill() {
+    if (spillFd >= 0) {
+        ::close(spillFd);
+        ::unlink(spillPath.c_str());
+        spillFd = -1;
+    }
+    spillGroups.clear();
+    spillRecords = 0;
+}
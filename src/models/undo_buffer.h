@@ -0,0 +1,98 @@
+/**
+ * @file undo_buffer.h
+ * @brief Bounded Undo/Redo History of Log Changes
+ *
+ * This file defines the UndoRecord struct and the UndoBuffer class which
+ * LogHistory uses for undo and redo. Every log command is stored as a group of
+ * fixed-size records in a ring buffer of configurable capacity, so the history
+ * takes bounded memory and recording a command allocates nothing.
+ *
+ * Key features:
+ * - 16-byte POD records: op code, food handle, date and servings delta
+ * - Commands of any number of records (a batch is one group)
+ * - Eviction of the oldest commands once the capacity is reached
+ * - Optional spill file receiving evicted commands, from which undo reads them back
+ */
+
+#ifndef UNDO_BUFFER_H
+#define UNDO_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../utils/const_span.h"
+
+using namespace std;
+
+/**
+ * UndoRecord struct
+ * One servings change of a log command
+ */
+struct UndoRecord {
+    enum Op : uint8_t { ADD, REMOVE };
+    static const uint8_t GROUP_START = 1;
+
+    uint8_t op;
+    uint8_t flags;    // GROUP_START on the first record of a command
+    uint16_t unused;
+    uint32_t food;    // Handle of the food ID (see FoodIds)
+    int32_t day;      // Date as days since 1970-01-01
+    float delta;      // Servings added by the change (negative for REMOVE)
+};
+
+/**
+ * UndoBuffer Class
+ * This class keeps the most recent commands in a ring buffer of records.
+ */
+class UndoBuffer {
+public:
+    static const size_t DEFAULT_CAPACITY = 65536;
+
+    explicit UndoBuffer(size_t capacity = DEFAULT_CAPACITY);
+    ~UndoBuffer();
+    UndoBuffer(const UndoBuffer&) = delete;
+    UndoBuffer& operator=(const UndoBuffer&) = delete;
+
+    // Configuration (capacity in records; an empty spill path disables spilling)
+    void setCapacity(size_t records);
+    size_t getCapacity() const;
+    void setSpillPath(const string& path);
+    const string& getSpillPath() const;
+
+    // Recording and traversal (groups are returned in execution order)
+    bool push(ConstSpan<UndoRecord> group);
+    bool canUndo() const;
+    bool canRedo() const;
+    bool undo(vector<UndoRecord>& group);
+    bool redo(vector<UndoRecord>& group);
+    void clear();
+
+    // Records held in memory and commands spilled to disk
+    size_t size() const;
+    size_t spilledCommands() const;
+
+private:
+    // Ring of records: count records from head, of which the first cursor are done
+    vector<UndoRecord> ring;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t cursor;
+
+    // Spill file of evicted commands; spillGroups holds the record offset of each
+    string spillPath;
+    int spillFd;
+    vector<uint64_t> spillGroups;
+    uint64_t spillRecords;
+
+    UndoRecord& at(size_t index);
+    const UndoRecord& at(size_t index) const;
+    size_t groupLength(size_t first) const;
+    void linearize(size_t ringSize);
+    void evictOldest();
+    void dropNewest();
+    bool refill();
+    void closeSpill();
+};
+
+#endif // UNDO_BUFFER_H
@@ -10,6 +10,7 @@
  * - Multiple BMR calculation methods (Harris-Benedict, Mifflin-St Jeor, WHO Equation)
  * - Daily calorie needs based on activity level and goals
  * - Tracking of user metrics over time in daily records
+ * - BMR and target calorie series computed over whole columns of the history
  * - JSON serialization and deserialization
  * - Utility methods for date formatting and string conversions
  * 
@@ -18,6 +19,8 @@
  */
 
 #include "user.h"
+#include "calorie_batch.h"
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -138,7 +141,9 @@ void User::setAge(int age) {
     // Update member variable and ensure today's daily record exists with updated value
     this->age = age;
     ensureDailyRecordExists();
-    dailyMetrics.back().age = age;
+    DailyMetric metric = dailyMetrics.back();
+    metric.age = age;
+    dailyMetrics.replaceLast(metric);
 }
 
 /**
@@ -165,7 +170,9 @@ void User::setWeight(float weight) {
     // Update member variable and ensure today's daily record exists with updated value
     this->weight = weight;
     ensureDailyRecordExists();
-    dailyMetrics.back().weight = weight;
+    DailyMetric metric = dailyMetrics.back();
+    metric.weight = weight;
+    dailyMetrics.replaceLast(metric);
 }
 
 /**
@@ -176,7 +183,9 @@ void User::setActivityLevel(ActivityLevel activity) {
     // Update member variable and ensure today's daily record exists with updated value
     this->activityLevel = activity;
     ensureDailyRecordExists();
-    dailyMetrics.back().activityLevel = static_cast<int>(activity);
+    DailyMetric metric = dailyMetrics.back();
+    metric.activityLevel = static_cast<int>(activity);
+    dailyMetrics.replaceLast(metric);
 }
 
 /**
@@ -343,7 +352,8 @@ float User::calculateTargetCalories() const {
 /**
  * toJson Method
  * @return A JSON object representing the user
- * This method serializes the User object to JSON.
+ * This method serializes the User object to JSON. The daily metrics are stored
+ * separately (see saveDailyMetrics), so this stays small however long the history is.
  */
 json User::toJson() const {
     json j;
@@ -357,13 +367,6 @@ json User::toJson() const {
     j["calorieCalcMethod"] = static_cast<int>(calorieCalcMethod);
     j["lastUpdateTime"] = lastUpdateTime;
     
-    // Serialize daily metrics
-    json metricsArray = json::array();
-    for (const auto& metric : dailyMetrics) {
-        metricsArray.push_back(metric.toJson());
-    }
-    j["dailyMetrics"] = metricsArray;
-    
     return j;
 }
 
@@ -389,11 +392,9 @@ User User::fromJson(const json& j) {
         user.lastUpdateTime = j["lastUpdateTime"];
     }
     
-    // Load daily metrics if they exist
+    // Load daily metrics if they exist (earlier versions kept them in user.json)
     if (j.contains("dailyMetrics") && j["dailyMetrics"].is_array()) {
-        for (const auto& metricJson : j["dailyMetrics"]) {
-            user.dailyMetrics.push_back(DailyMetric::fromJson(metricJson));
-        }
+        user.dailyMetrics.fromJson(j["dailyMetrics"]);
     }
     
     return user;
@@ -558,14 +559,14 @@ void User::updateDailyRecord() {
         
         if (currentDay == lastRecordDay) {
             // Update existing record for today
-            dailyMetrics.back() = metric;
+            dailyMetrics.replaceLast(metric);
         } else {
             // Add new record for today
-            dailyMetrics.push_back(metric);
+            dailyMetrics.append(metric);
         }
     } else {
         // First record
-        dailyMetrics.push_back(metric);
+        dailyMetrics.append(metric);
     }
     
     lastUpdateTime = now;
@@ -573,12 +574,91 @@ void User::updateDailyRecord() {
 
 /**
  * getDailyMetrics Method
- * @return The vector of daily metrics
+ * @return The daily metrics, one row per day
  */
-const vector<DailyMetric>& User::getDailyMetrics() const {
+const MetricSeries& User::getDailyMetrics() const {
     return dailyMetrics;
 }
 
+/**
+ * getCalorieSeries Method
+ * @param begin The first row of the daily metrics
+ * @param end The row after the last one (clamped to the number of rows)
+ * @return The BMR and target calories of every row in the range
+ * Each row uses its own weight, age and activity level, and the user's current
+ * height, gender, goal and calculation method. The rows are evaluated by
+ * CalorieBatch::evaluate with the user's fields as single-value columns, which
+ * gives the same results as calculateBMR and calculateTargetCalories.
+ */
+CalorieSeries User::getCalorieSeries(size_t begin, size_t end) const {
+    end = min(end, dailyMetrics.size());
+    begin = min(begin, end);
+    size_t count = end - begin;
+    
+    CalorieSeries series;
+    series.timestamps.resize(count);
+    series.bmr.resize(count);
+    series.targetCalories.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        series.timestamps[i] = dailyMetrics.timestampAt(begin + i);
+    }
+    if (count == 0) {
+        return series;
+    }
+    
+    float userHeight = height;
+    uint8_t userGender = static_cast<uint8_t>(gender);
+    uint8_t userGoal = static_cast<uint8_t>(goal);
+    
+    CalorieBatchInput input;
+    input.weights = {dailyMetrics.weights().begin() + begin, dailyMetrics.weights().begin() + end};
+    input.heights = {&userHeight, &userHeight + 1};
+    input.ages = {dailyMetrics.ages().begin() + begin, dailyMetrics.ages().begin() + end};
+    input.genders = {&userGender, &userGender + 1};
+    input.activityLevels = {dailyMetrics.activityLevels().begin() + begin, dailyMetrics.activityLevels().begin() + end};
+    input.goals = {&userGoal, &userGoal + 1};
+    CalorieBatch::evaluate(calorieCalcMethod, input, series.bmr.data(), series.targetCalories.data());
+    return series;
+}
+
+/**
+ * getCalorieSeriesBetween Method
+ * @param from The earliest timestamp of the range
+ * @param to The latest timestamp of the range
+ * @return The BMR and target calories of every row recorded in the range
+ */
+CalorieSeries User::getCalorieSeriesBetween(time_t from, time_t to) const {
+    if (to < from) {
+        return {};
+    }
+    return getCalorieSeries(dailyMetrics.lowerBound(from), dailyMetrics.lowerBound(to + 1));
+}
+
+/**
+ * loadDailyMetrics Method
+ * @param path A metrics file
+ * @return False if the file does not exist, in which case the history is unchanged
+ */
+bool User::loadDailyMetrics(const string& path) {
+    return dailyMetrics.load(path);
+}
+
+/**
+ * saveDailyMetrics Method
+ * @param path The metrics file, to which only the rows changed since the last save are written
+ */
+void User::saveDailyMetrics(const string& path) {
+    dailyMetrics.save(path);
+}
+
+/**
+ * hasUnsavedDailyMetrics Method
+ * @return Whether daily metrics changed since they were last saved or loaded
+ */
+bool User::hasUnsavedDailyMetrics() const {
+    return dailyMetrics.isDirty();
+}
+
 /**
  * getFormattedDate Method
  * @param timestamp The timestamp to format
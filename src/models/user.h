@@ -3,14 +3,15 @@
  * @brief User Model Definitions
  * 
  * This file defines the User class which represents a user of the diet manager application
- * and stores their personal information and preferences. It also includes the DailyMetric
- * struct for tracking changes in user metrics over time.
+ * and stores their personal information and preferences. Changes in user metrics
+ * over time are tracked in a MetricSeries, one DailyMetric row per day.
  * 
  * Key components:
  * - User class with personal attributes (name, age, gender, height, weight)
  * - Activity levels, goals, and calorie calculation method preferences
  * - BMI and calorie requirement calculation functions using multiple formulas
- * - Daily metrics history for tracking changes over time
+ * - Daily metrics history for tracking changes over time, stored in columns
+ * - BMR and target calorie series over ranges of the history
  * - Serialization and deserialization to/from JSON
  * 
  * The User class encapsulates all user-specific data and calculation methods,
@@ -25,6 +26,7 @@
 #include <map>
 #include <chrono>
 #include <nlohmann/json.hpp>
+#include "metric_series.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -33,32 +35,13 @@ using namespace std;
 const unsigned int DAY_LENGTH = 10; // 24 hours = 86400 seconds
 
 /**
- * DailyMetric struct
- * Represents a daily record of user metrics
+ * CalorieSeries struct
+ * BMR and target calories over a range of daily metrics, one entry per row
  */
-struct DailyMetric {
-    time_t timestamp;
-    float weight;
-    int age;
-    int activityLevel; // Stored as an integer equivalent of ActivityLevel enum
-    
-    json toJson() const {
-        json j;
-        j["timestamp"] = timestamp;
-        j["weight"] = weight;
-        j["age"] = age;
-        j["activityLevel"] = activityLevel;
-        return j;
-    }
-    
-    static DailyMetric fromJson(const json& j) {
-        DailyMetric metric;
-        metric.timestamp = j.value("timestamp", time(nullptr));
-        metric.weight = j.value("weight", 0.0f);
-        metric.age = j.value("age", 0);
-        metric.activityLevel = j.value("activityLevel", 2); // Default to MODERATE
-        return metric;
-    }
+struct CalorieSeries {
+    vector<time_t> timestamps;
+    vector<float> bmr;
+    vector<float> targetCalories;
 };
 
 /**
@@ -103,7 +86,14 @@ public:
     void ensureDailyRecordExists();
     time_t getLastUpdateTime() const;
     void updateDailyRecord();
-    const vector<DailyMetric>& getDailyMetrics() const;
+    const MetricSeries& getDailyMetrics() const;
+    CalorieSeries getCalorieSeries(size_t begin, size_t end) const;
+    CalorieSeries getCalorieSeriesBetween(time_t from, time_t to) const;
+    
+    // Daily metrics persistence (the history is not part of toJson)
+    bool loadDailyMetrics(const string& path);
+    void saveDailyMetrics(const string& path);
+    bool hasUnsavedDailyMetrics() const;
     string getFormattedDate(time_t timestamp) const;
     time_t getCurrentDay() const;
     
@@ -140,7 +130,7 @@ private:
     CalorieCalculationMethod calorieCalcMethod;
     
     // Time-series data for daily metrics
-    vector<DailyMetric> dailyMetrics;
+    MetricSeries dailyMetrics;
     time_t lastUpdateTime;
     
     float getActivityMultiplier() const;
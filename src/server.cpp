@@ -0,0 +1,611 @@
+/**
+ * @file server.cpp
+ * @brief Request Server Implementation
+ *
+ * This file implements the Server class defined in server.h.
+ * The event loop runs on the calling thread and never executes requests: it reads
+ * request lines, hands them to the worker pool and writes the responses back.
+ * Workers signal finished responses through an eventfd. Each connection has at
+ * most one request in flight, so its responses keep the order of its requests.
+ *
+ * Key implementations:
+ * - Unix and TCP listeners with non-blocking sockets
+ * - Level-triggered epoll handling of reads, writes and wake-ups
+ * - SIGINT/SIGTERM handling through a signalfd for an orderly shutdown
+ * - Request parsing, endpoint dispatch and latency recording
+ */
+
+#include "server.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// epoll identifiers of the server's own descriptors; connections use larger ones
+const uint64_t LISTEN_ID = 0;
+const uint64_t WAKE_ID = 1;
+const uint64_t SIGNAL_ID = 2;
+const uint64_t FIRST_CONNECTION_ID = 3;
+
+// Requests longer than this close the connection
+const size_t MAX_REQUEST_SIZE = 1 << 20;
+
+/**
+ * systemError Function
+ * @param what The failed operation
+ * @return An exception describing the operation and errno
+ */
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/**
+ * setNonBlocking Function
+ * @param fd A descriptor to switch to non-blocking mode
+ */
+void setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw systemError("Failed to make socket non-blocking");
+    }
+}
+
+/**
+ * foodJson Function
+ * @param food A food
+ * @return The food as JSON, with the components of composite foods
+ */
+json foodJson(const Food& food) {
+    json j = {{"id", food.getId()},
+              {"calories", food.getCaloriesPerServing()},
+              {"composite", food.isComposite()},
+              {"keywords", food.getKeywords()}};
+    if (const auto* composite = dynamic_cast<const CompositeFood*>(&food)) {
+        j["components"] = composite->getComponents();
+    }
+    return j;
+}
+
+} // namespace
+
+/**
+ * Server Constructor
+ * @param cli The CLI holding the loaded data and the commands
+ * @param address The address to listen on
+ * @param workerCount The number of threads executing requests
+ */
+Server::Server(CLI& cli, const std::string& address, size_t workerCount)
+    : cli(cli), address(address), workerCount(workerCount == 0 ? 1 : workerCount),
+      listenFd(-1), epollFd(-1), wakeFd(-1), signalFd(-1), stopping(false),
+      nextConnectionId(FIRST_CONNECTION_ID) {
+    for (const auto& name : cli.getCommandNames()) {
+        latencies[name] = std::make_unique<LatencyHistogram>();
+    }
+    for (const char* name : {"get-food", "server-stats", "unknown", "invalid"}) {
+        latencies[name] = std::make_unique<LatencyHistogram>();
+    }
+}
+
+/**
+ * Server Destructor
+ * Closes all sockets and removes the Unix socket file.
+ */
+Server::~Server() {
+    workers.reset();
+    for (auto& [id, connection] : connections) {
+        ::close(connection.fd);
+    }
+    for (int fd : {listenFd, epollFd, wakeFd, signalFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (!unixPath.empty()) {
+        ::unlink(unixPath.c_str());
+    }
+}
+
+/**
+ * run Method
+ * Serves requests until stop is called or SIGINT or SIGTERM is received.
+ * @throws runtime_error if the server cannot listen on its address
+ */
+void Server::run() {
+    // Signals are handled by the loop; workers inherit the blocked mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    openListener();
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    signalFd = ::signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0 || signalFd < 0) {
+        throw systemError("Failed to set up the event loop");
+    }
+    for (auto [fd, id] : {std::make_pair(listenFd, LISTEN_ID), std::make_pair(wakeFd, WAKE_ID),
+                          std::make_pair(signalFd, SIGNAL_ID)}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw systemError("Failed to register with epoll");
+        }
+    }
+    workers = std::make_unique<ThreadPool>(workerCount);
+    std::cerr << "Serving on " << address << " with " << workerCount << " worker(s)" << std::endl;
+
+    std::vector<epoll_event> events(64);
+    while (!stopping.load()) {
+        int ready = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("epoll_wait failed");
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptConnections();
+            } else if (id == WAKE_ID) {
+                collectCompleted();
+            } else if (id == SIGNAL_ID) {
+                signalfd_siginfo info;
+                while (::read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                    stopping.store(true);
+                }
+            } else if (connections.count(id)) {
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readConnection(id);
+                }
+                if (connections.count(id) && (events[i].events & EPOLLOUT)) {
+                    writeConnection(id);
+                }
+            }
+        }
+    }
+
+    // Let requests in flight finish before the data is saved
+    workers.reset();
+    std::cerr << "Server stopped" << std::endl;
+}
+
+/**
+ * stop Method
+ * Makes run return; safe to call from any thread.
+ */
+void Server::stop() {
+    stopping.store(true);
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/**
+ * handleRequest Method
+ * @param line A request line
+ * @return The response line, including the trailing newline
+ * Thread-safe: food endpoints run concurrently, other commands one at a time.
+ */
+std::string Server::handleRequest(const std::string& line) {
+    auto start = std::chrono::steady_clock::now();
+    json response;
+    std::string endpoint = "invalid";
+
+    try {
+        std::vector<std::string> args;
+        std::string userId;
+        if (!line.empty() && line[0] == '{') {
+            json request = json::parse(line);
+            if (request.contains("id")) {
+                response["id"] = request["id"];
+            }
+            userId = request.value("user", "");
+            args.push_back(request.at("command").get<std::string>());
+            for (const auto& arg : request.value("args", json::array())) {
+                args.push_back(arg.is_string() ? arg.get<std::string>() : arg.dump());
+            }
+        } else {
+            args = CLI::parseCommandLine(line);
+        }
+        if (args.empty()) {
+            throw std::invalid_argument("Empty request");
+        }
+        endpoint = latencies.count(args[0]) ? args[0] : "unknown";
+
+        if (isFoodEndpoint(args[0])) {
+            response.update(runFoodEndpoint(args));
+            response["ok"] = true;
+        } else if (args[0] == "server-stats") {
+            response["stats"] = getStats();
+            response["ok"] = true;
+        } else if (args[0] == "quit" || args[0] == "exit" || args[0] == "clear") {
+            throw std::invalid_argument("'" + args[0] + "' is not available in server mode");
+        } else if (args[0] == "log-batch" && args.size() > 1 && args[1] == "-") {
+            // Standard input belongs to the server process, not to the client
+            throw std::invalid_argument("log-batch reads files only in server mode");
+        } else {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            response.update(cli.runCommand(args, userId));
+        }
+    } catch (const std::exception& e) {
+        response["ok"] = false;
+        response["error"] = e.what();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    latencies.at(endpoint)->record(static_cast<uint64_t>(elapsed.count()));
+    response["elapsed_us"] = static_cast<double>(elapsed.count()) / 1000.0;
+    return response.dump() + "\n";
+}
+
+/**
+ * getStats Method
+ * @return Count, mean, percentiles and maximum latency in microseconds of every
+ *         endpoint that received requests
+ */
+json Server::getStats() const {
+    json stats = json::object();
+    for (const auto& [name, histogram] : latencies) {
+        if (histogram->count() == 0) {
+            continue;
+        }
+        stats[name] = {{"count", histogram->count()},
+                       {"mean_us", histogram->mean() / 1000.0},
+                       {"p50_us", histogram->percentile(0.50) / 1000.0},
+                       {"p90_us", histogram->percentile(0.90) / 1000.0},
+                       {"p99_us", histogram->percentile(0.99) / 1000.0},
+                       {"max_us", histogram->max() / 1000.0}};
+    }
+    return stats;
+}
+
+/**
+ * isFoodEndpoint Method
+ * @param name A command name
+ * @return True for the read-only food endpoints that bypass the CLI
+ */
+bool Server::isFoodEndpoint(const std::string& name) {
+    return name == "search-foods" || name == "list-foods" || name == "get-food";
+}
+
+/**
+ * runFoodEndpoint Method
+ * @param args A food endpoint and its arguments
+ * @return The response fields: "foods" (search-foods, list-foods) or "food" (get-food);
+ *         with --limit or --offset, one page of foods plus the "total" of all pages,
+ *         and searches ranked best first with each food's "score"
+ * @throws invalid_argument if the arguments are invalid or the food does not exist
+ * The food database allows concurrent readers, so these need no command lock.
+ */
+json Server::runFoodEndpoint(const std::vector<std::string>& args) const {
+    FoodDatabase& foodDb = FoodDatabase::getInstance();
+    if (args[0] == "get-food") {
+        if (args.size() < 2) {
+            throw std::invalid_argument("Usage: get-food <food_id>");
+        }
+        auto food = foodDb.getFood(args[1]);
+        if (!food) {
+            throw std::invalid_argument("Food not found: " + args[1]);
+        }
+        return {{"food", foodJson(*food)}};
+    }
+
+    bool matchAll = true;
+    bool paged = false;
+    size_t limit = 0;
+    size_t offset = 0;
+    std::vector<std::string> keywords;
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--all") {
+            matchAll = true;
+        } else if (args[i] == "--any") {
+            matchAll = false;
+        } else if ((args[i] == "--limit" || args[i] == "--offset") && i + 1 < args.size()) {
+            (args[i] == "--limit" ? limit : offset) = CLI::parseCount(args[i], args[i + 1]);
+            paged = true;
+            i++;
+        } else {
+            keywords.push_back(args[i]);
+        }
+    }
+
+    json list = json::array();
+    if (args[0] == "list-foods") {
+        if (!paged) {
+            for (const auto& food : foodDb.getAllFoods()) {
+                list.push_back(foodJson(*food));
+            }
+            return {{"foods", list}};
+        }
+        FoodPage page = foodDb.getFoodPage(limit, offset);
+        for (const auto& ranked : page.foods) {
+            list.push_back(foodJson(*ranked.food));
+        }
+        return {{"foods", list}, {"total", page.total}};
+    }
+
+    if (keywords.empty()) {
+        throw std::invalid_argument("Usage: search-foods <keyword1> [keyword2] ... [--all|--any] [--limit N] [--offset N]");
+    }
+    if (!paged) {
+        // Without pagination, all matches in ID order
+        for (const auto& food : foodDb.searchFoods(keywords, matchAll)) {
+            list.push_back(foodJson(*food));
+        }
+        return {{"foods", list}};
+    }
+    FoodPage page = foodDb.rankFoods(keywords, matchAll, limit, offset);
+    for (const auto& ranked : page.foods) {
+        json food = foodJson(*ranked.food);
+        food["score"] = ranked.score;
+        list.push_back(food);
+    }
+    return {{"foods", list}, {"total", page.total}};
+}
+
+/**
+ * openListener Method
+ * Creates the listening socket for the configured address.
+ * @throws runtime_error if the address is invalid or cannot be bound
+ */
+void Server::openListener() {
+    bool isUnix = address.rfind("unix:", 0) == 0 || address.find('/') != std::string::npos;
+    if (isUnix) {
+        unixPath = address.rfind("unix:", 0) == 0 ? address.substr(5) : address;
+        sockaddr_un addr{};
+        if (unixPath.empty() || unixPath.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("Invalid Unix socket path: " + unixPath);
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(unixPath.c_str());
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            throw systemError("Failed to bind " + unixPath);
+        }
+    } else {
+        size_t colon = address.rfind(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("Address must be unix:<path>, <host>:<port> or :<port>");
+        }
+        std::string host = address.substr(0, colon);
+        std::string port = address.substr(colon + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* result = nullptr;
+        int status = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (status != 0) {
+            throw std::invalid_argument("Invalid address " + address + ": " + ::gai_strerror(status));
+        }
+        listenFd = ::socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol);
+        int yes = 1;
+        bool bound = listenFd >= 0 &&
+                     ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) == 0 &&
+                     ::bind(listenFd, result->ai_addr, result->ai_addrlen) == 0;
+        ::freeaddrinfo(result);
+        if (!bound) {
+            throw systemError("Failed to bind " + address);
+        }
+    }
+
+    if (::listen(listenFd, SOMAXCONN) != 0) {
+        throw systemError("Failed to listen on " + address);
+    }
+    setNonBlocking(listenFd);
+}
+
+/**
+ * acceptConnections Method
+ * Accepts all pending connections.
+ */
+void Server::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+        // Fails harmlessly on Unix sockets
+        int yes = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        uint64_t id = nextConnectionId++;
+        connections[id] = Connection{fd, "", "", {}, false, false, false};
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            closeConnection(id);
+        }
+    }
+}
+
+/**
+ * readConnection Method
+ * @param id A connection
+ * Reads available data and queues every complete request line.
+ */
+void Server::readConnection(uint64_t id) {
+    Connection& connection = connections.at(id);
+    char buffer[16384];
+    while (true) {
+        ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        // Peer closed its side (or failed); answer what was received, then close
+        connection.closing = true;
+        break;
+    }
+
+    size_t begin = 0;
+    for (size_t end; (end = connection.input.find('\n', begin)) != std::string::npos; begin = end + 1) {
+        std::string line = connection.input.substr(begin, end - begin);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            connection.pending.push_back(std::move(line));
+        }
+    }
+    connection.input.erase(0, begin);
+    if (connection.input.size() > MAX_REQUEST_SIZE) {
+        closeConnection(id);
+        return;
+    }
+
+    if (!connection.busy) {
+        dispatchNext(id);
+    }
+}
+
+/**
+ * writeConnection Method
+ * @param id A connection
+ * Sends as much buffered output as the socket accepts.
+ */
+void Server::writeConnection(uint64_t id) {
+    Connection& connection = connections.at(id);
+    while (!connection.output.empty()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            closeConnection(id);
+            return;
+        }
+        connection.output.erase(0, static_cast<size_t>(sent));
+    }
+    if (connection.closing && !connection.busy && connection.pending.empty() && connection.output.empty()) {
+        closeConnection(id);
+        return;
+    }
+    updateEvents(id);
+}
+
+/**
+ * dispatchNext Method
+ * @param id A connection without a request in flight
+ * Hands the connection's next request to the workers.
+ */
+void Server::dispatchNext(uint64_t id) {
+    Connection& connection = connections.at(id);
+    if (connection.pending.empty()) {
+        if (connection.closing && connection.output.empty()) {
+            closeConnection(id);
+        }
+        return;
+    }
+    connection.busy = true;
+    std::string line = std::move(connection.pending.front());
+    connection.pending.pop_front();
+
+    workers->submit([this, id, line = std::move(line)]() {
+        std::string response = handleRequest(line);
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.emplace_back(id, std::move(response));
+        }
+        uint64_t one = 1;
+        ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        (void)written;
+    });
+}
+
+/**
+ * collectCompleted Method
+ * Queues the responses finished by workers on their connections.
+ */
+void Server::collectCompleted() {
+    uint64_t value;
+    while (::read(wakeFd, &value, sizeof(value)) == sizeof(value)) {
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> responses;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        responses.swap(completed);
+    }
+    for (auto& [id, response] : responses) {
+        auto it = connections.find(id);
+        if (it == connections.end()) {
+            continue;
+        }
+        it->second.output += response;
+        it->second.busy = false;
+        writeConnection(id);
+        if (connections.count(id) && !connections.at(id).busy) {
+            dispatchNext(id);
+        }
+    }
+}
+
+/**
+ * closeConnection Method
+ * @param id A connection; a request still in flight is answered into the void
+ */
+void Server::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    connections.erase(it);
+}
+
+/**
+ * updateEvents Method
+ * @param id A connection
+ * Watches for writability only while output is waiting to be sent.
+ */
+void Server::updateEvents(uint64_t id) {
+    Connection& connection = connections.at(id);
+    bool writing = !connection.output.empty();
+    if (writing == connection.writing) {
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | (writing ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.u64 = id;
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.writing = writing;
+}
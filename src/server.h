@@ -0,0 +1,112 @@
+/**
+ * @file server.h
+ * @brief Request Server for the Diet Manager
+ *
+ * This file defines the Server class which keeps the application data resident
+ * and answers JSON requests over a Unix or TCP socket. Requests and responses are
+ * single lines of JSON, so clients can send any number of requests over one
+ * connection without paying process startup or data loading per request.
+ *
+ * Request:  {"id": <any>, "user": "<user_id>", "command": "<name>", "args": ["<arg>", ...]}
+ *           (a plain command line such as "search-foods apple" is accepted too;
+ *           without "user" the command acts on the default user)
+ * Response: {"id": <same>, "ok": true|false, "output": "...", "error": "...",
+ *            "elapsed_us": <server-side latency>}
+ *
+ * Key components:
+ * - epoll event loop accepting connections and reading and writing sockets
+ * - Worker pool executing requests (ThreadPool)
+ * - Concurrent read-only food endpoints returning structured JSON
+ * - Every other CLI command, executed one at a time
+ * - Per-endpoint latency histograms, reported by the "server-stats" endpoint
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "cli.h"
+#include "utils/thread_pool.h"
+#include "utils/latency_histogram.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Server Class
+ * This class serves CLI commands as JSON requests on a socket.
+ */
+class Server {
+public:
+    // address is "unix:<path>", a path containing '/', "<host>:<port>" or ":<port>"
+    Server(CLI& cli, const string& address, size_t workerCount = ThreadPool::defaultThreadCount());
+    ~Server();
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    void run();
+    void stop();
+
+    string handleRequest(const string& line);
+    json getStats() const;
+
+private:
+    // Client connection; requests of one connection are answered in order
+    struct Connection {
+        int fd;
+        string input;
+        string output;
+        deque<string> pending;
+        bool busy;
+        bool closing;
+        bool writing;
+    };
+
+    CLI& cli;
+    string address;
+    string unixPath;
+    size_t workerCount;
+
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    int signalFd;
+    atomic<bool> stopping;
+
+    unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnectionId;
+
+    // Responses finished by workers, handed to the event loop through wakeFd
+    mutex completedMutex;
+    vector<pair<uint64_t, string>> completed;
+    unique_ptr<ThreadPool> workers;
+
+    // CLI commands share state and standard output, so they run one at a time
+    mutex commandMutex;
+
+    // Latency per endpoint; the map is filled on construction and never changes
+    map<string, unique_ptr<LatencyHistogram>> latencies;
+
+    json runFoodEndpoint(const vector<string>& args) const;
+    static bool isFoodEndpoint(const string& name);
+
+    void openListener();
+    void acceptConnections();
+    void readConnection(uint64_t id);
+    void writeConnection(uint64_t id);
+    void dispatchNext(uint64_t id);
+    void collectCompleted();
+    void closeConnection(uint64_t id);
+    void updateEvents(uint64_t id);
+};
+
+#endif // SERVER_H
@@ -0,0 +1,125 @@
+/**
+ * @file allocation_hooks.cpp
+ * @brief Counting Allocator for the Metrics Registry
+ *
+ * This file replaces the global allocation functions with versions that count
+ * calls per thread before forwarding to malloc, and installs the counter in the
+ * Metrics registry. It is linked into the application only when the build option
+ * DIET_MANAGER_COUNT_ALLOCATIONS is on, since counting costs a little on every
+ * allocation; the benchmarks count allocations with their own replacement.
+ */
+
+#include "metrics.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local std::size_t threadAllocations = 0;
+
+/**
+ * countAllocations Function
+ * @return The allocations made so far by the calling thread
+ */
+std::size_t countAllocations() {
+    return threadAllocations;
+}
+
+const bool installed = (Metrics::setAllocationCounter(&countAllocations), true);
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    threadAllocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Over-aligned allocations, which memory resources request for every block
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    threadAllocations++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc needs a size that is a multiple of the alignment
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+// Non-throwing forms, such as the temporary buffers of std::stable_sort
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    threadAllocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    threadAllocations++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, alignment, tag);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
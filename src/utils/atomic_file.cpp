@@ -0,0 +1,58 @@
+/**
+ * @file atomic_file.cpp
+ * @brief Crash-Safe File Replacement Implementation
+ *
+ * This file implements the AtomicFile utilities declared in atomic_file.h.
+ * The temporary file is flushed and synced before the rename, so that the rename
+ * never publishes a file whose data is still only in the page cache.
+ */
+
+#include "atomic_file.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace AtomicFile {
+    /**
+     * write Function
+     * @param path The file to replace
+     * @param writer The callback writing the new contents
+     * @throws runtime_error if the file cannot be written; the old file is left untouched
+     */
+    void write(const std::string& path, const std::function<void(std::ostream&)>& writer) {
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open file for writing: " + tempPath);
+            }
+            writer(out);
+            out.flush();
+            if (!out) {
+                std::remove(tempPath.c_str());
+                throw std::runtime_error("Failed to write file: " + tempPath);
+            }
+        }
+
+        int fd = ::open(tempPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0 || ::fsync(fd) != 0) {
+            std::string reason = std::strerror(errno);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            std::remove(tempPath.c_str());
+            throw std::runtime_error("Failed to sync " + tempPath + ": " + reason);
+        }
+        ::close(fd);
+
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::string reason = std::strerror(errno);
+            std::remove(tempPath.c_str());
+            throw std::runtime_error("Failed to replace " + path + ": " + reason);
+        }
+    }
+}
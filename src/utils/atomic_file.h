@@ -0,0 +1,28 @@
+/**
+ * @file atomic_file.h
+ * @brief Crash-Safe File Replacement
+ *
+ * This file declares a utility for rewriting data files so that readers (and the
+ * next startup after a crash) see either the complete old contents or the complete
+ * new contents, never a partially written file.
+ *
+ * Key components:
+ * - Writing to a temporary file next to the target
+ * - Syncing the temporary file before it is renamed over the target
+ */
+
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <string>
+#include <ostream>
+#include <functional>
+
+using namespace std;
+
+namespace AtomicFile {
+    // Writes the file through writer into "<path>.tmp" and renames it over path
+    void write(const string& path, const function<void(ostream&)>& writer);
+}
+
+#endif // ATOMIC_FILE_H
@@ -0,0 +1,189 @@
+/**
+ * @file background_saver.cpp
+ * @brief Background Persistence Thread Implementation
+ *
+ * This file implements the BackgroundSaver class defined in background_saver.h.
+ * The worker waits on a condition variable for jobs, or until the periodic task
+ * is due. Jobs run without the lock held, so submitting never waits for a save.
+ *
+ * Key implementations:
+ * - FIFO job queue with a flush barrier
+ * - Collection of job errors for the submitting thread
+ * - Scheduling of the periodic task
+ */
+
+#include "background_saver.h"
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * BackgroundSaver Constructor
+ * Starts the worker thread.
+ */
+BackgroundSaver::BackgroundSaver()
+    : running(false), stopping(false), interval(0), completed(0), failed(0), lastMilliseconds(0), periodicRuns(0) {
+    worker = std::thread(&BackgroundSaver::workerLoop, this);
+}
+
+/**
+ * BackgroundSaver Destructor
+ * Runs the jobs still queued and joins the worker. Their errors are lost; call
+ * flush first to receive them.
+ */
+BackgroundSaver::~BackgroundSaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+/**
+ * submit Method
+ * @param job The job to run after the jobs submitted before it
+ */
+void BackgroundSaver::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_all();
+}
+
+/**
+ * flush Method
+ * Waits until every submitted job has finished.
+ * @throws runtime_error with the first error of the jobs since the last flush or check
+ */
+void BackgroundSaver::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return jobs.empty() && !running; });
+    }
+    checkErrors();
+}
+
+/**
+ * checkErrors Method
+ * Reports failed jobs without waiting for the running ones.
+ * @throws runtime_error with the first error of the jobs since the last flush or check
+ */
+void BackgroundSaver::checkErrors() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error.empty()) {
+        std::string first = std::move(error);
+        error.clear();
+        throw std::runtime_error(first);
+    }
+}
+
+/**
+ * isIdle Method
+ * @return Whether no job is queued or running
+ */
+bool BackgroundSaver::isIdle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.empty() && !running;
+}
+
+/**
+ * setPeriodicTask Method
+ * @param task The task to run on the worker every interval
+ * @param interval The time between runs; zero turns the task off
+ */
+void BackgroundSaver::setPeriodicTask(std::function<void()> task, std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        periodicTask = interval.count() > 0 ? std::move(task) : nullptr;
+        this->interval = periodicTask ? interval : std::chrono::milliseconds(0);
+        nextRun = std::chrono::steady_clock::now() + this->interval;
+    }
+    wake.notify_all();
+}
+
+/**
+ * getInterval Method
+ * @return The time between runs of the periodic task, or zero if there is none
+ */
+std::chrono::milliseconds BackgroundSaver::getInterval() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return interval;
+}
+
+/**
+ * getStats Method
+ * @return The saver counters
+ */
+BackgroundSaverStats BackgroundSaver::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {jobs.size() + (running ? 1 : 0), completed, failed, lastMilliseconds, periodicRuns};
+}
+
+/**
+ * workerLoop Method
+ * Runs queued jobs, and the periodic task when it is due, until the saver is
+ * stopping and the queue is empty.
+ */
+void BackgroundSaver::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        if (!jobs.empty()) {
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            runLocked(job, lock, false);
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        if (!periodicTask) {
+            wake.wait(lock);
+        } else if (std::chrono::steady_clock::now() < nextRun) {
+            wake.wait_until(lock, nextRun);
+        } else {
+            std::function<void()> task = periodicTask;
+            runLocked(task, lock, true);
+            nextRun = std::chrono::steady_clock::now() + interval;
+        }
+    }
+}
+
+/**
+ * runLocked Method
+ * @param task The job or periodic task to run
+ * @param lock The held lock, released while the task runs
+ * @param periodic Whether the task is the periodic task
+ */
+void BackgroundSaver::runLocked(const std::function<void()>& task, std::unique_lock<std::mutex>& lock, bool periodic) {
+    running = true;
+    lock.unlock();
+    
+    std::string message;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        task();
+    } catch (const std::exception& e) {
+        message = e.what();
+    } catch (...) {
+        message = "Unknown error";
+    }
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    lock.lock();
+    running = false;
+    if (periodic) {
+        periodicRuns++;
+    } else {
+        completed++;
+        lastMilliseconds = milliseconds;
+    }
+    if (!message.empty()) {
+        failed++;
+        if (error.empty()) {
+            error = message;
+        }
+    }
+    finished.notify_all();
+}
@@ -0,0 +1,91 @@
+/**
+ * @file background_saver.h
+ * @brief Background Persistence Thread
+ *
+ * This file defines the BackgroundSaver class which runs save jobs on a thread of
+ * its own, so that commands do not wait for files to be serialized, written and
+ * synced. The jobs work on copies of the data taken by the thread that submits
+ * them (see FoodDatabase::prepareSave and LogHistory::prepareSave).
+ *
+ * Key features:
+ * - One worker running jobs one at a time in submission order
+ * - A flush barrier waiting for every submitted job, e.g. before exiting
+ * - Errors of failed jobs kept and reported by the next flush or check
+ * - An optional periodic task, such as syncing a journal, run between jobs
+ */
+
+#ifndef BACKGROUND_SAVER_H
+#define BACKGROUND_SAVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/**
+ * BackgroundSaverStats struct
+ * Counters of the background saver
+ */
+struct BackgroundSaverStats {
+    size_t pending;          // Submitted jobs not finished yet
+    uint64_t completed;
+    uint64_t failed;
+    double lastMilliseconds; // Duration of the last job
+    uint64_t periodicRuns;
+};
+
+/**
+ * BackgroundSaver Class
+ * This class runs save jobs on a background thread.
+ */
+class BackgroundSaver {
+public:
+    BackgroundSaver();
+    ~BackgroundSaver();
+    BackgroundSaver(const BackgroundSaver&) = delete;
+    BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+
+    // Jobs
+    void submit(function<void()> job);
+    void flush();
+    void checkErrors();
+    bool isIdle() const;
+
+    // Periodic task; a zero interval turns it off
+    void setPeriodicTask(function<void()> task, chrono::milliseconds interval);
+    chrono::milliseconds getInterval() const;
+
+    BackgroundSaverStats getStats() const;
+
+private:
+    thread worker;
+    deque<function<void()>> jobs;
+    mutable std::mutex mutex;
+    condition_variable wake;
+    condition_variable finished;
+    bool running;
+    bool stopping;
+
+    function<void()> periodicTask;
+    chrono::milliseconds interval;
+    chrono::steady_clock::time_point nextRun;
+
+    // First error since the last flush or check
+    string error;
+    uint64_t completed;
+    uint64_t failed;
+    double lastMilliseconds;
+    uint64_t periodicRuns;
+
+    void workerLoop();
+    void runLocked(const function<void()>& task, unique_lock<std::mutex>& lock, bool periodic);
+};
+
+#endif // BACKGROUND_SAVER_H
@@ -0,0 +1,87 @@
+/**
+ * @file bounded_queue.h
+ * @brief Blocking Queue with a Fixed Capacity
+ *
+ * This file defines the BoundedQueue template used to connect the stages of
+ * multi-threaded pipelines. Producers block while the queue is full, which
+ * limits the amount of buffered work and slows fast stages down to the pace of
+ * the slowest one (backpressure).
+ *
+ * Key features:
+ * - Blocking push and pop guarded by a mutex and two condition variables
+ * - Close operation that wakes all waiters once no more items will arrive
+ * - Move-only item support
+ */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * BoundedQueue Class
+ * This class is a multi-producer, multi-consumer FIFO with a capacity limit.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+    /**
+     * push Method
+     * @param item The item to append, blocking while the queue is full
+     * @return False if the queue was closed and the item was dropped
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * pop Method
+     * @param item Receives the next item, blocking while the queue is empty
+     * @return False once the queue is closed and drained
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * close Method
+     * Stops accepting items; consumers still drain what is queued.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    std::size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,32 @@
+/**
+ * @file const_span.h
+ * @brief Read-Only Range View
+ *
+ * This file defines the ConstSpan template, a minimal stand-in for C++20's
+ * std::span that lets flat storage hand out contiguous ranges without copying.
+ * A ConstSpan does not own its elements; it stays valid only as long as the
+ * container it points into is not modified.
+ */
+
+#ifndef CONST_SPAN_H
+#define CONST_SPAN_H
+
+#include <cstddef>
+
+/**
+ * ConstSpan struct
+ * A read-only view over a contiguous range of elements
+ */
+template <typename T>
+struct ConstSpan {
+    const T* first = nullptr;
+    const T* last = nullptr;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const T& operator[](std::size_t i) const { return first[i]; }
+};
+
+#endif // CONST_SPAN_H
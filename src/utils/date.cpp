@@ -0,0 +1,181 @@
+/**
+ * @file date.cpp
+ * @brief Compact Calendar Date Implementation
+ *
+ * This file implements the Date class defined in date.h. The conversions between
+ * day numbers and civil dates use the era-based algorithms (400-year cycles of
+ * 146097 days), which need neither tables nor loops.
+ */
+
+#include "date.h"
+#include <ctime>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * daysInMonth Function
+ * @param year The year
+ * @param month The month (1-12)
+ * @return The number of days in the month
+ */
+unsigned daysInMonth(int year, unsigned month) {
+    static const unsigned lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : lengths[month - 1];
+}
+
+/**
+ * parseDigits Function
+ * @param text The text to read from
+ * @param pos The first position to read
+ * @param count The number of digits to read
+ * @param value Receives the parsed number
+ * @return False if one of the characters is not a digit
+ */
+bool parseDigits(const std::string& text, size_t pos, size_t count, int& value) {
+    value = 0;
+    for (size_t i = pos; i < pos + count; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * fromCivil Method
+ * @param year The year
+ * @param month The month (1-12)
+ * @param day The day of the month (1-31)
+ * @return The date
+ */
+Date Date::fromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return Date(era * 146097 + static_cast<int32_t>(dayOfEra) - 719468);
+}
+
+/**
+ * toCivil Method
+ * @param year Receives the year
+ * @param month Receives the month (1-12)
+ * @param day Receives the day of the month (1-31)
+ */
+void Date::toCivil(int& year, unsigned& month, unsigned& day) const {
+    const int32_t z = days + 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(z - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+/**
+ * tryParse Method
+ * @param text A date in YYYY-MM-DD format
+ * @param date Receives the parsed date
+ * @return False if the text is not a valid date in that format
+ */
+bool Date::tryParse(const std::string& text, Date& date) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+        return false;
+    }
+    int year, month, day;
+    if (!parseDigits(text, 0, 4, year) || !parseDigits(text, 5, 2, month) || !parseDigits(text, 8, 2, day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || static_cast<unsigned>(day) > daysInMonth(year, month)) {
+        return false;
+    }
+    date = fromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return true;
+}
+
+/**
+ * fromString Method
+ * @param text A date in YYYY-MM-DD format
+ * @return The parsed date
+ * @throws invalid_argument if the text is not a valid date in that format
+ */
+Date Date::fromString(const std::string& text) {
+    Date date;
+    if (!tryParse(text, date)) {
+        throw std::invalid_argument("Date must be in format YYYY-MM-DD");
+    }
+    return date;
+}
+
+/**
+ * today Method
+ * @return The current date in the local time zone
+ */
+Date Date::today() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    return fromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+                     static_cast<unsigned>(local.tm_mday));
+}
+
+/**
+ * toString Method
+ * @return The date in YYYY-MM-DD format
+ */
+std::string Date::toString() const {
+    int year;
+    unsigned month, day;
+    toCivil(year, month, day);
+
+    std::string text = "0000-00-00";
+    for (int i = 3, y = year; i >= 0; i--, y /= 10) {
+        text[i] = static_cast<char>('0' + y % 10);
+    }
+    text[5] = static_cast<char>('0' + month / 10);
+    text[6] = static_cast<char>('0' + month % 10);
+    text[8] = static_cast<char>('0' + day / 10);
+    text[9] = static_cast<char>('0' + day % 10);
+    return text;
+}
+
+/**
+ * firstOfMonth Method
+ * @return The first day of the date's month
+ */
+Date Date::firstOfMonth() const {
+    int year;
+    unsigned month, day;
+    toCivil(year, month, day);
+    return *this - static_cast<int32_t>(day - 1);
+}
+
+/**
+ * firstOfYear Method
+ * @return January 1 of the date's year
+ */
+Date Date::firstOfYear() const {
+    int year;
+    unsigned month, day;
+    toCivil(year, month, day);
+    return fromCivil(year, 1, 1);
+}
+
+/**
+ * firstOfNextMonth Method
+ * @return The first day of the month after the date's month
+ */
+Date Date::firstOfNextMonth() const {
+    int year;
+    unsigned month, day;
+    toCivil(year, month, day);
+    return month == 12 ? fromCivil(year + 1, 1, 1) : fromCivil(year, month + 1, 1);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file date.h
+ * @brief Compact Calendar Date
+ *
+ * This file defines the Date class, a calendar date stored as the number of days
+ * since 1970-01-01. Dates compare and subtract as plain integers, so they make
+ * cheap keys for date-ordered containers; the "YYYY-MM-DD" text form is only
+ * produced or parsed at the user interface and file boundaries.
+ *
+ * Key features:
+ * - Conversion between day numbers and civil (year, month, day) dates
+ * - Strict parsing and formatting of the YYYY-MM-DD format
+ * - The local current date without going through stream formatting
+ * - Day arithmetic and month boundaries
+ */
+
+#ifndef DATE_H
+#define DATE_H
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * Date Class
+ * This class represents a day of the proleptic Gregorian calendar.
+ */
+class Date {
+public:
+    constexpr Date() : days(0) {}
+    constexpr explicit Date(int32_t daysSinceEpoch) : days(daysSinceEpoch) {}
+
+    // Construction
+    static Date fromCivil(int year, unsigned month, unsigned day);
+    static Date fromString(const string& text);
+    static bool tryParse(const string& text, Date& date);
+    static Date today();
+
+    // Conversion
+    int32_t daysSinceEpoch() const { return days; }
+    void toCivil(int& year, unsigned& month, unsigned& day) const;
+    string toString() const;
+
+    // Month boundaries
+    Date firstOfMonth() const;
+    Date firstOfNextMonth() const;
+    Date firstOfYear() const;
+
+    // Arithmetic and comparison
+    Date operator+(int32_t n) const { return Date(days + n); }
+    Date operator-(int32_t n) const { return Date(days - n); }
+    int32_t operator-(Date other) const { return days - other.days; }
+    bool operator==(Date other) const { return days == other.days; }
+    bool operator!=(Date other) const { return days != other.days; }
+    bool operator<(Date other) const { return days < other.days; }
+    bool operator<=(Date other) const { return days <= other.days; }
+    bool operator>(Date other) const { return days > other.days; }
+    bool operator>=(Date other) const { return days >= other.days; }
+
+private:
+    int32_t days;
+};
+
+#endif // DATE_H
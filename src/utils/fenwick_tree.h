@@ -0,0 +1,84 @@
+/**
+ * @file fenwick_tree.h
+ * @brief Binary Indexed Tree for Prefix Sums
+ *
+ * This file defines the FenwickTree template, which keeps running prefix sums
+ * over an array of values. Both updating one value and summing any range take
+ * O(log n), so range totals stay cheap while individual values keep changing.
+ *
+ * Key features:
+ * - O(n) construction from a list of values
+ * - Point updates by delta
+ * - Prefix and range sums
+ */
+
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * FenwickTree Class
+ * This class stores partial sums of an array in a binary indexed tree.
+ */
+template <typename T>
+class FenwickTree {
+public:
+    FenwickTree() = default;
+
+    /**
+     * assign Method
+     * @param values The values to build the tree over; the tree gets their size
+     */
+    void assign(const std::vector<T>& values) {
+        tree = values;
+        for (std::size_t i = 1; i <= tree.size(); i++) {
+            std::size_t parent = i + (i & (~i + 1));
+            if (parent <= tree.size()) {
+                tree[parent - 1] += tree[i - 1];
+            }
+        }
+    }
+
+    /**
+     * add Method
+     * @param index The position of the value to change
+     * @param delta The amount added to the value
+     */
+    void add(std::size_t index, T delta) {
+        for (std::size_t i = index + 1; i <= tree.size(); i += i & (~i + 1)) {
+            tree[i - 1] += delta;
+        }
+    }
+
+    /**
+     * prefixSum Method
+     * @param count The number of leading values to sum
+     * @return The sum of the values at positions [0, count)
+     */
+    T prefixSum(std::size_t count) const {
+        T sum = T();
+        for (std::size_t i = count < tree.size() ? count : tree.size(); i > 0; i -= i & (~i + 1)) {
+            sum += tree[i - 1];
+        }
+        return sum;
+    }
+
+    /**
+     * rangeSum Method
+     * @param first The first position of the range
+     * @param last One past the last position of the range
+     * @return The sum of the values at positions [first, last)
+     */
+    T rangeSum(std::size_t first, std::size_t last) const {
+        return last > first ? prefixSum(last) - prefixSum(first) : T();
+    }
+
+    std::size_t size() const { return tree.size(); }
+
+private:
+    std::vector<T> tree;
+};
+
+#endif // FENWICK_TREE_H
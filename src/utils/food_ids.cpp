@@ -0,0 +1,195 @@
+/**
+ * @file food_ids.cpp
+ * @brief Process-Wide Food ID Handles Implementation
+ *
+ * This file implements the FoodIds class defined in food_ids.h. A new ID's entry
+ * is written before its handle is stored into the table with release semantics,
+ * so a lookup that loads the handle also sees the entry. Growing the table
+ * builds a new one and publishes it whole; lookups still probing the old table
+ * finish on it, which is why old tables are only freed with the interner.
+ */
+
+#include "food_ids.h"
+#include <functional>
+#include <stdexcept>
+
+namespace {
+const size_t INITIAL_SLOTS = 1024;
+}
+
+/**
+ * Table Constructor
+ * @param slotCount The number of slots (a power of two)
+ */
+FoodIds::Table::Table(size_t slotCount) : mask(slotCount - 1), slots(new std::atomic<FoodHandle>[slotCount]) {
+    for (size_t i = 0; i < slotCount; i++) {
+        slots[i].store(INVALID_FOOD, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * getInstance Method
+ * @return The process-wide food ID interner
+ */
+FoodIds& FoodIds::getInstance() {
+    static FoodIds instance;
+    return instance;
+}
+
+/**
+ * FoodIds Constructor
+ * Creates an empty interner.
+ */
+FoodIds::FoodIds() : count(0), table(nullptr) {
+    rehash(INITIAL_SLOTS);
+}
+
+/**
+ * intern Method
+ * @param id A food ID
+ * @return The handle of the ID, assigning one if it was never seen
+ * @throws length_error if every handle is taken
+ */
+FoodHandle FoodIds::intern(std::string_view id) {
+    size_t hash = std::hash<std::string_view>()(id);
+    FoodHandle handle = probe(*table.load(std::memory_order_acquire), id, hash);
+    if (handle != INVALID_FOOD) {
+        return handle;
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const Table* current = table.load(std::memory_order_relaxed);
+    handle = probe(*current, id, hash);
+    if (handle != INVALID_FOOD) {
+        return handle;
+    }
+
+    size_t size = count.load(std::memory_order_relaxed);
+    if (size >= INVALID_FOOD) {
+        throw std::length_error("Too many food IDs");
+    }
+    handle = static_cast<FoodHandle>(size);
+    uint64_t position = static_cast<uint64_t>(handle) + (1u << FIRST_SEGMENT_BITS);
+    size_t segment = 63 - __builtin_clzll(position) - FIRST_SEGMENT_BITS;
+    if (!segments[segment]) {
+        segments[segment].reset(new Entry[size_t(1) << (segment + FIRST_SEGMENT_BITS)]);
+    }
+    Entry& e = segments[segment][position - (uint64_t(1) << (segment + FIRST_SEGMENT_BITS))];
+    e.id = std::string(id);
+    e.hash = hash;
+    count.store(size + 1, std::memory_order_release);
+
+    // Keep the load factor at or below one half
+    if ((size + 1) * 2 > current->mask + 1) {
+        rehash((current->mask + 1) * 2);
+    } else {
+        insert(*current, handle, hash);
+    }
+    return handle;
+}
+
+/**
+ * find Method
+ * @param id A food ID
+ * @return The handle of the ID, or INVALID_FOOD if it was never seen
+ */
+FoodHandle FoodIds::find(std::string_view id) const {
+    return probe(*table.load(std::memory_order_acquire), id, std::hash<std::string_view>()(id));
+}
+
+/**
+ * name Method
+ * @param handle A handle returned by intern
+ * @return The food ID the handle stands for
+ * @throws out_of_range if the handle was never assigned
+ */
+const std::string& FoodIds::name(FoodHandle handle) const {
+    if (handle >= count.load(std::memory_order_acquire)) {
+        throw std::out_of_range("Unknown food handle " + std::to_string(handle));
+    }
+    return entry(handle).id;
+}
+
+/**
+ * size Method
+ * @return The number of handles assigned
+ */
+size_t FoodIds::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+/**
+ * reserve Method
+ * @param expected The number of food IDs expected in total
+ * Sizes the table so that the IDs can be interned without growing it.
+ */
+void FoodIds::reserve(size_t expected) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    size_t slots = table.load(std::memory_order_relaxed)->mask + 1;
+    size_t needed = slots;
+    while (needed < expected * 2) {
+        needed *= 2;
+    }
+    if (needed != slots) {
+        rehash(needed);
+    }
+}
+
+/**
+ * entry Method
+ * @param handle An assigned handle
+ * @return The entry of the handle
+ */
+const FoodIds::Entry& FoodIds::entry(FoodHandle handle) const {
+    uint64_t position = static_cast<uint64_t>(handle) + (1u << FIRST_SEGMENT_BITS);
+    size_t segment = 63 - __builtin_clzll(position) - FIRST_SEGMENT_BITS;
+    return segments[segment][position - (uint64_t(1) << (segment + FIRST_SEGMENT_BITS))];
+}
+
+/**
+ * probe Method
+ * @param t A table
+ * @param id The ID to look up
+ * @param hash The hash of the ID
+ * @return The handle of the ID in the table, or INVALID_FOOD
+ */
+FoodHandle FoodIds::probe(const Table& t, std::string_view id, size_t hash) const {
+    for (size_t slot = hash & t.mask;; slot = (slot + 1) & t.mask) {
+        FoodHandle handle = t.slots[slot].load(std::memory_order_acquire);
+        if (handle == INVALID_FOOD) {
+            return INVALID_FOOD;
+        }
+        const Entry& e = entry(handle);
+        if (e.hash == hash && e.id == id) {
+            return handle;
+        }
+    }
+}
+
+/**
+ * insert Method
+ * @param t The table to insert into; the caller holds the write mutex
+ * @param handle An assigned handle whose entry is written
+ * @param hash The hash of the handle's ID
+ */
+void FoodIds::insert(const Table& t, FoodHandle handle, size_t hash) {
+    size_t slot = hash & t.mask;
+    while (t.slots[slot].load(std::memory_order_relaxed) != INVALID_FOOD) {
+        slot = (slot + 1) & t.mask;
+    }
+    t.slots[slot].store(handle, std::memory_order_release);
+}
+
+/**
+ * rehash Method
+ * @param slotCount The size of the new table (a power of two); the caller holds the write mutex
+ */
+void FoodIds::rehash(size_t slotCount) {
+    auto next = std::make_unique<Table>(slotCount);
+    size_t size = count.load(std::memory_order_relaxed);
+    for (size_t h = 0; h < size; h++) {
+        insert(*next, static_cast<FoodHandle>(h), entry(static_cast<FoodHandle>(h)).hash);
+    }
+    table.store(next.get(), std::memory_order_release);
+    tables.push_back(std::move(next));
+}
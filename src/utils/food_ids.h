@@ -0,0 +1,98 @@
+/**
+ * @file food_ids.h
+ * @brief Process-Wide Food ID Handles
+ *
+ * This file defines the FoodIds class, the single interner of food IDs shared by
+ * the food database and the logs of every user. A food ID gets its handle the
+ * first time it is seen anywhere and keeps it for the lifetime of the process,
+ * so handles stored in log entries and undo records index the food database's
+ * arrays directly, and reloading the database does not invalidate them.
+ *
+ * Key components:
+ * - FoodHandle, a dense uint32_t identifier for a food ID
+ * - FoodServings, a food handle with a number of servings
+ * - FoodIds, the interner of all food IDs
+ *
+ * Thread safety: lookups never lock, so resolving handles stays as cheap as
+ * indexing an array even while other threads intern new IDs. Interning takes a
+ * mutex; an ID interned concurrently with a lookup may not be found by it.
+ */
+
+#ifndef FOOD_IDS_H
+#define FOOD_IDS_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+using FoodHandle = uint32_t;
+const FoodHandle INVALID_FOOD = UINT32_MAX;
+
+// Servings of one food, as stored in a day's log
+using FoodServings = pair<FoodHandle, float>;
+
+/**
+ * FoodIds Class
+ * This class assigns the process-wide handles of food IDs.
+ */
+class FoodIds {
+public:
+    static FoodIds& getInstance();
+
+    FoodHandle intern(string_view id);
+    FoodHandle find(string_view id) const;
+    const string& name(FoodHandle handle) const;
+    size_t size() const;
+    void reserve(size_t count);
+
+private:
+    static const size_t FIRST_SEGMENT_BITS = 6;
+    static const size_t SEGMENT_COUNT = 32 - FIRST_SEGMENT_BITS + 1;
+
+    /**
+     * Entry struct
+     * An interned ID and its cached hash
+     */
+    struct Entry {
+        string id;
+        size_t hash;
+    };
+
+    /**
+     * Table struct
+     * An open-addressing table of handles (INVALID_FOOD = empty), at most half full
+     */
+    struct Table {
+        explicit Table(size_t slotCount);
+        size_t mask;
+        unique_ptr<atomic<FoodHandle>[]> slots;
+    };
+
+    FoodIds();
+    FoodIds(const FoodIds&) = delete;
+    FoodIds& operator=(const FoodIds&) = delete;
+
+    // Entries by handle in segments of doubling size; a segment never moves
+    unique_ptr<Entry[]> segments[SEGMENT_COUNT];
+    atomic<size_t> count;
+
+    // The table lookups probe; replaced tables are kept for lookups still using them
+    atomic<const Table*> table;
+    vector<unique_ptr<Table>> tables;
+    std::mutex writeMutex;
+
+    const Entry& entry(FoodHandle handle) const;
+    FoodHandle probe(const Table& t, string_view id, size_t hash) const;
+    void insert(const Table& t, FoodHandle handle, size_t hash);
+    void rehash(size_t slotCount);
+};
+
+#endif // FOOD_IDS_H
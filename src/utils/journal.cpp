@@ -0,0 +1,365 @@
+/**
+ * @file journal.cpp
+ * @brief Append-Only Write-Ahead Journal Implementation
+ *
+ * This file implements the Journal class defined in journal.h.
+ * Records are written with a single write(2) each on a descriptor opened with
+ * O_APPEND, and made durable with fdatasync once every syncInterval records or
+ * when a commit point is reached.
+ *
+ * Key implementations:
+ * - Opening, appending and batched syncing
+ * - Commit points and truncation back to them
+ * - Dropping a prefix of the records by renaming a copy of the rest over the file
+ * - Line-by-line replay that stops at the first incomplete or malformed record
+ */
+
+#include "journal.h"
+#include "atomic_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Journal Constructor
+ * @param path The path of the journal file
+ * @param syncInterval The number of appended records after which the file is synced
+ * @param compactThreshold The number of records after which needsCompaction returns true
+ * The file is not opened until open is called.
+ */
+Journal::Journal(const std::string& path, size_t syncInterval, size_t compactThreshold)
+    : path(path), syncInterval(syncInterval == 0 ? 1 : syncInterval), compactThreshold(compactThreshold),
+      fd(-1), records(0), unsynced(0), committedRecords(0), committedLength(0), generation(0) {
+}
+
+/**
+ * Journal Destructor
+ * Syncs and closes the file.
+ */
+Journal::~Journal() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Nothing sensible to do while destroying
+    }
+}
+
+/**
+ * open Method
+ * Opens (creating if needed) the journal file for appending. Call replay first
+ * so that the record count and commit point reflect the existing contents.
+ * @throws runtime_error if the file cannot be opened
+ */
+void Journal::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) {
+        return;
+    }
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open journal " + path + ": " + std::strerror(errno));
+    }
+    committedLength = ::lseek(fd, 0, SEEK_END);
+    committedRecords = records;
+    unsynced = 0;
+}
+
+/**
+ * close Method
+ * Syncs pending records and closes the file.
+ */
+void Journal::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return;
+    }
+    syncLocked();
+    ::close(fd);
+    fd = -1;
+    generation++;
+}
+
+/**
+ * replay Method
+ * @param handler The callback applying one record
+ * @return The number of records replayed
+ * Reads the journal from the beginning. An incomplete or malformed line can only
+ * come from an interrupted append, so replay stops there and the file is cut
+ * back to the last complete record. Must be called while the journal is closed.
+ */
+size_t Journal::replay(const std::function<void(const json&)>& handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) {
+        throw std::logic_error("Journal must be closed for replay");
+    }
+
+    records = 0;
+    off_t validLength = 0;
+    bool torn = false;
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return 0;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                // Last line without its newline: the append did not finish
+                torn = true;
+                break;
+            }
+            if (!line.empty()) {
+                json record = json::parse(line, nullptr, false);
+                if (record.is_discarded() || !record.is_object()) {
+                    torn = true;
+                    break;
+                }
+                handler(record);
+                records++;
+            }
+            validLength += static_cast<off_t>(line.size()) + 1;
+        }
+    }
+
+    if (torn && ::truncate(path.c_str(), validLength) != 0) {
+        throw std::runtime_error("Failed to truncate journal " + path + ": " + std::strerror(errno));
+    }
+    return records;
+}
+
+/**
+ * append Method
+ * @param record The record to append
+ * @throws runtime_error if the journal is not open or the write fails
+ */
+void Journal::append(const json& record) {
+    std::string line = record.dump();
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        throw std::runtime_error("Journal is not open: " + path);
+    }
+    writeAll(line);
+    records++;
+    if (++unsynced >= syncInterval) {
+        syncLocked();
+    }
+}
+
+/**
+ * append Method (batch version)
+ * @param batch The records to append, written with a single write call
+ * @throws runtime_error if the journal is not open or the write fails
+ */
+void Journal::append(const std::vector<json>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    std::string lines;
+    for (const auto& record : batch) {
+        lines += record.dump();
+        lines += '\n';
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        throw std::runtime_error("Journal is not open: " + path);
+    }
+    writeAll(lines);
+    records += batch.size();
+    unsynced += batch.size();
+    if (unsynced >= syncInterval) {
+        syncLocked();
+    }
+}
+
+/**
+ * sync Method
+ * Makes all appended records durable.
+ */
+void Journal::sync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    syncLocked();
+}
+
+/**
+ * commit Method
+ * Syncs the journal and marks its current end as the last commit point.
+ */
+void Journal::commit() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return;
+    }
+    syncLocked();
+    committedRecords = records;
+    committedLength = ::lseek(fd, 0, SEEK_END);
+}
+
+/**
+ * discardUncommitted Method
+ * Removes the records appended since the last commit point.
+ */
+void Journal::discardUncommitted() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return;
+    }
+    truncateLocked(committedLength);
+    records = committedRecords;
+}
+
+/**
+ * reset Method
+ * Empties the journal after its records have been written to the base files.
+ */
+void Journal::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return;
+    }
+    truncateLocked(0);
+    records = 0;
+    committedRecords = 0;
+    committedLength = 0;
+    generation++;
+}
+
+/**
+ * commitPosition Method
+ * @return The end of the journal after committing it
+ * The data saved from the state at this point lets dropBefore drop the records
+ * up to it, even if more have been appended since.
+ */
+Journal::Position Journal::commitPosition() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) {
+        syncLocked();
+        committedRecords = records;
+        committedLength = ::lseek(fd, 0, SEEK_END);
+    }
+    return {committedLength, committedRecords, generation};
+}
+
+/**
+ * dropBefore Method
+ * @param position A position returned by commitPosition
+ * @throws runtime_error if the journal cannot be rewritten
+ * Removes the records before the position, whose changes the caller has written
+ * to the base files. The records after it are copied to a new file renamed over
+ * the journal, so a crash leaves either the old or the new journal, and both
+ * replay to the same state. Nothing is dropped if the journal was emptied or
+ * closed since the position was taken.
+ */
+void Journal::dropBefore(const Position& position) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0 || position.generation != generation || position.length == 0) {
+        return;
+    }
+    off_t length = ::lseek(fd, 0, SEEK_END);
+    if (length == position.length) {
+        truncateLocked(0);
+    } else {
+        std::string tail(static_cast<size_t>(length - position.length), '\0');
+        {
+            std::ifstream file(path, std::ios::binary);
+            file.seekg(position.length);
+            if (!file.read(&tail[0], static_cast<std::streamsize>(tail.size()))) {
+                throw std::runtime_error("Failed to read journal " + path);
+            }
+        }
+        AtomicFile::write(path, [&tail](std::ostream& out) { out.write(tail.data(), static_cast<std::streamsize>(tail.size())); });
+        
+        int reopened = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (reopened < 0) {
+            throw std::runtime_error("Failed to open journal " + path + ": " + std::strerror(errno));
+        }
+        ::close(fd);
+        fd = reopened;
+        unsynced = 0;
+    }
+    records -= position.records;
+    committedRecords -= position.records;
+    committedLength -= position.length;
+}
+
+/**
+ * getPath Method
+ * @return The path of the journal file
+ */
+const std::string& Journal::getPath() const {
+    return path;
+}
+
+/**
+ * size Method
+ * @return The number of records in the journal
+ */
+size_t Journal::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+/**
+ * needsCompaction Method
+ * @return True once the journal holds enough records that the base files should be rewritten
+ */
+bool Journal::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records >= compactThreshold;
+}
+
+/**
+ * writeAll Method
+ * @param bytes The bytes to append
+ * Retries short and interrupted writes. The caller holds the lock.
+ */
+void Journal::writeAll(const std::string& bytes) {
+    const char* data = bytes.data();
+    size_t remaining = bytes.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to append to journal " + path + ": " + std::strerror(errno));
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * syncLocked Method
+ * Flushes appended records to disk if any are pending. The caller holds the lock.
+ */
+void Journal::syncLocked() {
+    if (fd < 0 || unsynced == 0) {
+        return;
+    }
+    if (::fdatasync(fd) != 0) {
+        throw std::runtime_error("Failed to sync journal " + path + ": " + std::strerror(errno));
+    }
+    unsynced = 0;
+}
+
+/**
+ * truncateLocked Method
+ * @param length The new length of the journal file
+ * The caller holds the lock.
+ */
+void Journal::truncateLocked(off_t length) {
+    if (::ftruncate(fd, length) != 0) {
+        throw std::runtime_error("Failed to truncate journal " + path + ": " + std::strerror(errno));
+    }
+    if (::fdatasync(fd) != 0) {
+        throw std::runtime_error("Failed to sync journal " + path + ": " + std::strerror(errno));
+    }
+    unsynced = 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file journal.h
+ * @brief Append-Only Write-Ahead Journal
+ *
+ * This file defines the Journal class which records every modification of the logs
+ * and the food database as one JSON object per line in an append-only file. Saving
+ * then only has to make the journal durable instead of rewriting the full JSON
+ * files; those are rewritten (compacted) only once the journal has grown large.
+ *
+ * Key features:
+ * - O(1) appends of small JSON-lines records through an O_APPEND descriptor
+ * - fsync batching: the file is synced every few records and on commit
+ * - Commit points, so that changes made after the last save can be discarded
+ * - Replay of the journal at startup, tolerating a torn last line
+ * - Compaction threshold after which the base files should be rewritten
+ * - Compaction in the background: dropping only the records up to a commit point
+ *   once the base files hold them, while new records keep being appended
+ *
+ * Records describe resulting state (for example the servings of a food on a date
+ * after a change) rather than deltas, so replaying a record that the base files
+ * already contain leaves the data unchanged.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+#include <nlohmann/json.hpp>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Journal Class
+ * This class appends mutation records to a journal file and replays them.
+ */
+class Journal {
+public:
+    /**
+     * Position struct
+     * The end of the journal at a commit point
+     */
+    struct Position {
+        off_t length;
+        size_t records;
+        uint64_t generation;   // Changes when the file is emptied or closed
+    };
+
+    static const size_t DEFAULT_SYNC_INTERVAL = 16;
+    static const size_t DEFAULT_COMPACT_THRESHOLD = 512;
+
+    explicit Journal(const string& path,
+                     size_t syncInterval = DEFAULT_SYNC_INTERVAL,
+                     size_t compactThreshold = DEFAULT_COMPACT_THRESHOLD);
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Opening and replay
+    void open();
+    void close();
+    size_t replay(const function<void(const json&)>& handler);
+
+    // Appending
+    void append(const json& record);
+    void append(const vector<json>& batch);
+    void sync();
+
+    // Commit points
+    void commit();
+    void discardUncommitted();
+    void reset();
+    
+    // Compaction: the records before a commit position are dropped once written elsewhere
+    Position commitPosition();
+    void dropBefore(const Position& position);
+
+    // Status
+    const string& getPath() const;
+    size_t size() const;
+    bool needsCompaction() const;
+
+private:
+    string path;
+    size_t syncInterval;
+    size_t compactThreshold;
+    int fd;
+
+    // Records in the file, records not yet synced, and the file length at the last commit
+    size_t records;
+    size_t unsynced;
+    size_t committedRecords;
+    off_t committedLength;
+    uint64_t generation;
+
+    mutable std::mutex mutex;
+
+    void writeAll(const string& bytes);
+    void syncLocked();
+    void truncateLocked(off_t length);
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,122 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Lock-Free Latency Histogram Implementation
+ *
+ * This file implements the LatencyHistogram class defined in latency_histogram.h.
+ * Values below four have a bucket each. Larger values are bucketed by the
+ * position of their highest set bit and the two bits below it.
+ *
+ * Key implementations:
+ * - Bucket index computation from the leading bits of a value
+ * - Relaxed atomic counters, with a compare-and-swap loop for the maximum
+ * - Percentile lookup by a cumulative scan of the buckets
+ */
+
+#include "latency_histogram.h"
+#include <cmath>
+
+/**
+ * LatencyHistogram Constructor
+ */
+LatencyHistogram::LatencyHistogram() : total(0), sum(0), maximum(0) {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * record Method
+ * @param nanoseconds A measured duration
+ */
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    uint64_t current = maximum.load(std::memory_order_relaxed);
+    while (nanoseconds > current &&
+           !maximum.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * count Method
+ * @return The number of recorded durations
+ */
+uint64_t LatencyHistogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+/**
+ * mean Method
+ * @return The mean of the recorded durations in nanoseconds, 0 if there are none
+ */
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(n);
+}
+
+/**
+ * max Method
+ * @return The longest recorded duration in nanoseconds
+ */
+uint64_t LatencyHistogram::max() const {
+    return maximum.load(std::memory_order_relaxed);
+}
+
+/**
+ * percentile Method
+ * @param fraction The percentile as a fraction, such as 0.99
+ * @return An upper bound of the duration below which the fraction of recorded
+ *         durations falls, in nanoseconds (0 if nothing was recorded)
+ */
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(n)));
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            uint64_t bound = upperBound(i);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+/**
+ * bucketFor Method
+ * @param value A duration
+ * @return The index of the bucket counting the duration
+ */
+size_t LatencyHistogram::bucketFor(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    size_t mantissa = static_cast<size_t>((value >> (exponent - 2)) & (SUB_BUCKETS - 1));
+    return (exponent - 1) * SUB_BUCKETS + mantissa;
+}
+
+/**
+ * upperBound Method
+ * @param bucket A bucket index
+ * @return The largest duration counted by the bucket
+ */
+uint64_t LatencyHistogram::upperBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    unsigned exponent = static_cast<unsigned>(bucket / SUB_BUCKETS) + 1;
+    uint64_t mantissa = bucket % SUB_BUCKETS;
+    uint64_t next = (SUB_BUCKETS + mantissa + 1) << (exponent - 2);
+    // The last bucket ends at the largest 64-bit value
+    return next == 0 ? UINT64_MAX : next - 1;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file latency_histogram.h
+ * @brief Lock-Free Latency Histogram
+ *
+ * This file defines the LatencyHistogram class which counts durations in
+ * logarithmic buckets: four buckets per power of two, so every bucket spans at
+ * most a quarter of its lower bound and percentiles are accurate to within 25%
+ * over the full range of 64-bit nanosecond values. Recording is a few atomic
+ * increments, so any number of threads can record into one histogram.
+ *
+ * Key features:
+ * - Wait-free recording from concurrent threads
+ * - Count, mean and maximum
+ * - Percentiles reported as the upper bound of the bucket containing them
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * LatencyHistogram Class
+ * This class records durations in nanoseconds and reports their distribution.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+
+    uint64_t count() const;
+    double mean() const;
+    uint64_t max() const;
+    uint64_t percentile(double fraction) const;
+
+private:
+    static const size_t SUB_BUCKETS = 4;
+    static const size_t BUCKET_COUNT = 64 * SUB_BUCKETS;
+
+    array<atomic<uint64_t>, BUCKET_COUNT> buckets;
+    atomic<uint64_t> total;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> maximum;
+
+    static size_t bucketFor(uint64_t value);
+    static uint64_t upperBound(size_t bucket);
+};
+
+#endif // LATENCY_HISTOGRAM_H
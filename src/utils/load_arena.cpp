@@ -0,0 +1,118 @@
+/**
+ * @file load_arena.cpp
+ * @brief Arena Memory for Bulk-Loaded Data Implementation
+ *
+ * This file implements the LoadArena class defined in load_arena.h. The arena is
+ * a monotonic buffer resource starting in the retained block; whatever does not
+ * fit there comes from further blocks of growing size, which release() returns
+ * to the heap. When a load needed more than the retained block, release()
+ * replaces it with one large enough for all of it.
+ *
+ * Key implementations:
+ * - Forwarding of allocations to the arena or to the heap, by mode
+ * - Accounting of the bytes used since the last release
+ * - Resizing of the retained block on release
+ */
+
+#include "load_arena.h"
+
+namespace {
+
+// Granularity of the retained block
+const size_t RETAINED_ROUNDING = 4096;
+
+} // namespace
+
+/**
+ * LoadArena Constructor
+ * @param firstBlock The size of the first block taken from the heap
+ */
+LoadArena::LoadArena(size_t firstBlock)
+    : firstBlock(firstBlock), enabled(true), nextEnabled(true), usedBytes(0), retainedSize(0) {
+    arena.emplace(firstBlock, std::pmr::new_delete_resource());
+}
+
+/**
+ * setEnabled Method
+ * @param enabled True to allocate from the arena, false to use the heap
+ * Memory handed out so far has to be freed the way it was allocated, so the
+ * new mode applies from the next release on.
+ */
+void LoadArena::setEnabled(bool enabled) {
+    nextEnabled = enabled;
+}
+
+/**
+ * isEnabled Method
+ * @return Whether allocations currently come from the arena
+ */
+bool LoadArena::isEnabled() const {
+    return enabled;
+}
+
+/**
+ * release Method
+ * Returns every block but the retained one to the heap, sizing the retained
+ * block for as much as was used since the last release.
+ */
+void LoadArena::release() {
+    enabled = nextEnabled;
+    if (!enabled) {
+        retained.reset();
+        retainedSize = 0;
+        arena.emplace(firstBlock, std::pmr::new_delete_resource());
+    } else if (usedBytes > retainedSize) {
+        size_t size = (usedBytes + RETAINED_ROUNDING - 1) / RETAINED_ROUNDING * RETAINED_ROUNDING;
+        arena.reset();
+        retained.reset(new std::byte[size]);
+        retainedSize = size;
+        arena.emplace(retained.get(), retainedSize, std::pmr::new_delete_resource());
+    } else {
+        arena->release();
+    }
+    usedBytes = 0;
+}
+
+/**
+ * getUsedBytes Method
+ * @return The bytes requested from the arena since the last release
+ */
+size_t LoadArena::getUsedBytes() const {
+    return usedBytes;
+}
+
+/**
+ * do_allocate Method
+ * @param bytes The size of the allocation
+ * @param alignment Its alignment
+ * @return The allocated memory
+ */
+void* LoadArena::do_allocate(size_t bytes, size_t alignment) {
+    if (!enabled) {
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    usedBytes += bytes + alignment - 1;
+    return arena->allocate(bytes, alignment);
+}
+
+/**
+ * do_deallocate Method
+ * @param pointer Memory returned by do_allocate
+ * @param bytes The size of the allocation
+ * @param alignment Its alignment
+ * Arena memory is only reclaimed by release().
+ */
+void LoadArena::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    if (!enabled) {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+}
+
+/**
+ * do_is_equal Method
+ * @param other Another memory resource
+ * @return Whether memory from one can be freed by the other, which only holds for the same arena
+ */
+bool LoadArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
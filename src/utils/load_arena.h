@@ -0,0 +1,83 @@
+/**
+ * @file load_arena.h
+ * @brief Arena Memory for Bulk-Loaded Data
+ *
+ * This file defines the LoadArena class, a memory resource for containers that
+ * are filled in bulk when data is loaded and emptied all at once when it is
+ * reloaded, like the food search index or the log history. Instead of one heap
+ * allocation per posting list or day, their memory is carved out of a few large
+ * blocks, and a reload gives all of it up in one step.
+ *
+ * Key features:
+ * - Bump allocation from large blocks (std::pmr::monotonic_buffer_resource);
+ *   freeing is a no-op, everything is reclaimed by release()
+ * - One block as large as everything allocated since the last release is kept
+ *   for the next load, so reloading data of the same size allocates nothing
+ * - A heap mode forwarding to new and delete, for comparison and for data that
+ *   is freed piecemeal; the mode only changes on release()
+ *
+ * Containers using the arena must all be emptied, including their bucket
+ * arrays and spare capacity (see LoadArena::reset), before release() is called.
+ * Not thread-safe: the owner serializes allocations and releases.
+ */
+
+#ifndef LOAD_ARENA_H
+#define LOAD_ARENA_H
+
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * LoadArena Class
+ * This class hands out memory from large blocks that are released together.
+ */
+class LoadArena : public pmr::memory_resource {
+public:
+    static const size_t DEFAULT_FIRST_BLOCK = 64 * 1024;
+
+    explicit LoadArena(size_t firstBlock = DEFAULT_FIRST_BLOCK);
+    LoadArena(const LoadArena&) = delete;
+    LoadArena& operator=(const LoadArena&) = delete;
+
+    // Arena or heap mode; a change takes effect at the next release()
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Reclaims everything allocated; nothing allocated from the arena may still be in use
+    void release();
+
+    // Bytes requested since the last release
+    size_t getUsedBytes() const;
+
+    /**
+     * reset Method
+     * @param container A container allocating from the arena
+     * Empties the container and frees all of its memory, which clear() alone
+     * does not do for vector capacity or hash table buckets.
+     */
+    template <typename Container>
+    static void reset(Container& container) {
+        Container(container.get_allocator()).swap(container);
+    }
+
+private:
+    size_t firstBlock;
+    bool enabled;
+    bool nextEnabled;
+    size_t usedBytes;
+
+    // Block kept across releases, and the arena starting in it
+    unique_ptr<byte[]> retained;
+    size_t retainedSize;
+    optional<pmr::monotonic_buffer_resource> arena;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+};
+
+#endif // LOAD_ARENA_H
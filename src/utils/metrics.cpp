@@ -0,0 +1,138 @@
+/**
+ * @file metrics.cpp
+ * @brief Built-In Latency and Allocation Instrumentation Implementation
+ *
+ * This file implements the Metrics registry defined in metrics.h. Operations are
+ * stored in an ordered map of stable objects, so the registry lock is only taken
+ * to look an operation up, which METRICS_TIMER does once per call site.
+ *
+ * Key implementations:
+ * - Registration of named operations
+ * - JSON and Prometheus text reports
+ */
+
+#include "metrics.h"
+#include <iomanip>
+#include <sstream>
+
+Metrics::AllocationCounter Metrics::allocationCounter = nullptr;
+
+/**
+ * getInstance Method
+ * @return The process-wide registry
+ * The registry is never destroyed: singletons destroyed at exit, such as the
+ * food database saving its changes, still time their operations.
+ */
+Metrics& Metrics::getInstance() {
+    static Metrics* instance = new Metrics();
+    return *instance;
+}
+
+/**
+ * get Method
+ * @param name The name of an operation
+ * @return The operation's measurements
+ */
+OperationMetrics& Metrics::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<OperationMetrics>& operation = operations[name];
+    if (!operation) {
+        operation = std::make_unique<OperationMetrics>();
+    }
+    return *operation;
+}
+
+/**
+ * getOperations Method
+ * @return The operations called at least once, by name
+ */
+std::map<std::string, const OperationMetrics*> Metrics::getOperations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, const OperationMetrics*> called;
+    for (const auto& [name, operation] : operations) {
+        if (operation->latency.count() > 0) {
+            called.emplace(name, operation.get());
+        }
+    }
+    return called;
+}
+
+/**
+ * toJson Method
+ * @return Count, mean, percentiles and maximum in microseconds of every operation
+ *         called at least once, plus its allocations if they are counted
+ */
+json Metrics::toJson() const {
+    json report = json::object();
+    for (const auto& [name, operation] : getOperations()) {
+        const LatencyHistogram& latency = operation->latency;
+        json entry = {{"count", latency.count()},
+                      {"mean_us", latency.mean() / 1000.0},
+                      {"p50_us", latency.percentile(0.50) / 1000.0},
+                      {"p99_us", latency.percentile(0.99) / 1000.0},
+                      {"max_us", latency.max() / 1000.0}};
+        if (countsAllocations()) {
+            entry["allocations"] = operation->allocations.load(std::memory_order_relaxed);
+        }
+        report[name] = entry;
+    }
+    return report;
+}
+
+/**
+ * toPrometheus Method
+ * @return The measurements in the Prometheus text exposition format: a summary
+ *         of wall times in seconds and a counter of allocations per operation
+ */
+std::string Metrics::toPrometheus() const {
+    std::map<std::string, const OperationMetrics*> called = getOperations();
+    std::ostringstream out;
+    out << std::setprecision(9);
+    
+    out << "# HELP diet_manager_operation_seconds Wall time of commands and core operations\n"
+        << "# TYPE diet_manager_operation_seconds summary\n";
+    for (const auto& [name, operation] : called) {
+        const LatencyHistogram& latency = operation->latency;
+        std::string label = "operation=\"" + name + "\"";
+        for (double quantile : {0.5, 0.99}) {
+            out << "diet_manager_operation_seconds{" << label << ",quantile=\"" << quantile << "\"} "
+                << latency.percentile(quantile) / 1e9 << '\n';
+        }
+        out << "diet_manager_operation_seconds_sum{" << label << "} " << latency.mean() * latency.count() / 1e9 << '\n'
+            << "diet_manager_operation_seconds_count{" << label << "} " << latency.count() << '\n';
+    }
+    
+    if (countsAllocations()) {
+        out << "# HELP diet_manager_operation_allocations_total Heap allocations made by commands and core operations\n"
+            << "# TYPE diet_manager_operation_allocations_total counter\n";
+        for (const auto& [name, operation] : called) {
+            out << "diet_manager_operation_allocations_total{operation=\"" << name << "\"} "
+                << operation->allocations.load(std::memory_order_relaxed) << '\n';
+        }
+    }
+    return out.str();
+}
+
+/**
+ * setAllocationCounter Method
+ * @param counter The function returning the calling thread's allocation count
+ */
+void Metrics::setAllocationCounter(AllocationCounter counter) {
+    allocationCounter = counter;
+}
+
+/**
+ * countsAllocations Method
+ * @return Whether a counting allocator is linked in
+ */
+bool Metrics::countsAllocations() {
+    return allocationCounter != nullptr;
+}
+
+/**
+ * currentAllocations Method
+ * @return The allocations made so far by the calling thread, or 0 if they are not counted
+ */
+size_t Metrics::currentAllocations() {
+    return allocationCounter ? allocationCounter() : 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file metrics.h
+ * @brief Built-In Latency and Allocation Instrumentation
+ *
+ * This file defines the Metrics registry which keeps, for every instrumented
+ * operation (each CLI command and core operations such as loading, saving and
+ * searching), a histogram of its wall times, its call count and optionally the
+ * heap allocations it made. The data is reported by the "stats" command as a
+ * table, as JSON or in the Prometheus text format, so regressions can be spotted
+ * in production without a profiler.
+ *
+ * Key features:
+ * - Named operations registered on first use; recording takes no lock
+ * - Scoped timers through METRICS_TIMER / METRICS_TIMER_FOR, which compile to
+ *   nothing when the build sets DIET_MANAGER_METRICS to 0
+ * - Allocation counts when a counting allocator is linked in (see
+ *   allocation_hooks.cpp and the DIET_MANAGER_COUNT_ALLOCATIONS build option)
+ *
+ * Allocations are counted per thread, so work an operation hands to other
+ * threads is not attributed to it.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "latency_histogram.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+#ifndef DIET_MANAGER_METRICS
+#define DIET_MANAGER_METRICS 1
+#endif
+
+/**
+ * OperationMetrics struct
+ * The measurements of one instrumented operation
+ */
+struct OperationMetrics {
+    LatencyHistogram latency;
+    atomic<uint64_t> allocations{0};
+};
+
+/**
+ * Metrics Class
+ * This class is the process-wide registry of operation measurements.
+ */
+class Metrics {
+public:
+    // Heap allocations made so far by the calling thread
+    using AllocationCounter = size_t (*)();
+
+    static Metrics& getInstance();
+
+    // The measurements of an operation, created on first use; references stay valid
+    OperationMetrics& get(const string& name);
+
+    // Reports of the operations called at least once
+    json toJson() const;
+    string toPrometheus() const;
+    map<string, const OperationMetrics*> getOperations() const;
+
+    // Installed by a counting allocator before main runs
+    static void setAllocationCounter(AllocationCounter counter);
+    static bool countsAllocations();
+    static size_t currentAllocations();
+
+private:
+    Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    mutable std::mutex mutex;
+    map<string, unique_ptr<OperationMetrics>> operations;
+
+    static AllocationCounter allocationCounter;
+};
+
+/**
+ * ScopedTimer Class
+ * This class records the time and allocations between its construction and
+ * destruction into an operation's measurements.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(OperationMetrics& operation)
+        : operation(operation), allocationStart(Metrics::currentAllocations()), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        operation.latency.record(static_cast<uint64_t>(elapsed.count()));
+        operation.allocations.fetch_add(Metrics::currentAllocations() - allocationStart, memory_order_relaxed);
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    OperationMetrics& operation;
+    size_t allocationStart;
+    chrono::steady_clock::time_point start;
+};
+
+#define METRICS_CONCAT_INNER(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_INNER(a, b)
+
+#if DIET_MANAGER_METRICS
+// Times the rest of the enclosing scope as the operation with a fixed name
+#define METRICS_TIMER(name)                                                                     \
+    static OperationMetrics& METRICS_CONCAT(metricsOperation, __LINE__) = Metrics::getInstance().get(name); \
+    ScopedTimer METRICS_CONCAT(metricsTimer, __LINE__)(METRICS_CONCAT(metricsOperation, __LINE__))
+// Times the rest of the enclosing scope as the given OperationMetrics
+#define METRICS_TIMER_FOR(operation) ScopedTimer METRICS_CONCAT(metricsTimer, __LINE__)(operation)
+#else
+#define METRICS_TIMER(name)
+#define METRICS_TIMER_FOR(operation)
+#endif
+
+#endif // METRICS_H
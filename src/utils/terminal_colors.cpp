@@ -10,6 +10,7 @@
  * - Definition of color and style constants using ANSI escape sequences
  * - Implementation of text formatting utility functions
  * - Message type formatting (error, success, warning, info)
+ * - A global switch that turns all formatting off for non-interactive output
  * 
  * The implementation uses standard ANSI escape codes which are supported by
  * most modern terminal emulators, providing a consistent experience across
@@ -35,31 +36,43 @@ namespace TerminalColors {
     const string BOLD = "\033[1m";
     const string UNDERLINE = "\033[4m";
 
+    namespace {
+        bool enabled = true;
+    }
+
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    bool isEnabled() {
+        return enabled;
+    }
+
     string colorize(const string& text, const string& color) {
-        return color + text + RESET;
+        return enabled ? color + text + RESET : text;
     }
 
     string bold(const string& text) {
-        return BOLD + text + RESET;
+        return colorize(text, BOLD);
     }
 
     string underline(const string& text) {
-        return UNDERLINE + text + RESET;
+        return colorize(text, UNDERLINE);
     }
 
     string error(const string& text) {
-        return BOLD + RED + text + RESET;
+        return colorize(text, BOLD + RED);
     }
 
     string success(const string& text) {
-        return GREEN + text + RESET;
+        return colorize(text, GREEN);
     }
 
     string warning(const string& text) {
-        return YELLOW + text + RESET;
+        return colorize(text, YELLOW);
     }
 
     string info(const string& text) {
-        return CYAN + text + RESET;
+        return colorize(text, CYAN);
     }
 }
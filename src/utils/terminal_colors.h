@@ -11,6 +11,7 @@
  * - Text style constants (bold, underline)
  * - Utility functions for applying colors and styles to text
  * - Specialized formatting for different message types (error, success, warning, info)
+ * - Switch to disable all formatting, e.g. when output is read by scripts
  * 
  * These utilities enhance the user experience by providing visual cues and
  * improving the readability of the command-line interface.
@@ -38,6 +39,10 @@ namespace TerminalColors {
     extern const string BOLD;
     extern const string UNDERLINE;
 
+    // Formatting is on by default; when off, all functions return the text unchanged
+    void setEnabled(bool enable);
+    bool isEnabled();
+
     // Utility functions
     string colorize(const string& text, const string& color);
     string bold(const string& text);
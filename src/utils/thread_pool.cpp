@@ -0,0 +1,93 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Fixed-Size Worker Thread Pool Implementation
+ *
+ * This file implements the ThreadPool class defined in thread_pool.h.
+ * Workers wait on a condition variable for queued tasks; tasks are wrapped in
+ * packaged_task so their results and exceptions reach the submitter's future.
+ */
+
+#include "thread_pool.h"
+#include <utility>
+
+/**
+ * ThreadPool Constructor
+ * @param threadCount The number of worker threads to start (at least one)
+ */
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * ThreadPool Destructor
+ * Runs the tasks still queued and joins every worker.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * submit Method
+ * @param task The task to run on a worker thread
+ * @return A future that becomes ready when the task has finished
+ */
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> result = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(packaged));
+    }
+    available.notify_one();
+    return result;
+}
+
+/**
+ * size Method
+ * @return The number of worker threads
+ */
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+/**
+ * defaultThreadCount Method
+ * @return The number of hardware threads, or 2 if it cannot be determined
+ */
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count == 0 ? 2 : count;
+}
+
+/**
+ * workerLoop Method
+ * Executes queued tasks until the pool is stopping and the queue is empty.
+ */
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
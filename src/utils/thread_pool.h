@@ -0,0 +1,55 @@
+/**
+ * @file thread_pool.h
+ * @brief Fixed-Size Worker Thread Pool
+ *
+ * This file defines the ThreadPool class, a set of worker threads that execute
+ * submitted tasks in FIFO order. Tasks return a future so callers can wait for
+ * completion and receive exceptions thrown by the task.
+ *
+ * Key features:
+ * - Fixed number of workers started on construction
+ * - Task submission returning std::future<void>
+ * - Joining all workers on destruction after the queue is drained
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * ThreadPool Class
+ * This class runs tasks on a fixed set of worker threads.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    future<void> submit(function<void()> task);
+    size_t size() const;
+
+    static size_t defaultThreadCount();
+
+private:
+    vector<thread> workers;
+    queue<packaged_task<void()>> tasks;
+    mutex queueMutex;
+    condition_variable available;
+    bool stopping = false;
+
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H